@@ -20,6 +20,8 @@ using namespace std;
 /* Data structures */
 #include "structs/MUXbmap_t.h"
 #include "structs/MUXmultibmap_t.h"
+#include "structs/MUXmultivector_t.h"
+#include "structs/MUXmutextable_t.h"
 
 #endif // _CSPMUX_H_
 
@@ -52,8 +52,8 @@ class action_t {
         action_t (action_t&&) = default;
 
         // default copy and move assignments
-        action_t& operator=(const action_t&);
-        action_t& operator=(const action_t&&);
+        action_t& operator=(const action_t&) = default;
+        action_t& operator=(action_t&&) = default;
 
         // accessors
 
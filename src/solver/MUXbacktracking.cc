@@ -0,0 +1,19 @@
+// -*- coding: utf-8 -*-
+// MUXbacktracking.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 17-08-2021 09:42:05.118307463 (1629186125)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Backtracking search over the CSP task defined in a manager. Note that the
+// search is a template because it can act on values defined over any type T
+
+#include "MUXbacktracking.h"
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
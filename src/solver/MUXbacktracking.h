@@ -0,0 +1,1093 @@
+// -*- coding: utf-8 -*-
+// MUXbacktracking.h
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 17-08-2021 09:41:27.351046207 (1629186087)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Backtracking search over the CSP task defined in a manager. All changes
+// performed during search are recorded in a trail, with one frame per
+// assignment, so that they can be undone when backtracking
+
+#ifndef _MUXBACKTRACKING_H_
+#define _MUXBACKTRACKING_H_
+
+#include<algorithm>
+#include<atomic>
+#include<chrono>
+#include<cmath>
+#include<limits>
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+#include "MUXmanager.h"
+#include "MUXnogoodstore_t.h"
+#include "MUXtrail_t.h"
+#include "MUXvalorder.h"
+#include "MUXvarorder.h"
+
+using namespace std;
+
+// the following type describes the outcome of a search algorithm: either it
+// has not been started yet, it found a solution, it proved there is none, or it
+// was interrupted after exhausting its budget of nodes or time, or by another
+// thread
+enum class status_t { UNKNOWN, SATISFIABLE, UNSATISFIABLE, NODE_LIMIT, TIME_LIMIT, INTERRUPTED };
+
+// the following type describes the propagation performed after every
+// assignment. Plain backtracking only disables the values which are mutex with
+// the assigned one, so that dead-ends are detected when their variable is
+// selected. Forward checking also maintains the number of enabled mutexes of
+// every value and rejects an assignment as soon as it empties the domain of any
+// variable. Maintaining arc consistency additionally disables all values which
+// have no support in the domain of some unassigned variable
+enum class propagation_t { BACKTRACKING, FORWARD_CHECKING, MAINTAINING_ARC_CONSISTENCY };
+
+// the following type describes the restart policy of a search, i.e., the
+// number of failures allowed before restarting it: none, always the same
+// cutoff, the cutoff multiplied by the Luby sequence (1, 1, 2, 1, 1, 2, 4, ...)
+// or the cutoff multiplied by a constant factor after every restart
+enum class restart_t { NONE, FIXED, LUBY, GEOMETRIC };
+
+// Class definition
+//
+// Chronological backtracking over the CSP task defined in a manager. The search
+// is performed iteratively with an explicit record of the variable and the next
+// value to try at every depth. Assigning a value to a variable disables all
+// values which are mutex with it and decrements the number of feasible values
+// of their variables. Optionally, forward checking rejects assignments which
+// empty the domain of any variable, and maintaining arc consistency propagates
+// the removal of values with residual supports (AC-3rm). Optionally, dead-ends
+// jump back directly to the deepest assignment responsible for them
+// (conflict-directed backjumping), and the assignments responsible for every
+// dead-end are learnt as nogoods, which are propagated with two watched
+// literals. Finally, searches can be restarted after a number of failures,
+// recording the values refuted in the last branch as nogoods so that restarts
+// remain complete. Note that the search is
+// a template because it can act on values defined over any type T. Variables
+// and values are selected with the given ordering strategies (see
+// MUXvarorder.h and MUXvalorder.h), which are lexicographic by default
+template<class T, class VarOrder = varorder_lex_t, class ValOrder = valorder_lex_t>
+class backtracking {
+
+        // the trail undoes changes through this search so that the variable
+        // ordering is notified of them
+        friend class trail_t;
+
+    private:
+
+        struct _level_t {
+
+            // INVARIANT: every level of the search tree stores the variable
+            // assigned at it. The values already tried are recorded
+            // separately
+            size_t _var;
+        };
+
+        // INVARIANT: a backtracking search acts over the CSP task defined in a
+        // manager, which is modified during the search and restored right
+        // after it
+        manager<T>& _manager;
+
+        // propagation performed after every assignment and whether
+        // conflict-directed backjumping and nogood learning are used or not
+        propagation_t _propagation;
+        bool _backjumping;
+        bool _learning;
+
+        // restart policy: the cutoff of the first run in number of failures,
+        // the factor of geometric restarts, and the number of failures of
+        // the current run
+        restart_t _restart;
+        size_t _restart_base;
+        double _restart_factor;
+        size_t _runfailures;
+
+        // budgets of the search: the maximum number of nodes to expand and the
+        // maximum time allowed (in seconds)
+        size_t _node_limit;
+        double _time_limit;
+
+        // searches can be interrupted from other threads with a flag which
+        // is checked at every node, if any
+        const atomic<bool>* _stop;
+
+        // outcome of the last search: its status, the index of the value
+        // assigned to every variable in case a solution was found, and some
+        // statistics
+        status_t _status;
+        vector<size_t> _solution;
+        size_t _nbnodes;
+        size_t _nbbacktracks;
+        size_t _nbfailures;
+        size_t _nbrestarts;
+        double _elapsed;
+
+        // the levels of the search tree currently being traversed, from the
+        // root to the current node, and the values already tried at them.
+        // Because every variable is assigned at most at one level, the latter
+        // is a single bitmap indexed by values
+        vector<_level_t> _levels;
+        bmap_t _tried;
+
+        // Conflict-directed backjumping records the level whose assignment
+        // disabled every value (or string::npos if it was disabled before
+        // search), and the conflict set of every level, i.e., the levels
+        // responsible for the failure of the values already tried at it.
+        // Killers are not restored when backtracking because they are only
+        // meaningful while their values are disabled
+        vector<size_t> _killer;
+        vector<vector<size_t>> _conflicts;
+
+        // Nogood learning stores all nogoods in a store with a maximum number
+        // of them. Values disabled by a nogood record its index as their
+        // reason (or string::npos if they were disabled by a mutex), and
+        // every assigned variable records the level it was assigned at, so
+        // that the levels responsible for a nogood can be computed
+        nogoodstore_t _nogoods;
+        size_t _max_nogoods;
+        vector<size_t> _reason;
+        vector<size_t> _depth;
+
+        // all changes performed during the search are recorded in a trail
+        trail_t _trail;
+
+        // strategies used for selecting the next variable to assign and the
+        // next value to try
+        VarOrder _varorder;
+        ValOrder _valorder;
+
+        // Maintaining arc consistency propagates the removal of values from
+        // the domain of the variables stored in a queue. Also, the last
+        // support found for every value in every block it participates in is
+        // remembered as a residue. Residues of the values of the first
+        // variable of the b-th block start at _resfirst[b], and those of the
+        // second variable follow them. Note that residues are not restored
+        // when backtracking
+        vector<size_t> _queue;
+        vector<bool> _inqueue;
+        vector<size_t> _residues;
+        vector<size_t> _resfirst;
+
+        // return the next variable to assign, or string::npos if all of them
+        // have been already assigned
+        size_t _select () {
+            return _varorder.select ();
+        }
+
+        // undo a change recorded in the trail and notify the variable and
+        // value orderings of the changes in the variables and values. Note
+        // that assignments are always undone to string::npos
+        void undo (const opcode_t opcode, const size_t i, const size_t prev) {
+            _manager.undo (opcode, i, prev);
+            if (opcode == opcode_t::VAR_NBVALUES) {
+                _varorder.update (i);
+            } else if (opcode == opcode_t::VAR_VALUE) {
+                _varorder.insert (i);
+                _valorder.unassign (i, _manager.get_valtable ().get_statuses ());
+            } else if (opcode == opcode_t::VAL_STATUS) {
+                _valorder.enable (i, _manager.get_valtable ().get_statuses ());
+            }
+        }
+
+        // return the index of the next value to try at the given level, i.e.,
+        // the enabled value in the domain of its variable not tried yet which
+        // goes first according to the value ordering, and mark it as tried.
+        // If there is none, string::npos is returned
+        size_t _next_value (const _level_t& level) {
+            size_t value = _valorder.select (level._var, _manager.get_vartable (),
+                                             _manager.get_valtable (), _tried);
+            if (value != string::npos) {
+                _tried.set (value, true);
+            }
+            return value;
+        }
+
+        // disable the j-th value and decrement the number of feasible values
+        // of its variable. With forward checking, the number of enabled
+        // mutexes of all values which are mutex with it is decremented as
+        // well. All changes are recorded in the trail. It returns false if the
+        // domain of its variable becomes empty and true otherwise
+        bool _disable (const size_t j) {
+
+            // disable the value and record the level responsible for it
+            _trail.push (opcode_t::VAL_STATUS, j, true);
+            _manager.set_val_status (j, false, true);
+            _valorder.disable (j, _manager.get_valtable ().get_statuses ());
+            _killer[j] = _levels.empty () ? string::npos : _levels.size () - 1;
+            _reason[j] = string::npos;
+
+            // decrement the number of enabled mutexes of all values which are
+            // still enabled and mutex with this one
+            const valtable_t<T>& valtable = _manager.get_valtable ();
+            if (_propagation != propagation_t::BACKTRACKING) {
+                _manager.get_mutextable ()->for_each (j, valtable.get_statuses (),
+                                                      [&] (size_t k) {
+                                                          size_t nbmutexes = valtable.get_nbmutexes (k);
+                                                          _trail.push (opcode_t::VAL_NBMUTEXES, k, nbmutexes);
+                                                          _manager.set_val_nbmutexes (k, nbmutexes-1, nbmutexes);
+                                                      });
+            }
+
+            // and decrement the number of feasible values of its variable
+            size_t var = _manager.get_mutextable ()->get_var (j);
+            size_t nbvalues = _manager.get_vartable ().get_nbvalues (var);
+            _trail.push (opcode_t::VAR_NBVALUES, var, nbvalues);
+            _manager.set_var_nbvalues (var, nbvalues-1, nbvalues);
+            _varorder.update (var);
+
+            // when maintaining arc consistency, the supports of the values of
+            // its neighbours have to be revised
+            if (_propagation == propagation_t::MAINTAINING_ARC_CONSISTENCY && !_inqueue[var]) {
+                _queue.push_back (var);
+                _inqueue[var] = true;
+            }
+            return nbvalues > 1;
+        }
+
+        // assign the given value to a variable and disable all enabled values
+        // which are mutex with it, and the last value of every nogood whose
+        // other values are all assigned. All changes are recorded in the
+        // trail. With forward checking, it returns false as soon as the domain
+        // of any variable becomes empty or a nogood is violated; otherwise, it
+        // always returns true
+        bool _assign (const size_t var, const size_t value) {
+
+            // assign the value to the variable
+            _trail.push (opcode_t::VAR_VALUE, var, string::npos);
+            _manager.set_var_value (var, value, string::npos);
+            _varorder.remove (var);
+            _valorder.assign (var, _manager.get_valtable ().get_statuses ());
+            _depth[var] = _levels.size () - 1;
+
+            // and disable all its mutexes which are still enabled. With
+            // forward checking, the remaining mutexes are skipped after the
+            // first wipe-out, which is reported to the variable ordering. The
+            // levels which disabled the other values of the wiped-out variable
+            // are added to the conflict set of this level
+            const shared_ptr<mutextable_t>& mutextable = _manager.get_mutextable ();
+            bool wipeout = false;
+            mutextable->for_each (value, _manager.get_valtable ().get_statuses (),
+                                  [&] (size_t j) {
+                                      if (!wipeout) {
+                                          wipeout = !_disable (j) &&
+                                              _propagation != propagation_t::BACKTRACKING;
+                                          if (wipeout) {
+                                              _varorder.conflict (mutextable->find_block (var, mutextable->get_var (j)));
+                                              _explain (mutextable->get_var (j), _conflicts[_levels.size () - 1]);
+                                          }
+                                      }
+                                  });
+
+            // visit all nogoods watching this value. The levels responsible
+            // for a violated nogood or a wipe-out are added to the conflict set
+            // of this level
+            if (!wipeout && _nogoods.size ()) {
+                const vartable_t& vartable = _manager.get_vartable ();
+                const valtable_t<T>& valtable = _manager.get_valtable ();
+                vector<size_t>& conflicts = _conflicts[_levels.size () - 1];
+                wipeout = !_nogoods.propagate (value,
+                                               [&] (size_t j) {
+                                                   return vartable.get_value (mutextable->get_var (j)) == j;
+                                               },
+                                               [&] (size_t i, size_t j) {
+                                                   _nogoods.bump (i);
+                                                   if (j == string::npos) {
+                                                       _explain_nogood (i, string::npos, conflicts);
+                                                       return false;
+                                                   }
+                                                   if (!valtable.get_status (j)) {
+                                                       return true;
+                                                   }
+                                                   bool consistent = _disable (j);
+                                                   _reason[j] = i;
+                                                   if (!consistent && _propagation != propagation_t::BACKTRACKING) {
+                                                       _explain (mutextable->get_var (j), conflicts);
+                                                       return false;
+                                                   }
+                                                   return true;
+                                               });
+            }
+
+            // when maintaining arc consistency, propagate the removals
+            if (!wipeout && _propagation == propagation_t::MAINTAINING_ARC_CONSISTENCY) {
+                return _propagate ();
+            }
+            _clear_queue ();
+            return !wipeout;
+        }
+
+        // return true if the i-th value, which belongs to the variable var,
+        // has a support in the other variable of the b-th block. The residue
+        // is checked first and, if it is not enabled anymore, a new support is
+        // searched and remembered
+        bool _supported (const size_t i, const size_t var, const size_t b) {
+
+            // compute the location of the residue of this value
+            const shared_ptr<mutextable_t>& mutextable = _manager.get_mutextable ();
+            const vartable_t& vartable = _manager.get_vartable ();
+            size_t& residue = (var == mutextable->get_var1 (b)) ?
+                _residues[_resfirst[b] + i - vartable.get_first (var)] :
+                _residues[_resfirst[b] + 1 + vartable.get_last (mutextable->get_var1 (b))
+                          - vartable.get_first (mutextable->get_var1 (b))
+                          + i - vartable.get_first (var)];
+
+            // if the residue is still enabled it is still a support, because
+            // mutexes never change
+            const bmap_t& statuses = _manager.get_valtable ().get_statuses ();
+            if (residue != string::npos && statuses[residue]) {
+                return true;
+            }
+
+            // otherwise, look for a new one
+            size_t support = mutextable->find_support (i, b, statuses);
+            if (support == string::npos) {
+                return false;
+            }
+            residue = support;
+            return true;
+        }
+
+        // propagate the removal of values from the domains of all variables in
+        // the queue, disabling all values of unassigned variables which have
+        // no support in the domain of another unassigned variable. All changes
+        // are recorded in the trail. It returns false as soon as the
+        // domain of any variable becomes empty and true otherwise
+        bool _propagate () {
+
+            const shared_ptr<mutextable_t>& mutextable = _manager.get_mutextable ();
+            const vartable_t& vartable = _manager.get_vartable ();
+            const valtable_t<T>& valtable = _manager.get_valtable ();
+            while (!_queue.empty ()) {
+
+                // take the next variable whose domain was reduced. Assigned
+                // variables support all enabled values of their neighbours
+                // because all values mutex with their value are disabled
+                size_t var = _queue.back ();
+                _queue.pop_back ();
+                _inqueue[var] = false;
+                if (vartable.get_value (var) != string::npos) {
+                    continue;
+                }
+
+                // revise the values of all unassigned neighbours
+                for (auto b : mutextable->get_blocks (var)) {
+                    size_t other = (mutextable->get_var1 (b) == var) ?
+                        mutextable->get_var2 (b) : mutextable->get_var1 (b);
+                    if (vartable.get_value (other) != string::npos) {
+                        continue;
+                    }
+                    for (auto i = vartable.get_first (other) ; i <= vartable.get_last (other) ; i++) {
+                        if (valtable.get_status (i) && !_supported (i, other, b) &&
+                            !_disable (i)) {
+
+                            // in case of a wipe-out, report it to the variable
+                            // ordering and empty the queue
+                            _varorder.conflict (b);
+                            _clear_queue ();
+                            return false;
+                        }
+                    }
+                }
+            }
+            return true;
+        }
+
+        // empty the queue of variables whose removals have to be propagated
+        void _clear_queue () {
+            for (auto j : _queue) {
+                _inqueue[j] = false;
+            }
+            _queue.clear ();
+        }
+
+        // initialize the data structures used for maintaining arc consistency
+        void _init_propagation () {
+
+            // create an empty queue
+            const shared_ptr<mutextable_t>& mutextable = _manager.get_mutextable ();
+            const vartable_t& vartable = _manager.get_vartable ();
+            _queue.clear ();
+            _inqueue.assign (vartable.size (), false);
+
+            // and no residues for any value in any block
+            _resfirst.clear ();
+            size_t nbresidues = 0;
+            for (size_t b = 0 ; b < mutextable->nbblocks () ; b++) {
+                _resfirst.push_back (nbresidues);
+                for (auto var : {mutextable->get_var1 (b), mutextable->get_var2 (b)}) {
+                    nbresidues += 1 + vartable.get_last (var) - vartable.get_first (var);
+                }
+            }
+            _residues.assign (nbresidues, string::npos);
+        }
+
+        // add to the given conflict set all levels which disabled a value of
+        // the given variable, other than the current one. Values disabled by
+        // a nogood are explained by the levels of its other values
+        void _explain (const size_t var, vector<size_t>& conflicts) const {
+            const vartable_t& vartable = _manager.get_vartable ();
+            const valtable_t<T>& valtable = _manager.get_valtable ();
+            for (auto j = vartable.get_first (var) ; j <= vartable.get_last (var) ; j++) {
+                if (valtable.get_status (j)) {
+                    continue;
+                }
+                if (_reason[j] != string::npos) {
+                    _explain_nogood (_reason[j], j, conflicts);
+                } else if (_killer[j] != string::npos && _killer[j] != _levels.size () - 1) {
+                    conflicts.push_back (_killer[j]);
+                }
+            }
+        }
+
+        // add to the given conflict set the levels of all values of the i-th
+        // nogood other than the given one, except the current level
+        void _explain_nogood (const size_t i, const size_t value, vector<size_t>& conflicts) const {
+            const shared_ptr<mutextable_t>& mutextable = _manager.get_mutextable ();
+            for (auto j : _nogoods[i]) {
+                size_t depth = _depth[mutextable->get_var (j)];
+                if (j != value && depth != _levels.size () - 1) {
+                    conflicts.push_back (depth);
+                }
+            }
+        }
+
+        // if the store of nogoods exceeds its maximum size, reduce it to half
+        // of it, keeping the nogoods which are currently the reason of a
+        // disabled value, and update the reasons of all values
+        void _reduce () {
+            if (_nogoods.size () <= _max_nogoods) {
+                return;
+            }
+            const valtable_t<T>& valtable = _manager.get_valtable ();
+            vector<bool> locked (_nogoods.size (), false);
+            for (size_t j = 0 ; j < _reason.size () ; j++) {
+                if (_reason[j] != string::npos && !valtable.get_status (j)) {
+                    locked[_reason[j]] = true;
+                }
+            }
+            vector<size_t> remap = _nogoods.reduce (_max_nogoods/2,
+                                                    [&] (size_t i) {
+                                                        return locked[i];
+                                                    });
+            for (size_t j = 0 ; j < _reason.size () ; j++) {
+                if (_reason[j] != string::npos) {
+                    _reason[j] = valtable.get_status (j) ? string::npos : remap[_reason[j]];
+                }
+            }
+        }
+
+        // learn a nogood with the values assigned at the given levels, which
+        // are sorted in increasing order, so that the deepest one is watched
+        // along with the next one, and reduce the store if necessary
+        void _learn (const vector<size_t>& levels) {
+            const vartable_t& vartable = _manager.get_vartable ();
+            vector<size_t> literals;
+            for (auto it = levels.rbegin () ; it != levels.rend () ; ++it) {
+                literals.push_back (vartable.get_value (_levels[*it]._var));
+            }
+            _nogoods.add (literals);
+            _nogoods.decay ();
+            _reduce ();
+        }
+
+        // add a new level to the search tree to assign the given variable
+        void _push_level (const size_t var) {
+            _levels.push_back (_level_t {var});
+            if (_conflicts.size () < _levels.size ()) {
+                _conflicts.resize (_levels.size ());
+            }
+            _conflicts[_levels.size () - 1].clear ();
+        }
+
+        // return the level to backtrack to after the current level ran out of
+        // values, or string::npos if there is none. Chronological
+        // backtracking just returns the previous level. Conflict-directed
+        // backjumping returns the deepest level in the conflict set of the
+        // current one, i.e., the levels responsible for the values already
+        // tried and those which disabled the others, and merges the rest of
+        // the conflict set into the conflict set of the returned level. With
+        // nogood learning, the values assigned at the levels of the conflict
+        // set are learnt as a nogood. Because values disabled when
+        // maintaining arc consistency can not be attributed to a single
+        // assignment, neither backjumping nor learning are used in that case
+        size_t _backjump () {
+            size_t depth = _levels.size () - 1;
+            if ((!_backjumping && !_learning) ||
+                _propagation == propagation_t::MAINTAINING_ARC_CONSISTENCY) {
+                return depth ? depth - 1 : string::npos;
+            }
+
+            // compute the conflict set of the current level
+            vector<size_t>& conflicts = _conflicts[depth];
+            _explain (_levels.back ()._var, conflicts);
+            if (conflicts.empty ()) {
+                return string::npos;
+            }
+            sort (conflicts.begin (), conflicts.end ());
+            conflicts.erase (unique (conflicts.begin (), conflicts.end ()), conflicts.end ());
+
+            // learn it as a nogood
+            if (_learning) {
+                _learn (conflicts);
+            }
+
+            // and merge it into the conflict set of the level to backtrack to
+            size_t target = _backjumping ? conflicts.back () : depth - 1;
+            vector<size_t>& tconflicts = _conflicts[target];
+            for (auto d : conflicts) {
+                if (d != target) {
+                    tconflicts.push_back (d);
+                }
+            }
+            sort (tconflicts.begin (), tconflicts.end ());
+            tconflicts.erase (unique (tconflicts.begin (), tconflicts.end ()), tconflicts.end ());
+            return target;
+        }
+
+        // return the i-th term of the Luby sequence, starting at 1
+        static size_t _luby (size_t i) {
+            size_t k = 1;
+            while ((size_t (1) << k) - 1 < i) {
+                k++;
+            }
+            while (i != (size_t (1) << k) - 1) {
+                i -= (size_t (1) << (k-1)) - 1;
+                k = 1;
+                while ((size_t (1) << k) - 1 < i) {
+                    k++;
+                }
+            }
+            return size_t (1) << (k-1);
+        }
+
+        // return the maximum number of failures of the current run
+        size_t _cutoff () const {
+            switch (_restart) {
+                case restart_t::FIXED:
+                    return _restart_base;
+                case restart_t::LUBY:
+                    return _restart_base * _luby (_nbrestarts + 1);
+                case restart_t::GEOMETRIC: {
+                    double cutoff = _restart_base * pow (_restart_factor, _nbrestarts);
+                    return (cutoff < double (numeric_limits<size_t>::max ())) ?
+                        size_t (cutoff) : numeric_limits<size_t>::max ();
+                }
+                default:
+                    return numeric_limits<size_t>::max ();
+            }
+        }
+
+        // restart the search. Every value tried at a level other than the one
+        // currently assigned has been refuted under the assignments of the
+        // previous levels, so that all of them are recorded as nogoods
+        // (negative last decisions) before undoing all assignments at once.
+        // Because nogoods with a single value are never propagated, their
+        // values are disabled at the root. It returns false if the domain of
+        // any variable becomes empty and true otherwise
+        bool _restart_search () {
+
+            // record the nogoods of the current branch. The refuted value is
+            // watched along with the deepest assignment of the branch
+            const vartable_t& vartable = _manager.get_vartable ();
+            vector<size_t> prefix;
+            for (auto& level : _levels) {
+                size_t value = vartable.get_value (level._var);
+                for (auto j = vartable.get_first (level._var) ; j <= vartable.get_last (level._var) ; j++) {
+                    if (_tried[j] && j != value) {
+                        vector<size_t> literals {j};
+                        literals.insert (literals.end (), prefix.rbegin (), prefix.rend ());
+                        _nogoods.add (literals);
+                    }
+                }
+                _tried.clear_range (vartable.get_first (level._var), vartable.get_last (level._var));
+                if (value != string::npos) {
+                    prefix.push_back (value);
+                }
+            }
+
+            // undo all assignments but the changes performed at the root
+            while (_trail.size () > 1) {
+                _trail.unwind (*this);
+            }
+            _levels.clear ();
+
+            // start a new run
+            _nbrestarts++;
+            _runfailures = 0;
+            _valorder.restart (_nbrestarts);
+
+            // and disable the values of all nogoods with a single value. Once
+            // disabled at the root, they are not needed anymore, so that the
+            // store is reduced only afterwards
+            const valtable_t<T>& valtable = _manager.get_valtable ();
+            bool wipeout = false;
+            for (size_t i = 0 ; i < _nogoods.size () && !wipeout ; i++) {
+                wipeout = _nogoods[i].size () == 1 && valtable.get_status (_nogoods[i][0]) &&
+                    !_disable (_nogoods[i][0]) && _propagation != propagation_t::BACKTRACKING;
+            }
+            _reduce ();
+            if (wipeout) {
+                _clear_queue ();
+                return false;
+            }
+            if (_propagation == propagation_t::MAINTAINING_ARC_CONSISTENCY) {
+                return _propagate ();
+            }
+            return true;
+        }
+
+        // return true if the budget of this search has been exhausted, and
+        // update its status accordingly. The clock is only checked every
+        // once in a while
+        bool _exhausted (const chrono::steady_clock::time_point& start) {
+            if (_stop && _stop->load (memory_order_relaxed)) {
+                _status = status_t::INTERRUPTED;
+                return true;
+            }
+            if (_nbnodes >= _node_limit) {
+                _status = status_t::NODE_LIMIT;
+                return true;
+            }
+            if (!(_nbnodes % 256) &&
+                chrono::duration<double> (chrono::steady_clock::now () - start).count () >= _time_limit) {
+                _status = status_t::TIME_LIMIT;
+                return true;
+            }
+            return false;
+        }
+
+        // initialize all data structures of a new search and propagate at
+        // the root, whose changes are recorded in a separate frame of the
+        // trail. In case the root is found to be inconsistent, the status is
+        // set to UNSATISFIABLE
+        void _init () {
+
+            // freeze the manager and make sure no variable has been assigned
+            // yet
+            _manager.freeze ();
+            const vartable_t& vartable = _manager.get_vartable ();
+            for (size_t i = 0 ; i < vartable.size () ; i++) {
+                if (vartable.get_value (i) != string::npos) {
+                    throw runtime_error ("[backtracking::solve] Variables can not be assigned before searching");
+                }
+            }
+
+            // initialize the search
+            _status = status_t::UNKNOWN;
+            _solution.clear ();
+            _nbnodes = _nbbacktracks = _nbfailures = _nbrestarts = _runfailures = 0;
+            _levels.clear ();
+            _tried = bmap_t (_manager.get_valtable ().size ());
+            _killer.assign (_manager.get_valtable ().size (), string::npos);
+            _nogoods = nogoodstore_t (_manager.get_valtable ().size ());
+            _reason.assign (_manager.get_valtable ().size (), string::npos);
+            _depth.assign (vartable.size (), string::npos);
+            _trail.clear ();
+            _varorder.init (vartable, *_manager.get_mutextable ());
+            _valorder.init (vartable, *_manager.get_mutextable ());
+
+            // all changes performed at the root are recorded in a separate
+            // frame. When maintaining arc consistency, make all variables arc
+            // consistent before starting the search
+            _init_propagation ();
+            _trail.open_frame ();
+            if (_propagation == propagation_t::MAINTAINING_ARC_CONSISTENCY) {
+                for (size_t i = 0 ; i < vartable.size () ; i++) {
+                    _queue.push_back (i);
+                    _inqueue[i] = true;
+                }
+                if (!_propagate ()) {
+                    _status = status_t::UNSATISFIABLE;
+                }
+            }
+        }
+
+        // restore the manager to its state before the search
+        void _restore () {
+            while (_trail.size ()) {
+                _trail.unwind (*this);
+            }
+            _levels.clear ();
+        }
+
+    public:
+
+        // The default constructor is strictly forbidden
+        backtracking () = delete;
+
+        // Explicit constructor - given the manager with the definition of the
+        // CSP task to solve. By default, there are no limits on the number of
+        // nodes or time. Note that implicit casting is forbidden
+        explicit backtracking (manager<T>& mgr) :
+            _manager { mgr },
+            _propagation { propagation_t::BACKTRACKING },
+            _backjumping { false },
+            _learning { false },
+            _restart { restart_t::NONE },
+            _restart_base { 100 },
+            _restart_factor { 1.5 },
+            _runfailures { 0 },
+            _node_limit { numeric_limits<size_t>::max () },
+            _time_limit { numeric_limits<double>::max () },
+            _stop { nullptr },
+            _status { status_t::UNKNOWN },
+            _solution { vector<size_t>() },
+            _nbnodes { 0 },
+            _nbbacktracks { 0 },
+            _nbfailures { 0 },
+            _nbrestarts { 0 },
+            _elapsed { 0.0 },
+            _levels { vector<_level_t>() },
+            _tried { bmap_t (0) },
+            _killer { vector<size_t>() },
+            _conflicts { vector<vector<size_t>>() },
+            _nogoods { nogoodstore_t (0) },
+            _max_nogoods { 10'000 },
+            _reason { vector<size_t>() },
+            _depth { vector<size_t>() },
+            _trail { trail_t () },
+            _varorder { VarOrder () },
+            _valorder { ValOrder () },
+            _queue { vector<size_t>() },
+            _inqueue { vector<bool>() },
+            _residues { vector<size_t>() },
+            _resfirst { vector<size_t>() }
+        {}
+
+        // Searches can not be copied
+        backtracking (const backtracking&) = delete;
+
+        // accessors
+
+        // return the status of the last search
+        status_t get_status () const {
+            return _status;
+        }
+
+        // return the solution found in the last search as a vector with the
+        // index of the value assigned to every variable. If no solution was
+        // found, it is empty
+        const vector<size_t>& get_solution () const {
+            return _solution;
+        }
+
+        // return the number of nodes expanded in the last search, i.e., the
+        // number of assignments performed
+        size_t get_nbnodes () const {
+            return _nbnodes;
+        }
+
+        // return the number of backtracks performed in the last search
+        size_t get_nbbacktracks () const {
+            return _nbbacktracks;
+        }
+
+        // return the number of failures in the last search, i.e., the number
+        // of inconsistent assignments plus the number of backtracks
+        size_t get_nbfailures () const {
+            return _nbfailures;
+        }
+
+        // return the number of restarts performed in the last search
+        size_t get_nbrestarts () const {
+            return _nbrestarts;
+        }
+
+        // return the time elapsed in the last search in seconds
+        double get_elapsed () const {
+            return _elapsed;
+        }
+
+        // return the propagation performed after every assignment
+        propagation_t get_propagation () const {
+            return _propagation;
+        }
+
+        // return whether conflict-directed backjumping is used or not
+        bool get_backjumping () const {
+            return _backjumping;
+        }
+
+        // return whether nogood learning is used or not
+        bool get_learning () const {
+            return _learning;
+        }
+
+        // return the restart policy
+        restart_t get_restart () const {
+            return _restart;
+        }
+
+        // return the nogoods learnt in the last search
+        const nogoodstore_t& get_nogoods () const {
+            return _nogoods;
+        }
+
+        // return the maximum number of nogoods to store
+        size_t get_max_nogoods () const {
+            return _max_nogoods;
+        }
+
+        // return the strategies used for selecting variables and values
+        const VarOrder& get_varorder () const {
+            return _varorder;
+        }
+        const ValOrder& get_valorder () const {
+            return _valorder;
+        }
+
+        // modifiers
+
+        // return the strategies used for selecting variables and values so
+        // that they can be configured
+        VarOrder& get_varorder () {
+            return _varorder;
+        }
+        ValOrder& get_valorder () {
+            return _valorder;
+        }
+
+        // set the propagation performed after every assignment
+        void set_propagation (const propagation_t propagation) {
+            _propagation = propagation;
+        }
+
+        // enable or disable conflict-directed backjumping
+        void set_backjumping (const bool backjumping) {
+            _backjumping = backjumping;
+        }
+
+        // enable or disable nogood learning. Nogoods are not learnt when
+        // maintaining arc consistency
+        void set_learning (const bool learning) {
+            _learning = learning;
+        }
+
+        // set the restart policy, with the cutoff of the first run in number
+        // of failures and the factor of geometric restarts. Luby and
+        // geometric restarts are complete because their cutoffs grow
+        // unboundedly. Fixed cutoffs are complete only as long as the store
+        // of nogoods is large enough to keep those recorded at every restart:
+        // once it exceeds its maximum size, the least active ones are removed
+        // and later runs might explore again the subtrees they refuted
+        void set_restart (const restart_t restart, const size_t base=100, const double factor=1.5) {
+            if (!base || factor < 1.0) {
+                throw invalid_argument ("[backtracking::set_restart] Wrong cutoff");
+            }
+            _restart = restart;
+            _restart_base = base;
+            _restart_factor = factor;
+        }
+
+        // set the maximum number of nogoods to store, either learnt or
+        // recorded at restarts. Once exceeded, the nogoods with the lowest
+        // activity are removed until half of them remain, except those which
+        // are currently the reason of a disabled value
+        void set_max_nogoods (const size_t max_nogoods) {
+            _max_nogoods = max_nogoods;
+        }
+
+        // set the maximum number of nodes to expand
+        void set_node_limit (const size_t limit) {
+            _node_limit = limit;
+        }
+
+        // set the maximum time allowed in seconds
+        void set_time_limit (const double limit) {
+            _time_limit = limit;
+        }
+
+        // set the flag used to interrupt the search from other threads, or
+        // nullptr if it can not be interrupted
+        void set_stop (const atomic<bool>* stop) {
+            _stop = stop;
+        }
+
+        // The following services allow other searches (e.g., parallel ones)
+        // to traverse the search tree themselves, one assignment at a time,
+        // using the propagation of this search. Neither backjumping, nor
+        // learning nor restarts are used in this case
+
+        // initialize a new search and propagate at the root. The manager is
+        // frozen if it was not yet. It returns false if the root is found to
+        // be inconsistent and true otherwise
+        bool open () {
+            _init ();
+            return _status == status_t::UNKNOWN;
+        }
+
+        // return the next variable to assign according to the variable
+        // ordering, or string::npos if all of them have been already assigned
+        size_t select () {
+            return _select ();
+        }
+
+        // return all enabled values of the given variable in the order
+        // defined by the value ordering
+        vector<size_t> candidates (const size_t var) {
+            const vartable_t& vartable = _manager.get_vartable ();
+            vector<size_t> result;
+            for (auto value = _valorder.select (var, vartable, _manager.get_valtable (), _tried) ;
+                 value != string::npos ;
+                 value = _valorder.select (var, vartable, _manager.get_valtable (), _tried)) {
+                _tried.set (value, true);
+                result.push_back (value);
+            }
+            _tried.clear_range (vartable.get_first (var), vartable.get_last (var));
+            return result;
+        }
+
+        // assign the given value to its variable in a new level of the search
+        // tree and propagate it. It returns true if the assignment is
+        // consistent; otherwise, it is undone and false is returned. Values
+        // which are disabled or whose variable is already assigned are
+        // immediately rejected
+        bool push (const size_t value) {
+            size_t var = _manager.get_mutextable ()->get_var (value);
+            if (_manager.get_vartable ().get_value (var) != string::npos ||
+                !_manager.get_valtable ().get_status (value)) {
+                return false;
+            }
+            _nbnodes++;
+            _push_level (var);
+            _trail.open_frame ();
+            if (!_assign (var, value)) {
+                _nbfailures++;
+                _trail.unwind (*this);
+                _levels.pop_back ();
+                return false;
+            }
+            return true;
+        }
+
+        // undo the last assignment
+        void pop () {
+            if (_levels.empty ()) {
+                throw runtime_error ("[backtracking::pop] No assignments");
+            }
+            _trail.unwind (*this);
+            _levels.pop_back ();
+        }
+
+        // return the number of assignments currently performed
+        size_t depth () const {
+            return _levels.size ();
+        }
+
+        // undo all assignments and restore the manager to its state before
+        // the search
+        void close () {
+            _restore ();
+        }
+
+        // search for the first solution of the CSP task. The manager is frozen
+        // if it was not yet. It returns SATISFIABLE if a solution was found,
+        // UNSATISFIABLE if there is none, NODE_LIMIT or TIME_LIMIT if the
+        // budget was exhausted, and INTERRUPTED if the stop flag was raised
+        // by another thread. In all cases, the manager is restored to its
+        // state before the search
+        status_t solve () {
+
+            // initialize the search
+            auto start = chrono::steady_clock::now ();
+            _init ();
+            const vartable_t& vartable = _manager.get_vartable ();
+
+            // create the root of the search tree, unless there are no
+            // variables at all or the task was already found unsatisfiable
+            size_t var = _select ();
+            if (_status == status_t::UNKNOWN) {
+                if (var == string::npos) {
+                    _status = status_t::SATISFIABLE;
+                } else {
+                    _push_level (var);
+                }
+            }
+
+            while (_status == status_t::UNKNOWN) {
+
+                // restart the search once the current run exceeds its cutoff
+                if (_runfailures >= _cutoff ()) {
+                    if (!_restart_search ()) {
+                        _status = status_t::UNSATISFIABLE;
+                    } else {
+                        _push_level (_select ());
+                    }
+                    continue;
+                }
+
+                // get the next value to try at the current level. In case there
+                // is none, backtrack to the previous level (or jump back to a
+                // shallower one) undoing all assignments down to it
+                _level_t& level = _levels.back ();
+                size_t value = _next_value (level);
+                if (value == string::npos) {
+                    _nbbacktracks++;
+                    _nbfailures++;
+                    _runfailures++;
+                    size_t target = _backjump ();
+                    _tried.clear_range (vartable.get_first (level._var), vartable.get_last (level._var));
+                    _levels.pop_back ();
+                    if (target == string::npos) {
+                        _status = status_t::UNSATISFIABLE;
+                        continue;
+                    }
+                    while (_levels.size () > target + 1) {
+                        _trail.unwind (*this);
+                        _tried.clear_range (vartable.get_first (_levels.back ()._var),
+                                            vartable.get_last (_levels.back ()._var));
+                        _levels.pop_back ();
+                    }
+                    _trail.unwind (*this);
+                    continue;
+                }
+
+                // make sure there is still budget for expanding this node
+                if (_exhausted (start)) {
+                    break;
+                }
+                _nbnodes++;
+
+                // assign this value to the variable of this level and record
+                // all changes in a new frame of the trail. In case the
+                // assignment is found to be inconsistent, undo it immediately
+                // and try the next value
+                _trail.open_frame ();
+                if (!_assign (level._var, value)) {
+                    _nbfailures++;
+                    _runfailures++;
+                    _trail.unwind (*this);
+                    continue;
+                }
+
+                // and proceed with the next variable. If all have been already
+                // assigned, a solution has been found
+                var = _select ();
+                if (var == string::npos) {
+                    for (size_t i = 0 ; i < vartable.size () ; i++) {
+                        _solution.push_back (vartable.get_value (i));
+                    }
+                    _status = status_t::SATISFIABLE;
+                } else {
+                    _push_level (var);
+                }
+            }
+
+            // restore the manager to its state before the search
+            _restore ();
+            _elapsed = chrono::duration<double> (chrono::steady_clock::now () - start).count ();
+            return _status;
+        }
+};
+
+#endif // _MUXBACKTRACKING_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,21 @@
+// -*- coding: utf-8 -*-
+// MUXbranchandbound.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <sáb 28-08-2021 11:02:51.118274903 (1630141371)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Depth-first branch and bound over the CSP task defined in a manager, looking
+// for the solution which minimizes the overall cost of its soft constraints.
+// Note that the search is a template because it can act on values defined over
+// any type T
+
+#include "MUXbranchandbound.h"
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,443 @@
+// -*- coding: utf-8 -*-
+// MUXbranchandbound.h
+// -----------------------------------------------------------------------------
+//
+// Started on <sáb 28-08-2021 11:02:17.493807162 (1630141337)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Depth-first branch and bound over the CSP task defined in a manager, looking
+// for the solution which minimizes the overall cost of its soft constraints
+
+#ifndef _MUXBRANCHANDBOUND_H_
+#define _MUXBRANCHANDBOUND_H_
+
+#include<algorithm>
+#include<chrono>
+#include<limits>
+#include<string>
+#include<utility>
+#include<vector>
+
+#include "../structs/MUXcosttable_t.h"
+#include "MUXbacktracking.h"
+#include "MUXmanager.h"
+
+using namespace std;
+
+// Class definition
+//
+// Definition of a depth-first branch and bound. The search tree is traversed
+// with the propagation of a backtracking search, so that hard constraints are
+// enforced as usual, while the cost of every soft constraint violated by the
+// current assignment is accumulated. The unary cost of every value is the sum
+// of the costs of the pairs it forms with all assigned values, and the lower
+// bound of every node is the cost of its assignment plus the minimum unary cost
+// of every unassigned variable. Unary costs are updated incrementally after
+// every assignment by traversing the entries of the assigned value in the table
+// of costs, and the minimum unary costs are recomputed only for the variables
+// of those entries. Values are tried in increasing order of their unary cost,
+// so that as soon as one exceeds the cost of the best solution found so far
+// (the upper bound), the rest are pruned as well. Note that the search is a
+// template because it can act on values defined over any type T, and variables
+// are selected with the given ordering strategy
+template<class T, class VarOrder = varorder_lex_t>
+class branchandbound {
+
+    private:
+
+        // INVARIANT: every level of the search tree stores its variable, the
+        // values to try sorted in increasing order of their unary costs, the
+        // next one to try and, while one is assigned, the cost of the
+        // assignment, the lower bound and the size of the log before
+        // assigning it
+        struct _frame_t {
+            size_t _var;
+            vector<size_t> _values;
+            size_t _next;
+            size_t _cost;
+            size_t _lbsum;
+            size_t _mark;
+        };
+
+        // INVARIANT: a branch and bound acts over the CSP task defined in a
+        // manager, which is modified during the search and restored right
+        // after it, with the propagation of a backtracking search
+        manager<T>& _manager;
+        backtracking<T, VarOrder> _search;
+
+        // all solutions found have to be strictly cheaper than the upper
+        // bound
+        size_t _upper_bound;
+
+        // maximum time allowed (in seconds)
+        double _time_limit;
+
+        // outcome of the last search: its status, the cheapest solution found
+        // (if any), its cost and some statistics
+        status_t _status;
+        vector<size_t> _solution;
+        size_t _cost;
+        size_t _nbsolutions;
+        size_t _nbnodes;
+        size_t _nbprunes;
+        double _elapsed;
+
+        // state of the search: the unary cost of every value, the minimum
+        // unary cost of every variable, the cost of the current assignment,
+        // the sum of the minimum unary costs of all unassigned variables and
+        // a log with the previous minimum unary costs of every variable
+        // updated, which are restored when backtracking
+        vector<size_t> _unary;
+        vector<size_t> _minunary;
+        size_t _current;
+        size_t _lbsum;
+        vector<pair<size_t, size_t>> _log;
+
+        // return the minimum unary cost of the enabled values of the given
+        // variable, or its current minimum if all of them are disabled
+        size_t _min (const size_t var) const;
+
+        // assign the given value to the variable of the given frame and
+        // update the unary costs and the lower bound. It returns false if the
+        // assignment is either inconsistent or it can not improve the upper
+        // bound, in which case it is undone
+        bool _assign (_frame_t& frame, const size_t value);
+
+        // undo the assignment of the given frame
+        void _unassign (_frame_t& frame);
+
+        // create a new frame for the given variable with its enabled values
+        // sorted in increasing order of their unary costs
+        _frame_t _frame (const size_t var);
+
+    public:
+
+        // The default constructor is strictly forbidden
+        branchandbound () = delete;
+
+        // Explicit constructor - given the manager with the definition of the
+        // CSP task. By default, there is no upper bound, no propagation and
+        // no limit on time. Note that implicit casting is forbidden
+        explicit branchandbound (manager<T>& mgr) :
+            _manager { mgr },
+            _search { backtracking<T, VarOrder> (mgr) },
+            _upper_bound { numeric_limits<size_t>::max () },
+            _time_limit { numeric_limits<double>::max () },
+            _status { status_t::UNKNOWN },
+            _solution { vector<size_t>() },
+            _cost { numeric_limits<size_t>::max () },
+            _nbsolutions { 0 },
+            _nbnodes { 0 },
+            _nbprunes { 0 },
+            _elapsed { 0.0 },
+            _unary { vector<size_t>() },
+            _minunary { vector<size_t>() },
+            _current { 0 },
+            _lbsum { 0 },
+            _log { vector<pair<size_t, size_t>>() }
+        {}
+
+        // Searches can not be copied
+        branchandbound (const branchandbound&) = delete;
+
+        // accessors
+
+        // return the status of the last search
+        status_t get_status () const {
+            return _status;
+        }
+
+        // return the cheapest solution found in the last search with the
+        // index of the value assigned to every variable, if any
+        const vector<size_t>& get_solution () const {
+            return _solution;
+        }
+
+        // return the cost of the cheapest solution found in the last search,
+        // or the maximum size_t if none was found
+        size_t get_cost () const {
+            return _cost;
+        }
+
+        // return the number of solutions found in the last search, every one
+        // strictly cheaper than the previous one
+        size_t get_nbsolutions () const {
+            return _nbsolutions;
+        }
+
+        // return the number of nodes expanded in the last search
+        size_t get_nbnodes () const {
+            return _nbnodes;
+        }
+
+        // return the number of values pruned by the lower bound in the last
+        // search
+        size_t get_nbprunes () const {
+            return _nbprunes;
+        }
+
+        // return the time elapsed in the last search in seconds
+        double get_elapsed () const {
+            return _elapsed;
+        }
+
+        // return the upper bound of the cost of all solutions
+        size_t get_upper_bound () const {
+            return _upper_bound;
+        }
+
+        // return the propagation performed after every assignment
+        propagation_t get_propagation () const {
+            return _search.get_propagation ();
+        }
+
+        // modifiers
+
+        // set the upper bound of the cost of all solutions, which have to be
+        // strictly cheaper than it
+        void set_upper_bound (const size_t upper_bound) {
+            _upper_bound = upper_bound;
+        }
+
+        // set the propagation performed after every assignment
+        void set_propagation (const propagation_t propagation) {
+            _search.set_propagation (propagation);
+        }
+
+        // set the maximum time allowed in seconds
+        void set_time_limit (const double limit) {
+            _time_limit = limit;
+        }
+
+        // search for the cheapest solution of the CSP task. The manager is
+        // frozen if it was not yet. It returns SATISFIABLE if the cheapest
+        // solution was found, UNSATISFIABLE if there is no solution cheaper
+        // than the upper bound, and TIME_LIMIT if time was exhausted, in which
+        // case the solution found (if any) is not necessarily the cheapest
+        // one. In all cases, the manager is restored to its state before the
+        // search
+        status_t solve ();
+};
+
+// return the minimum unary cost of the enabled values of the given variable
+template<class T, class VarOrder>
+size_t branchandbound<T, VarOrder>::_min (const size_t var) const {
+    const vartable_t& vartable = _manager.get_vartable ();
+    const valtable_t<T>& valtable = _manager.get_valtable ();
+    size_t result = numeric_limits<size_t>::max ();
+    for (auto j = vartable.get_first (var) ; j <= vartable.get_last (var) ; j++) {
+        if (valtable.get_status (j)) {
+            result = min (result, _unary[j]);
+        }
+    }
+    return (result == numeric_limits<size_t>::max ()) ? _minunary[var] : result;
+}
+
+// assign the given value to the variable of the given frame
+template<class T, class VarOrder>
+bool branchandbound<T, VarOrder>::_assign (_frame_t& frame, const size_t value) {
+
+    // first, propagate the assignment with the backtracking search
+    if (!_search.push (value)) {
+        return false;
+    }
+    _nbnodes++;
+
+    // remember the state before the assignment so that it can be undone
+    frame._cost = _current;
+    frame._lbsum = _lbsum;
+    frame._mark = _log.size ();
+
+    // add the unary cost of the value to the cost of the assignment, and
+    // remove its variable from the lower bound
+    _current += _unary[value];
+    _lbsum -= _minunary[frame._var];
+
+    // next, update the unary costs of all values forming a pair with this one
+    // and the minimum unary cost of their variables, if they are still
+    // unassigned. Entries are sorted by value, so that the entries of the same
+    // variable are consecutive
+    const shared_ptr<costtable_t>& costtable = _manager.get_costtable ();
+    if (costtable) {
+        const vartable_t& vartable = _manager.get_vartable ();
+        const mutextable_t& mutextable = *_manager.get_mutextable ();
+        for (auto& entry : (*costtable)[value]) {
+            _unary[entry._value] += entry._cost;
+        }
+        size_t last = string::npos;
+        for (auto& entry : (*costtable)[value]) {
+            size_t var = mutextable.get_var (entry._value);
+            if (var == last || vartable.get_value (var) != string::npos) {
+                continue;
+            }
+            last = var;
+            size_t updated = _min (var);
+            if (updated != _minunary[var]) {
+                _log.push_back (make_pair (var, _minunary[var]));
+                _lbsum += updated - _minunary[var];
+                _minunary[var] = updated;
+            }
+        }
+    }
+
+    // finally, prune this node if its lower bound does not improve the upper
+    // bound
+    if (_current + _lbsum >= _cost) {
+        _nbprunes++;
+        _unassign (frame);
+        return false;
+    }
+    return true;
+}
+
+// undo the assignment of the given frame
+template<class T, class VarOrder>
+void branchandbound<T, VarOrder>::_unassign (_frame_t& frame) {
+
+    // the value assigned is the last one tried in this frame
+    size_t value = frame._values[frame._next - 1];
+
+    // restore the unary costs of all values forming a pair with it, and the
+    // minimum unary costs recorded in the log
+    const shared_ptr<costtable_t>& costtable = _manager.get_costtable ();
+    if (costtable) {
+        for (auto& entry : (*costtable)[value]) {
+            _unary[entry._value] -= entry._cost;
+        }
+    }
+    while (_log.size () > frame._mark) {
+        _minunary[_log.back ().first] = _log.back ().second;
+        _log.pop_back ();
+    }
+    _current = frame._cost;
+    _lbsum = frame._lbsum;
+
+    // and undo the assignment in the backtracking search
+    _search.pop ();
+}
+
+// create a new frame for the given variable
+template<class T, class VarOrder>
+typename branchandbound<T, VarOrder>::_frame_t branchandbound<T, VarOrder>::_frame (const size_t var) {
+    _frame_t frame {var, _search.candidates (var), 0, 0, 0, 0};
+    stable_sort (frame._values.begin (), frame._values.end (),
+                 [&] (const size_t left, const size_t right) {
+                     return _unary[left] < _unary[right];
+                 });
+    return frame;
+}
+
+// search for the cheapest solution of the CSP task
+template<class T, class VarOrder>
+status_t branchandbound<T, VarOrder>::solve () {
+
+    // initialize the search
+    auto start = chrono::steady_clock::now ();
+    _status = status_t::UNKNOWN;
+    _solution.clear ();
+    _cost = _upper_bound;
+    _nbsolutions = _nbnodes = _nbprunes = 0;
+    _log.clear ();
+    _current = _lbsum = 0;
+
+    // propagate at the root. If it is inconsistent there is no solution at
+    // all. Otherwise, all unary costs are null at the root
+    if (!_search.open ()) {
+        _search.close ();
+        _status = status_t::UNSATISFIABLE;
+        _elapsed = chrono::duration<double> (chrono::steady_clock::now () - start).count ();
+        return _status;
+    }
+    const vartable_t& vartable = _manager.get_vartable ();
+    _unary = vector<size_t> (_manager.get_valtable ().size (), 0);
+    _minunary = vector<size_t> (vartable.size (), 0);
+
+    // traverse the search tree depth-first. Every iteration either expands
+    // the current node or, when backtracking, undoes the assignment of the
+    // deepest level, and then tries the next values of the deepest level
+    vector<_frame_t> frames;
+    bool backtrack = false;
+    size_t iteration = 0;
+    while (true) {
+
+        // check the clock every once in a while
+        if (!(++iteration % 256) &&
+            chrono::duration<double> (chrono::steady_clock::now () - start).count () >= _time_limit) {
+            _status = status_t::TIME_LIMIT;
+            break;
+        }
+
+        // when expanding a node, either all variables are assigned and a new
+        // solution has been found, which is necessarily cheaper than the best
+        // one so far, or a new level is created for the next variable
+        if (!backtrack) {
+            size_t var = _search.select ();
+            if (var == string::npos) {
+                _solution.clear ();
+                for (size_t i = 0 ; i < vartable.size () ; i++) {
+                    _solution.push_back (vartable.get_value (i));
+                }
+                _cost = _current;
+                _nbsolutions++;
+                backtrack = true;
+            } else {
+                frames.push_back (_frame (var));
+            }
+        }
+
+        // when backtracking, undo the assignment of the deepest level, unless
+        // the whole tree has been already traversed
+        if (backtrack) {
+            if (frames.empty ()) {
+                break;
+            }
+            _unassign (frames.back ());
+            backtrack = false;
+        }
+
+        // try the next values of the deepest level. Because they are sorted
+        // in increasing order of their unary costs, once one can not improve
+        // the upper bound, none of the others can either
+        _frame_t& frame = frames.back ();
+        bool assigned = false;
+        while (!assigned && frame._next < frame._values.size ()) {
+            size_t value = frame._values[frame._next++];
+            if (_current + _unary[value] + _lbsum - _minunary[frame._var] >= _cost) {
+                _nbprunes += frame._values.size () - frame._next + 1;
+                frame._next = frame._values.size ();
+                break;
+            }
+            assigned = _assign (frame, value);
+        }
+
+        // if no value was assigned, backtrack to the previous level
+        if (!assigned) {
+            frames.pop_back ();
+            backtrack = true;
+        }
+    }
+
+    // if the whole tree was traversed, the last solution found is the
+    // cheapest one
+    if (_status == status_t::UNKNOWN) {
+        _status = _nbsolutions ? status_t::SATISFIABLE : status_t::UNSATISFIABLE;
+    }
+    if (!_nbsolutions) {
+        _cost = numeric_limits<size_t>::max ();
+    }
+
+    // restore the manager to its state before the search
+    _search.close ();
+    _elapsed = chrono::duration<double> (chrono::steady_clock::now () - start).count ();
+    return _status;
+}
+
+#endif // _MUXBRANCHANDBOUND_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,20 @@
+// -*- coding: utf-8 -*-
+// MUXcounter.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <jue 26-08-2021 10:21:44.250917385 (1629966104)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Exact counting of the solutions of the CSP task defined in a manager (#CSP).
+// Note that the counter is a template because it can act on values defined
+// over any type T
+
+#include "MUXcounter.h"
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
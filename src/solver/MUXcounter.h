@@ -0,0 +1,413 @@
+// -*- coding: utf-8 -*-
+// MUXcounter.h
+// -----------------------------------------------------------------------------
+//
+// Started on <jue 26-08-2021 10:21:09.614023781 (1629966069)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Exact counting of the solutions of the CSP task defined in a manager (#CSP)
+// with decomposition into connected components and component caching
+
+#ifndef _MUXCOUNTER_H_
+#define _MUXCOUNTER_H_
+
+#include<algorithm>
+#include<chrono>
+#include<cstdint>
+#include<functional>
+#include<limits>
+#include<string>
+#include<unordered_map>
+#include<vector>
+
+#include "MUXbacktracking.h"
+#include "MUXmanager.h"
+
+using namespace std;
+
+// Class definition
+//
+// Definition of a counter of solutions. The search tree is traversed
+// depth-first with the propagation of a backtracking search. Because all
+// values which are mutex with an assigned value are disabled, the unassigned
+// variables can be counted independently of the assigned ones given their
+// current domains. Thus, after every assignment the unassigned variables are
+// split into the connected components of the constraint graph, i.e., the graph
+// whose edges are the blocks of the table of mutexes, and the number of
+// solutions is the product of the number of solutions of every component.
+// Every component is counted by branching over the values of its variable with
+// the smallest domain, and its count is cached with a key made of its
+// variables and their current domains, so that components found again in other
+// branches are not counted twice. Counts are computed with 128-bit unsigned
+// integers. Note that the counter is a template because it can act on values
+// defined over any type T
+template<class T>
+class counter {
+
+    public:
+
+        // all counts are computed with 128-bit unsigned integers
+        typedef unsigned __int128 count_t;
+
+    private:
+
+        // every component is cached with a key made of the index of each
+        // variable followed by the bits of the statuses of its values
+        typedef vector<uint64_t> _key_t;
+        struct _hash_t {
+            size_t operator() (const _key_t& key) const {
+                size_t result = key.size ();
+                for (auto word : key) {
+                    result ^= hash<uint64_t>{} (word) + 0x9e3779b97f4a7c15 + (result << 6) + (result >> 2);
+                }
+                return result;
+            }
+        };
+
+        // INVARIANT: a counter acts over the CSP task defined in a manager,
+        // which is modified during the search and restored right after it,
+        // with the propagation of a backtracking search
+        manager<T>& _manager;
+        backtracking<T> _search;
+
+        // whether unassigned variables are decomposed into connected
+        // components, and the maximum number of components to cache. Once
+        // exceeded, the cache is emptied
+        bool _decomposition;
+        size_t _max_cache;
+
+        // maximum time allowed (in seconds)
+        double _time_limit;
+
+        // outcome of the last count: its status, the number of solutions and
+        // some statistics
+        status_t _status;
+        count_t _nbsolutions;
+        size_t _nbnodes;
+        size_t _nbhits;
+        size_t _nbsplits;
+        double _elapsed;
+
+        // the cache of components, and the time the last count started
+        unordered_map<_key_t, count_t, _hash_t> _cache;
+        chrono::steady_clock::time_point _start;
+
+        // split the given variables into the connected components of the
+        // constraint graph restricted to them. Variables are given in
+        // increasing order, and so they are in every component
+        vector<vector<size_t>> _components (const vector<size_t>& vars) const;
+
+        // return the key of the given component
+        _key_t _key (const vector<size_t>& component) const;
+
+        // return the number of solutions of the given unassigned variables,
+        // which are given in increasing order
+        count_t _count (const vector<size_t>& vars);
+
+        // return the number of solutions of the given connected component
+        count_t _count_component (const vector<size_t>& component);
+
+    public:
+
+        // The default constructor is strictly forbidden
+        counter () = delete;
+
+        // Explicit constructor - given the manager with the definition of the
+        // CSP task. By default, variables are decomposed into components, up
+        // to one million of them are cached, there is no propagation and no
+        // limit on time. Note that implicit casting is forbidden
+        explicit counter (manager<T>& mgr) :
+            _manager { mgr },
+            _search { backtracking<T> (mgr) },
+            _decomposition { true },
+            _max_cache { 1'000'000 },
+            _time_limit { numeric_limits<double>::max () },
+            _status { status_t::UNKNOWN },
+            _nbsolutions { 0 },
+            _nbnodes { 0 },
+            _nbhits { 0 },
+            _nbsplits { 0 },
+            _elapsed { 0.0 },
+            _cache { unordered_map<_key_t, count_t, _hash_t>() },
+            _start { chrono::steady_clock::now () }
+        {}
+
+        // Counters can not be copied
+        counter (const counter&) = delete;
+
+        // accessors
+
+        // return the status of the last count
+        status_t get_status () const {
+            return _status;
+        }
+
+        // return the number of solutions found in the last count. If time was
+        // exhausted, it is only a lower bound
+        count_t get_nbsolutions () const {
+            return _nbsolutions;
+        }
+
+        // return the number of nodes expanded in the last count
+        size_t get_nbnodes () const {
+            return _nbnodes;
+        }
+
+        // return the number of components found in the cache in the last count
+        size_t get_nbhits () const {
+            return _nbhits;
+        }
+
+        // return the number of times the unassigned variables were split into
+        // more than one component in the last count
+        size_t get_nbsplits () const {
+            return _nbsplits;
+        }
+
+        // return the time elapsed in the last count in seconds
+        double get_elapsed () const {
+            return _elapsed;
+        }
+
+        // return the propagation performed after every assignment
+        propagation_t get_propagation () const {
+            return _search.get_propagation ();
+        }
+
+        // return whether unassigned variables are decomposed into components
+        bool get_decomposition () const {
+            return _decomposition;
+        }
+
+        // return the maximum number of components to cache
+        size_t get_max_cache () const {
+            return _max_cache;
+        }
+
+        // modifiers
+
+        // set the propagation performed after every assignment
+        void set_propagation (const propagation_t propagation) {
+            _search.set_propagation (propagation);
+        }
+
+        // enable or disable the decomposition into components
+        void set_decomposition (const bool decomposition) {
+            _decomposition = decomposition;
+        }
+
+        // set the maximum number of components to cache. If it is zero, no
+        // component is cached
+        void set_max_cache (const size_t max_cache) {
+            _max_cache = max_cache;
+        }
+
+        // set the maximum time allowed in seconds
+        void set_time_limit (const double limit) {
+            _time_limit = limit;
+        }
+
+        // count all solutions of the CSP task. The manager is frozen if it was
+        // not yet. It returns SATISFIABLE if there is at least one solution,
+        // UNSATISFIABLE if there is none, and TIME_LIMIT if time was
+        // exhausted. In all cases, the manager is restored to its state before
+        // the count
+        status_t count ();
+
+        // return the decimal representation of the given count
+        static string to_string (count_t count) {
+            string result;
+            do {
+                result.push_back ('0' + int (count % 10));
+                count /= 10;
+            } while (count);
+            reverse (result.begin (), result.end ());
+            return result;
+        }
+};
+
+// split the given variables into the connected components of the constraint
+// graph restricted to them
+template<class T>
+vector<vector<size_t>> counter<T>::_components (const vector<size_t>& vars) const {
+
+    // without decomposition, all variables are in the same component
+    if (!_decomposition) {
+        return vector<vector<size_t>> {vars};
+    }
+
+    // traverse the constraint graph breadth-first from every variable not
+    // visited yet. Because all given variables are unassigned and all
+    // variables in the same component with them are unassigned as well, only
+    // unassigned variables have to be considered
+    const mutextable_t& mutextable = *_manager.get_mutextable ();
+    const vartable_t& vartable = _manager.get_vartable ();
+    vector<vector<size_t>> result;
+    vector<bool> visited (vartable.size (), false);
+    for (auto var : vars) {
+        if (visited[var]) {
+            continue;
+        }
+        vector<size_t> component {var};
+        visited[var] = true;
+        for (size_t i = 0 ; i < component.size () ; i++) {
+            for (auto b : mutextable.get_blocks (component[i])) {
+                size_t other = (mutextable.get_var1 (b) == component[i]) ?
+                    mutextable.get_var2 (b) : mutextable.get_var1 (b);
+                if (!visited[other] && vartable.get_value (other) == string::npos) {
+                    visited[other] = true;
+                    component.push_back (other);
+                }
+            }
+        }
+        sort (component.begin (), component.end ());
+        result.push_back (component);
+    }
+    return result;
+}
+
+// return the key of the given component
+template<class T>
+typename counter<T>::_key_t counter<T>::_key (const vector<size_t>& component) const {
+    const vartable_t& vartable = _manager.get_vartable ();
+    const valtable_t<T>& valtable = _manager.get_valtable ();
+    _key_t key;
+    for (auto var : component) {
+        key.push_back (var);
+        uint64_t word = 0;
+        for (auto j = vartable.get_first (var) ; j <= vartable.get_last (var) ; j++) {
+            size_t bit = (j - vartable.get_first (var)) % 64;
+            word |= uint64_t (valtable.get_status (j)) << bit;
+            if (bit == 63 || j == vartable.get_last (var)) {
+                key.push_back (word);
+                word = 0;
+            }
+        }
+    }
+    return key;
+}
+
+// return the number of solutions of the given unassigned variables
+template<class T>
+typename counter<T>::count_t counter<T>::_count (const vector<size_t>& vars) {
+
+    // if there are no variables, there is only one solution: the current
+    // assignment
+    if (vars.empty ()) {
+        return 1;
+    }
+
+    // otherwise, multiply the counts of all components. As soon as one has no
+    // solutions, the others are not counted
+    vector<vector<size_t>> components = _components (vars);
+    if (components.size () > 1) {
+        _nbsplits++;
+    }
+    count_t result = 1;
+    for (auto& component : components) {
+        result *= _count_component (component);
+        if (!result) {
+            break;
+        }
+    }
+    return result;
+}
+
+// return the number of solutions of the given connected component
+template<class T>
+typename counter<T>::count_t counter<T>::_count_component (const vector<size_t>& component) {
+
+    // first, look up the component in the cache
+    _key_t key;
+    if (_max_cache) {
+        key = _key (component);
+        auto it = _cache.find (key);
+        if (it != _cache.end ()) {
+            _nbhits++;
+            return it->second;
+        }
+    }
+
+    // otherwise, branch over the values of the variable with the smallest
+    // domain. The count is the sum of the counts of the remaining variables
+    // after every consistent assignment
+    const vartable_t& vartable = _manager.get_vartable ();
+    size_t var = component[0];
+    for (auto v : component) {
+        if (vartable.get_nbvalues (v) < vartable.get_nbvalues (var)) {
+            var = v;
+        }
+    }
+    vector<size_t> rest;
+    for (auto v : component) {
+        if (v != var) {
+            rest.push_back (v);
+        }
+    }
+    count_t result = 0;
+    for (auto value : _search.candidates (var)) {
+
+        // check the clock every once in a while. Once time is exhausted, the
+        // count is abandoned
+        if (_status == status_t::TIME_LIMIT ||
+            (!(++_nbnodes % 256) &&
+             chrono::duration<double> (chrono::steady_clock::now () - _start).count () >= _time_limit)) {
+            _status = status_t::TIME_LIMIT;
+            return result;
+        }
+        if (_search.push (value)) {
+            result += _count (rest);
+            _search.pop ();
+        }
+    }
+
+    // and cache it, unless time was exhausted in the meantime
+    if (_max_cache && _status != status_t::TIME_LIMIT) {
+        if (_cache.size () >= _max_cache) {
+            _cache.clear ();
+        }
+        _cache.emplace (key, result);
+    }
+    return result;
+}
+
+// count all solutions of the CSP task
+template<class T>
+status_t counter<T>::count () {
+
+    // initialize the count
+    _start = chrono::steady_clock::now ();
+    _status = status_t::UNKNOWN;
+    _nbsolutions = 0;
+    _nbnodes = _nbhits = _nbsplits = 0;
+    _cache.clear ();
+
+    // count the solutions of all variables, unless the root is found to be
+    // inconsistent
+    if (_search.open ()) {
+        vector<size_t> vars;
+        for (size_t i = 0 ; i < _manager.get_vartable ().size () ; i++) {
+            vars.push_back (i);
+        }
+        _nbsolutions = _count (vars);
+    }
+    if (_status == status_t::UNKNOWN) {
+        _status = _nbsolutions ? status_t::SATISFIABLE : status_t::UNSATISFIABLE;
+    }
+
+    // restore the manager to its state before the count
+    _search.close ();
+    _cache.clear ();
+    _elapsed = chrono::duration<double> (chrono::steady_clock::now () - _start).count ();
+    return _status;
+}
+
+#endif // _MUXCOUNTER_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,20 @@
+// -*- coding: utf-8 -*-
+// MUXenumerator.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <vie 27-08-2021 09:59:02.118634202 (1630051142)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Enumeration of the solutions of the CSP task defined in a manager. Note that
+// the enumerator is a template because it can act on values defined over any
+// type T
+
+#include "MUXenumerator.h"
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
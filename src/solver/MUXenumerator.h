@@ -0,0 +1,346 @@
+// -*- coding: utf-8 -*-
+// MUXenumerator.h
+// -----------------------------------------------------------------------------
+//
+// Started on <vie 27-08-2021 09:58:31.204815377 (1630051111)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Enumeration of the solutions of the CSP task defined in a manager, one at a
+// time, on top of the incremental services of backtracking
+
+#ifndef _MUXENUMERATOR_H_
+#define _MUXENUMERATOR_H_
+
+#include<limits>
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+#include "MUXbacktracking.h"
+#include "MUXmanager.h"
+#include "MUXvalorder.h"
+#include "MUXvarorder.h"
+
+using namespace std;
+
+// Class definition
+//
+// Definition of an enumerator of the solutions of the CSP task defined in a
+// manager. Solutions are computed one at a time with a depth-first search over
+// the manager itself, which is traversed with the incremental services of a
+// backtracking search (open/select/candidates/push/pop/close), so that the
+// current solution can be read directly from its table of variables without
+// copying it, and the propagation and the variable and value orderings of the
+// search are used. The search tree is stored in an explicit stack with the
+// candidate values of every assigned variable, so that memory does not depend
+// on the number of solutions. By default, assignments are propagated with
+// forward checking and variables with the smallest domain are selected first.
+// In case a projection is given, its variables are assigned first, in the
+// order they are given, and the rest with the variable ordering of the search.
+// Once a solution is found, the search resumes from the last variable in the
+// projection, so that the values of the other variables are those of one
+// solution extending it. Note that the enumerator is a template because it can
+// act on values defined over any type T. The default orderings are given in
+// the declaration of MUXmanager.h
+template<class T, class VarOrder, class ValOrder>
+class enumerator {
+
+    private:
+
+        struct _level_t {
+
+            // INVARIANT: every level of the search tree stores the candidate
+            // values of its variable, in the order given by the value
+            // ordering, and the next one to try
+            vector<size_t> _values;
+            size_t _next;
+        };
+
+        // INVARIANT: an enumerator acts over the CSP task defined in a
+        // manager, which is modified while enumerating and restored right
+        // after it, with the variables in the projection, and the maximum
+        // number of solutions to enumerate
+        manager<T>& _manager;
+        vector<size_t> _projection;
+        size_t _max_solutions;
+
+        // the search used to traverse the search tree, the levels currently
+        // being traversed, the number of solutions enumerated and whether the
+        // search has been opened, the last call to next found a solution or
+        // the enumeration is over
+        backtracking<T, VarOrder, ValOrder> _search;
+        vector<_level_t> _levels;
+        size_t _nbsolutions;
+        bool _opened;
+        bool _found;
+        bool _done;
+
+        // return the next variable to assign, i.e., the next one in the
+        // projection or, once all of them are assigned, the one selected by
+        // the variable ordering. If all have been already assigned,
+        // string::npos is returned
+        size_t _select () {
+            if (_search.depth () < _projection.size ()) {
+                return _projection[_search.depth ()];
+            }
+            return _search.select ();
+        }
+
+        // undo all assignments and finish the enumeration
+        void _finish () {
+            if (_opened) {
+                _search.close ();
+                _opened = false;
+            }
+            _levels.clear ();
+            _found = false;
+            _done = true;
+        }
+
+    public:
+
+        // The default constructor is strictly forbidden
+        enumerator () = delete;
+
+        // Explicit constructor - given the manager with the definition of the
+        // CSP task, the indices of the variables in the projection (if any)
+        // and the maximum number of solutions to enumerate. The search is
+        // opened with the first solution requested, so that it can be
+        // configured before
+        enumerator (manager<T>& mgr, const vector<size_t>& projection, const size_t max_solutions) :
+            _manager { mgr },
+            _projection { vector<size_t>() },
+            _max_solutions { max_solutions },
+            _search { backtracking<T, VarOrder, ValOrder> (mgr) },
+            _levels { vector<_level_t>() },
+            _nbsolutions { 0 },
+            _opened { false },
+            _found { false },
+            _done { false }
+        {
+
+            // verify the projection, removing duplicates, and make sure no
+            // variable has been assigned yet
+            const vartable_t& vartable = _manager.get_vartable ();
+            vector<bool> projected (vartable.size (), false);
+            for (auto var : projection) {
+                if (var >= vartable.size ()) {
+                    throw invalid_argument ("[enumerator::enumerator] Wrong projection");
+                }
+                if (!projected[var]) {
+                    projected[var] = true;
+                    _projection.push_back (var);
+                }
+            }
+            for (size_t i = 0 ; i < vartable.size () ; i++) {
+                if (vartable.get_value (i) != string::npos) {
+                    throw runtime_error ("[enumerator::enumerator] Variables can not be assigned before enumerating");
+                }
+            }
+            _search.set_propagation (propagation_t::FORWARD_CHECKING);
+        }
+
+        // Enumerators can not be copied
+        enumerator (const enumerator&) = delete;
+
+        // the manager is restored when the enumerator is destroyed
+        ~enumerator () {
+            _finish ();
+        }
+
+        // accessors
+
+        // return the value assigned to the i-th variable in the current
+        // solution
+        size_t get_value (const size_t i) const {
+            return _manager.get_vartable ().get_value (i);
+        }
+
+        // return the table of variables with the current solution
+        const vartable_t& get_vartable () const {
+            return _manager.get_vartable ();
+        }
+
+        // return the number of solutions enumerated so far
+        size_t get_nbsolutions () const {
+            return _nbsolutions;
+        }
+
+        // return true if the enumeration is over
+        bool done () const {
+            return _done;
+        }
+
+        // modifiers
+
+        // return the search used to traverse the search tree so that its
+        // propagation and orderings can be configured before requesting the
+        // first solution
+        backtracking<T, VarOrder, ValOrder>& get_search () {
+            return _search;
+        }
+
+        // compute the next solution and return true, or return false if there
+        // are no more solutions or the maximum number of solutions has been
+        // reached, in which case the manager is restored. The manager is
+        // frozen with the first call if it was not yet
+        bool next ();
+
+        // Class definition
+        //
+        // Input iterator over the solutions of an enumerator, which are
+        // computed as the iterator is incremented. Dereferencing it returns
+        // the table of variables with the current solution
+        class iterator {
+
+            private:
+
+                // INVARIANT: an iterator refers to an enumerator, or it is
+                // null if it is past the last solution
+                enumerator* _enumerator;
+
+            public:
+
+                explicit iterator (enumerator* e) :
+                    _enumerator { e }
+                {}
+
+                const vartable_t& operator* () const {
+                    return _enumerator->get_vartable ();
+                }
+                iterator& operator++ () {
+                    if (!_enumerator->next ()) {
+                        _enumerator = nullptr;
+                    }
+                    return *this;
+                }
+                bool operator== (const iterator& right) const {
+                    return _enumerator == right._enumerator;
+                }
+                bool operator!= (const iterator& right) const {
+                    return !((*this) == right);
+                }
+        };
+
+        // iterators. Beginning an iteration computes the next solution
+        iterator begin () {
+            return iterator (next () ? this : nullptr);
+        }
+        iterator end () {
+            return iterator (nullptr);
+        }
+};
+
+// compute the next solution
+template<class T, class VarOrder, class ValOrder>
+bool enumerator<T, VarOrder, ValOrder>::next () {
+
+    // if the enumeration is over, or the maximum number of solutions has been
+    // reached, there is nothing else to do
+    if (_done) {
+        return false;
+    }
+    if (_nbsolutions >= _max_solutions) {
+        _finish ();
+        return false;
+    }
+
+    // the first call opens the search and creates the root of the search
+    // tree, unless the root is inconsistent. Tasks without variables have
+    // only one solution, the empty assignment
+    if (!_opened) {
+        _opened = true;
+        if (!_search.open ()) {
+            _finish ();
+            return false;
+        }
+        size_t var = _select ();
+        if (var == string::npos) {
+            _nbsolutions++;
+            _found = true;
+            return true;
+        }
+        _levels.push_back (_level_t {_search.candidates (var), 0});
+    }
+
+    // if the last call found a solution, undo all assignments down to the last
+    // variable in the projection, and the assignment of that variable as well.
+    // With no projection, only the last assignment is undone
+    if (_found) {
+        size_t depth = _projection.empty () ? _levels.size () : _projection.size ();
+        while (_levels.size () > depth) {
+            _search.pop ();
+            _levels.pop_back ();
+        }
+        if (depth) {
+            _search.pop ();
+        }
+        _found = false;
+    }
+
+    while (!_levels.empty ()) {
+
+        // get the next candidate value of the variable at the current level.
+        // In case there is none, backtrack to the previous level undoing its
+        // assignment
+        _level_t& level = _levels.back ();
+        if (level._next == level._values.size ()) {
+            _levels.pop_back ();
+            if (!_levels.empty ()) {
+                _search.pop ();
+            }
+            continue;
+        }
+
+        // assign it, which is undone by the search if it is inconsistent
+        if (!_search.push (level._values[level._next++])) {
+            continue;
+        }
+
+        // and proceed with the next variable. If all have been already
+        // assigned, a solution has been found
+        size_t var = _select ();
+        if (var == string::npos) {
+            _nbsolutions++;
+            _found = true;
+            return true;
+        }
+        _levels.push_back (_level_t {_search.candidates (var), 0});
+    }
+
+    // at this point, all solutions have been enumerated
+    _finish ();
+    return false;
+}
+
+// return an enumerator of the solutions of the CSP task with the default
+// orderings
+template<class T>
+enumerator<T> manager<T>::solutions (const vector<size_t>& projection, const size_t max_solutions) {
+    return enumerator<T> (*this, projection, max_solutions);
+}
+
+// invoke the given function with the table of variables of every solution of
+// the CSP task
+template<class T>
+template<typename Function>
+size_t manager<T>::for_each_solution (Function func, const vector<size_t>& projection,
+                                      const size_t max_solutions) {
+    enumerator<T> e (*this, projection, max_solutions);
+    while (e.next ()) {
+        if (!func (e.get_vartable ())) {
+            break;
+        }
+    }
+    return e.get_nbsolutions ();
+}
+
+#endif // _MUXENUMERATOR_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
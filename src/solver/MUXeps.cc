@@ -0,0 +1,20 @@
+// -*- coding: utf-8 -*-
+// MUXeps.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <mié 25-08-2021 09:48:03.760214518 (1629877683)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Embarrassingly parallel search (EPS) over the CSP task defined in a manager.
+// Note that the search is a template because it can act on values defined over
+// any type T
+
+#include "MUXeps.h"
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
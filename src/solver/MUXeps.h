@@ -0,0 +1,487 @@
+// -*- coding: utf-8 -*-
+// MUXeps.h
+// -----------------------------------------------------------------------------
+//
+// Started on <mié 25-08-2021 09:47:21.338560129 (1629877641)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Embarrassingly parallel search (EPS) over the CSP task defined in a manager:
+// the task is statically decomposed into many subproblems which are solved
+// independently by a pool of workers
+
+#ifndef _MUXEPS_H_
+#define _MUXEPS_H_
+
+#include<atomic>
+#include<chrono>
+#include<cstdint>
+#include<exception>
+#include<limits>
+#include<mutex>
+#include<stdexcept>
+#include<string>
+#include<thread>
+#include<vector>
+
+#include "MUXbacktracking.h"
+#include "MUXmanager.h"
+
+using namespace std;
+
+// Class definition
+//
+// Definition of an embarrassingly parallel search. First, the search tree is
+// expanded breadth-first, one level at a time, until there are at least a given
+// number of consistent partial assignments (subproblems), or all of them are
+// complete. Every subproblem is described only by the values assigned from the
+// root to it. Next, a pool of workers takes subproblems in order from a shared
+// atomic counter. Every worker runs over its own copy of the frozen manager,
+// which shares its table of mutexes, and solves every subproblem from scratch,
+// i.e., restoring its copy and reinitializing its orderings before replaying
+// the values of the subproblem. Thus, the outcome of every subproblem does not
+// depend on the worker solving it nor on the order in which they are solved,
+// so that results are reproducible: the search either returns the first
+// solution of the first satisfiable subproblem, as sequential search would,
+// or counts all of them. Note that the search is a template because it can act
+// on values defined over any type T, and subproblems are generated and solved
+// with the given ordering strategies
+template<class T, class VarOrder = varorder_lex_t, class ValOrder = valorder_lex_t>
+class eps {
+
+    private:
+
+        // every subproblem is the sequence of values assigned from the root
+        // to a node of the search tree
+        typedef vector<size_t> _subproblem_t;
+
+        // INVARIANT: an embarrassingly parallel search acts over the CSP task
+        // defined in a manager, which is never modified, with a number of
+        // workers, the minimum number of subproblems to generate per worker,
+        // and the propagation performed after every assignment
+        manager<T>& _manager;
+        size_t _nbworkers;
+        size_t _ratio;
+        propagation_t _propagation;
+
+        // maximum time allowed (in seconds)
+        double _time_limit;
+
+        // outcome of the last search: its status, the first solution found (if
+        // any), the number of solutions found and some statistics
+        status_t _status;
+        vector<size_t> _solution;
+        size_t _nbsolutions;
+        size_t _nbnodes;
+        size_t _depth;
+        double _elapsed;
+
+        // subproblems of the last search, and shared state of the workers:
+        // the index of the next subproblem to solve, the number of solutions
+        // found, the index of the first satisfiable subproblem found so far
+        // (whose solution is protected with a mutex), a flag raised when time
+        // is exhausted and another one raised to stop all workers when any
+        // raises an exception
+        vector<_subproblem_t> _subproblems;
+        atomic<size_t> _next;
+        atomic<size_t> _solutions;
+        atomic<size_t> _first;
+        mutex _mutex;
+        atomic<bool> _timeout;
+        atomic<bool> _stop;
+
+        // undo the assignments of the given search beyond the longest prefix
+        // shared with the given subproblem, and replay the rest of its values.
+        // The values currently assigned are given in current. It returns false
+        // if any of them is found to be inconsistent and true otherwise
+        static bool _replay (backtracking<T, VarOrder, ValOrder>& search,
+                             vector<size_t>& current, const _subproblem_t& subproblem) {
+            size_t k = 0;
+            while (k < current.size () && k < subproblem.size () && current[k] == subproblem[k]) {
+                k++;
+            }
+            while (current.size () > k) {
+                search.pop ();
+                current.pop_back ();
+            }
+            for ( ; k < subproblem.size () ; k++) {
+                if (!search.push (subproblem[k])) {
+                    return false;
+                }
+                current.push_back (subproblem[k]);
+            }
+            return true;
+        }
+
+        // generate at least the given number of subproblems, unless all
+        // consistent partial assignments are complete before
+        void _decompose (const size_t target, const chrono::steady_clock::time_point& start);
+
+        // solve the i-th subproblem with the given search over the given copy
+        // of the manager, which has been already opened. If all is false,
+        // only its first solution is computed, which is recorded if this is
+        // the first satisfiable subproblem found so far; otherwise, all its
+        // solutions are counted. It returns the number of solutions found
+        size_t _solve (backtracking<T, VarOrder, ValOrder>& search, const manager<T>& mgr,
+                       const size_t i, const bool all,
+                       const chrono::steady_clock::time_point& start);
+
+        // decompose the CSP task and solve all subproblems
+        status_t _run (const bool all);
+
+    public:
+
+        // The default constructor is strictly forbidden
+        eps () = delete;
+
+        // Explicit constructor - given the manager with the definition of the
+        // CSP task to solve. By default, there is one worker per hardware
+        // thread, with 30 subproblems per worker, no propagation and no limit
+        // on time. Note that implicit casting is forbidden
+        explicit eps (manager<T>& mgr) :
+            _manager { mgr },
+            _nbworkers { max (size_t (1), size_t (thread::hardware_concurrency ())) },
+            _ratio { 30 },
+            _propagation { propagation_t::BACKTRACKING },
+            _time_limit { numeric_limits<double>::max () },
+            _status { status_t::UNKNOWN },
+            _solution { vector<size_t>() },
+            _nbsolutions { 0 },
+            _nbnodes { 0 },
+            _depth { 0 },
+            _elapsed { 0.0 },
+            _subproblems { vector<_subproblem_t>() },
+            _next { 0 },
+            _solutions { 0 },
+            _first { string::npos },
+            _timeout { false },
+            _stop { false }
+        {}
+
+        // Searches can not be copied
+        eps (const eps&) = delete;
+
+        // accessors
+
+        // return the status of the last search
+        status_t get_status () const {
+            return _status;
+        }
+
+        // return the first solution found in the last search, if any. When
+        // counting solutions, it is always empty
+        const vector<size_t>& get_solution () const {
+            return _solution;
+        }
+
+        // return the number of solutions found in the last search
+        size_t get_nbsolutions () const {
+            return _nbsolutions;
+        }
+
+        // return the overall number of nodes expanded while decomposing the
+        // task and by all workers, including the assignments replayed
+        size_t get_nbnodes () const {
+            return _nbnodes;
+        }
+
+        // return the subproblems generated in the last search
+        const vector<vector<size_t>>& get_subproblems () const {
+            return _subproblems;
+        }
+
+        // return the depth of the decomposition of the last search, i.e., the
+        // number of values of the longest subproblem
+        size_t get_depth () const {
+            return _depth;
+        }
+
+        // return the time elapsed in the last search in seconds
+        double get_elapsed () const {
+            return _elapsed;
+        }
+
+        // return the number of workers
+        size_t get_nbworkers () const {
+            return _nbworkers;
+        }
+
+        // return the minimum number of subproblems generated per worker
+        size_t get_ratio () const {
+            return _ratio;
+        }
+
+        // return the propagation performed after every assignment
+        propagation_t get_propagation () const {
+            return _propagation;
+        }
+
+        // modifiers
+
+        // set the number of workers, which has to be positive
+        void set_nbworkers (const size_t nbworkers) {
+            if (!nbworkers) {
+                throw invalid_argument ("[eps::set_nbworkers] Wrong number of workers");
+            }
+            _nbworkers = nbworkers;
+        }
+
+        // set the minimum number of subproblems generated per worker, which
+        // has to be positive
+        void set_ratio (const size_t ratio) {
+            if (!ratio) {
+                throw invalid_argument ("[eps::set_ratio] Wrong ratio");
+            }
+            _ratio = ratio;
+        }
+
+        // set the propagation performed after every assignment
+        void set_propagation (const propagation_t propagation) {
+            _propagation = propagation;
+        }
+
+        // set the maximum time allowed in seconds
+        void set_time_limit (const double limit) {
+            _time_limit = limit;
+        }
+
+        // search for the first solution of the CSP task. The manager is frozen
+        // if it was not yet, and it is never modified. It returns SATISFIABLE
+        // if a solution was found, UNSATISFIABLE if there is none, and
+        // TIME_LIMIT if time was exhausted
+        status_t solve () {
+            return _run (false);
+        }
+
+        // count all solutions of the CSP task. It returns SATISFIABLE if there
+        // is at least one solution, UNSATISFIABLE if there is none, and
+        // TIME_LIMIT if time was exhausted, in which case the number of
+        // solutions is only a lower bound
+        status_t count () {
+            return _run (true);
+        }
+};
+
+// generate at least the given number of subproblems, unless all consistent
+// partial assignments are complete before
+template<class T, class VarOrder, class ValOrder>
+void eps<T, VarOrder, ValOrder>::_decompose (const size_t target,
+                                             const chrono::steady_clock::time_point& start) {
+
+    // start with the root, unless it is found to be inconsistent. This also
+    // freezes the manager
+    backtracking<T, VarOrder, ValOrder> search (_manager);
+    search.set_propagation (_propagation);
+    _subproblems.clear ();
+    if (search.open ()) {
+        _subproblems.push_back (_subproblem_t ());
+    }
+
+    // expand all subproblems one level at a time, keeping only the consistent
+    // ones, until there are enough. Complete assignments are kept as they are
+    vector<size_t> current;
+    bool expanded = true;
+    while (expanded && _subproblems.size () < target &&
+           chrono::duration<double> (chrono::steady_clock::now () - start).count () < _time_limit) {
+        vector<_subproblem_t> next;
+        expanded = false;
+        for (auto& subproblem : _subproblems) {
+            _replay (search, current, subproblem);
+            size_t var = search.select ();
+            if (var == string::npos) {
+                next.push_back (subproblem);
+                continue;
+            }
+            expanded = true;
+            for (auto value : search.candidates (var)) {
+                if (search.push (value)) {
+                    search.pop ();
+                    next.push_back (subproblem);
+                    next.back ().push_back (value);
+                }
+            }
+        }
+        _subproblems.swap (next);
+    }
+
+    // if time was exhausted, no subproblem is solved at all
+    if (expanded && _subproblems.size () < target) {
+        _timeout.store (true);
+    }
+
+    // restore the manager
+    search.close ();
+    _nbnodes += search.get_nbnodes ();
+}
+
+// solve the i-th subproblem with the given search
+template<class T, class VarOrder, class ValOrder>
+size_t eps<T, VarOrder, ValOrder>::_solve (backtracking<T, VarOrder, ValOrder>& search,
+                                           const manager<T>& mgr, const size_t i, const bool all,
+                                           const chrono::steady_clock::time_point& start) {
+
+    // replay the values of the subproblem. They are known to be consistent
+    vector<size_t> current;
+    _replay (search, current, _subproblems[i]);
+
+    // and traverse the subtree below it depth-first, with the values of the
+    // variable assigned at every level still to try
+    struct _frame_t {
+        vector<size_t> _values;
+        size_t _next;
+    };
+    size_t result = 0;
+    vector<_frame_t> stack;
+    size_t var = search.select ();
+    if (var == string::npos) {
+        result++;
+    } else {
+        stack.push_back (_frame_t {search.candidates (var), 0});
+    }
+    size_t iteration = 0;
+    while (!stack.empty ()) {
+
+        // check the clock every once in a while. When only the first solution
+        // is computed, give up as well once a satisfiable subproblem before
+        // this one has been found, as it can not change the result anymore,
+        // and also if all workers have been stopped
+        if (!(++iteration % 256)) {
+            if (chrono::duration<double> (chrono::steady_clock::now () - start).count () >= _time_limit) {
+                _timeout.store (true);
+                return result;
+            }
+            if ((!all && i > _first.load ()) || _stop.load ()) {
+                return result;
+            }
+        }
+
+        // if there are no more values to try at this level, backtrack unless
+        // this subproblem can not change the result anymore
+        _frame_t& frame = stack.back ();
+        if (frame._next == frame._values.size ()) {
+            if (!all && i > _first.load ()) {
+                return result;
+            }
+            stack.pop_back ();
+            if (!stack.empty ()) {
+                search.pop ();
+            }
+            continue;
+        }
+
+        // otherwise try the next value and proceed with the next variable,
+        // unless it is inconsistent or a solution has been found
+        if (!search.push (frame._values[frame._next++])) {
+            continue;
+        }
+        var = search.select ();
+        if (var != string::npos) {
+            stack.push_back (_frame_t {search.candidates (var), 0});
+            continue;
+        }
+        result++;
+        if (!all) {
+            break;
+        }
+        search.pop ();
+    }
+
+    // if only the first solution is computed, record it if this is the first
+    // satisfiable subproblem found so far
+    if (result && !all) {
+        lock_guard<mutex> lock (_mutex);
+        if (i < _first.load ()) {
+            _first.store (i);
+            const vartable_t& vartable = mgr.get_vartable ();
+            _solution.clear ();
+            for (size_t j = 0 ; j < vartable.size () ; j++) {
+                _solution.push_back (vartable.get_value (j));
+            }
+        }
+    }
+    return result;
+}
+
+// decompose the CSP task and solve all subproblems
+template<class T, class VarOrder, class ValOrder>
+status_t eps<T, VarOrder, ValOrder>::_run (const bool all) {
+
+    // initialize the search
+    auto start = chrono::steady_clock::now ();
+    _solution.clear ();
+    _nbsolutions = _nbnodes = _depth = 0;
+    _next.store (0);
+    _solutions.store (0);
+    _first.store (string::npos);
+    _timeout.store (false);
+    _stop.store (false);
+
+    // decompose the task into subproblems
+    _decompose (_nbworkers * _ratio, start);
+    for (auto& subproblem : _subproblems) {
+        _depth = max (_depth, subproblem.size ());
+    }
+
+    // run every worker in a separate thread over its own copy of the frozen
+    // manager. All copies share the same table of mutexes. Subproblems are
+    // taken in order, and those beyond the first satisfiable subproblem found
+    // are skipped when looking for the first solution only. Any worker raising
+    // an exception stops all the others, and it is rethrown once all threads
+    // are done
+    vector<manager<T>> replicas (_nbworkers, _manager);
+    vector<size_t> nbnodes (_nbworkers, 0);
+    vector<exception_ptr> errors (_nbworkers, nullptr);
+    vector<thread> threads;
+    for (size_t w = 0 ; w < _nbworkers ; w++) {
+        threads.emplace_back ([&, w] {
+            try {
+                backtracking<T, VarOrder, ValOrder> search (replicas[w]);
+                search.set_propagation (_propagation);
+                for (size_t i = _next.fetch_add (1) ;
+                     i < _subproblems.size () && i < _first.load () && !_timeout.load () && !_stop.load () ;
+                     i = _next.fetch_add (1)) {
+                    search.open ();
+                    _solutions.fetch_add (_solve (search, replicas[w], i, all, start));
+                    nbnodes[w] += search.get_nbnodes ();
+                    search.close ();
+                }
+            } catch (...) {
+                errors[w] = current_exception ();
+                _stop.store (true);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join ();
+    }
+    for (auto& error : errors) {
+        if (error) {
+            rethrow_exception (error);
+        }
+    }
+
+    // and collect the results
+    _nbsolutions = _solutions.load ();
+    for (size_t w = 0 ; w < _nbworkers ; w++) {
+        _nbnodes += nbnodes[w];
+    }
+    if (_timeout.load () && (all || _first.load () == string::npos)) {
+        _status = status_t::TIME_LIMIT;
+    } else {
+        _status = _nbsolutions ? status_t::SATISFIABLE : status_t::UNSATISFIABLE;
+    }
+    if (!all) {
+        _nbsolutions = _nbsolutions ? 1 : 0;
+    }
+    _elapsed = chrono::duration<double> (chrono::steady_clock::now () - start).count ();
+    return _status;
+}
+
+#endif // _MUXEPS_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
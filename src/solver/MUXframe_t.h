@@ -69,6 +69,12 @@ class frame_t {
             return *this;
         }
 
+        // remove all actions from the frame. Note the memory allocated for
+        // them is kept so that it can be reused
+        void clear () {
+            _frame.clear ();
+        }
+
         // capacity
 
         // return the number of actions in this frame
@@ -0,0 +1,20 @@
+// -*- coding: utf-8 -*-
+// MUXlocalsearch.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 30-08-2021 09:48:02.104937261 (1630309682)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Incomplete local search over the CSP task defined in a manager with
+// min-conflicts moves, tabu tenure, random walk and restarts. Note that the
+// search is a template because it can act on values defined over any type T
+
+#include "MUXlocalsearch.h"
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,414 @@
+// -*- coding: utf-8 -*-
+// MUXlocalsearch.h
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 30-08-2021 09:47:35.662381504 (1630309655)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Incomplete local search over the CSP task defined in a manager with
+// min-conflicts moves, tabu tenure, random walk and restarts
+
+#ifndef _MUXLOCALSEARCH_H_
+#define _MUXLOCALSEARCH_H_
+
+#include<chrono>
+#include<cstdint>
+#include<limits>
+#include<random>
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+#include "MUXbacktracking.h"
+#include "MUXmanager.h"
+
+using namespace std;
+
+// Class definition
+//
+// Definition of a local search. Every variable is assigned a value at all times
+// in the table of variables of the manager, so that the search moves from one
+// full assignment to another by changing the value of one variable (a flip).
+// The number of conflicts of every value, i.e., the number of values currently
+// assigned which are mutex with it, is maintained incrementally: a flip only
+// traverses the mutexes of the old and the new value, so that it takes time
+// linear in their degree. The variables whose value has at least one conflict
+// are kept in a separate set. Every flip picks one of them at random and, with
+// the probability of the random walk, assigns it a random value; otherwise, it
+// assigns the value with the fewest conflicts (breaking ties at random) among
+// those which are not tabu, i.e., which were not abandoned in the last flips.
+// Tabu values are still allowed if they improve the best assignment found so
+// far (aspiration). The search is restarted from a random assignment after a
+// number of flips, and it finishes as soon as an assignment without conflicts
+// is found or its budget of flips or time is exhausted. As it is incomplete,
+// it never proves that a CSP task is unsatisfiable. Note that the search is a
+// template because it can act on values defined over any type T
+template<class T>
+class localsearch {
+
+    private:
+
+        // INVARIANT: a local search acts over the CSP task defined in a
+        // manager, whose variables are assigned during the search and
+        // restored right after it
+        manager<T>& _manager;
+
+        // tabu tenure (in flips), probability of a random walk, number of
+        // flips between restarts (zero meaning no restarts) and seed of the
+        // random generator
+        size_t _tenure;
+        double _walk;
+        size_t _restart;
+        uint64_t _seed;
+
+        // budgets of the search: the maximum number of flips and the maximum
+        // time allowed (in seconds)
+        size_t _flip_limit;
+        double _time_limit;
+
+        // outcome of the last search: its status, the best assignment found
+        // with the index of the value assigned to every variable, its number
+        // of violated mutexes and some statistics
+        status_t _status;
+        vector<size_t> _solution;
+        size_t _nbviolations;
+        size_t _nbflips;
+        size_t _nbrestarts;
+        double _elapsed;
+
+        // state of the search: the number of conflicts of every value, the
+        // number of mutexes violated by the current assignment, the variables
+        // whose value has conflicts along with the position of every variable
+        // in it (or string::npos), the flip until which every value is tabu
+        // and the random generator
+        vector<size_t> _conflicts;
+        size_t _violations;
+        vector<size_t> _conflicted;
+        vector<size_t> _position;
+        vector<size_t> _tabu;
+        mt19937_64 _generator;
+
+        // add or remove the given variable from the set of conflicted
+        // variables according to the conflicts of its value
+        void _update (const size_t var);
+
+        // assign the given value to its variable, which might be unassigned,
+        // updating the conflicts of all values mutex with the old and new
+        // values
+        void _flip (const size_t value);
+
+        // assign a random value to every variable
+        void _randomize ();
+
+        // return the value to assign to the given variable
+        size_t _select (const size_t var);
+
+    public:
+
+        // The default constructor is strictly forbidden
+        localsearch () = delete;
+
+        // Explicit constructor - given the manager with the definition of the
+        // CSP task. By default, the tabu tenure is 10 flips, random walks are
+        // performed with probability 0.02, the search is restarted every
+        // million flips, and there is no limit on flips or time. Note that
+        // implicit casting is forbidden
+        explicit localsearch (manager<T>& mgr) :
+            _manager { mgr },
+            _tenure { 10 },
+            _walk { 0.02 },
+            _restart { 1'000'000 },
+            _seed { 0 },
+            _flip_limit { numeric_limits<size_t>::max () },
+            _time_limit { numeric_limits<double>::max () },
+            _status { status_t::UNKNOWN },
+            _solution { vector<size_t>() },
+            _nbviolations { numeric_limits<size_t>::max () },
+            _nbflips { 0 },
+            _nbrestarts { 0 },
+            _elapsed { 0.0 },
+            _conflicts { vector<size_t>() },
+            _violations { 0 },
+            _conflicted { vector<size_t>() },
+            _position { vector<size_t>() },
+            _tabu { vector<size_t>() },
+            _generator { mt19937_64() }
+        {}
+
+        // Searches can not be copied
+        localsearch (const localsearch&) = delete;
+
+        // accessors
+
+        // return the status of the last search
+        status_t get_status () const {
+            return _status;
+        }
+
+        // return the best assignment found in the last search, which is a
+        // solution only if the search was successful
+        const vector<size_t>& get_solution () const {
+            return _solution;
+        }
+
+        // return the number of mutexes violated by the best assignment found
+        // in the last search
+        size_t get_nbviolations () const {
+            return _nbviolations;
+        }
+
+        // return the number of flips performed in the last search
+        size_t get_nbflips () const {
+            return _nbflips;
+        }
+
+        // return the number of restarts performed in the last search
+        size_t get_nbrestarts () const {
+            return _nbrestarts;
+        }
+
+        // return the time elapsed in the last search in seconds
+        double get_elapsed () const {
+            return _elapsed;
+        }
+
+        // return the tabu tenure in flips
+        size_t get_tenure () const {
+            return _tenure;
+        }
+
+        // return the probability of a random walk
+        double get_walk () const {
+            return _walk;
+        }
+
+        // return the number of flips between restarts
+        size_t get_restart () const {
+            return _restart;
+        }
+
+        // modifiers
+
+        // set the tabu tenure in flips. If it is zero, no value is tabu
+        void set_tenure (const size_t tenure) {
+            _tenure = tenure;
+        }
+
+        // set the probability of a random walk, which has to be in [0, 1]
+        void set_walk (const double walk) {
+            if (walk < 0.0 || walk > 1.0) {
+                throw invalid_argument ("[localsearch::set_walk] Wrong probability");
+            }
+            _walk = walk;
+        }
+
+        // set the number of flips between restarts. If it is zero, the search
+        // is never restarted
+        void set_restart (const size_t restart) {
+            _restart = restart;
+        }
+
+        // set the seed of the random generator
+        void set_seed (const uint64_t seed) {
+            _seed = seed;
+        }
+
+        // set the maximum number of flips
+        void set_flip_limit (const size_t limit) {
+            _flip_limit = limit;
+        }
+
+        // set the maximum time allowed in seconds
+        void set_time_limit (const double limit) {
+            _time_limit = limit;
+        }
+
+        // search for a solution of the CSP task. The manager is frozen if it
+        // was not yet. It returns SATISFIABLE if a solution was found, and
+        // NODE_LIMIT or TIME_LIMIT if the budget of flips or time was
+        // exhausted, in which case the best assignment found is not a
+        // solution. In all cases, the manager is restored to its state before
+        // the search
+        status_t solve ();
+};
+
+// add or remove the given variable from the set of conflicted variables
+template<class T>
+void localsearch<T>::_update (const size_t var) {
+    bool conflicted = _conflicts[_manager.get_vartable ().get_value (var)] > 0;
+    if (conflicted && _position[var] == string::npos) {
+        _position[var] = _conflicted.size ();
+        _conflicted.push_back (var);
+    } else if (!conflicted && _position[var] != string::npos) {
+        _position[_conflicted.back ()] = _position[var];
+        _conflicted[_position[var]] = _conflicted.back ();
+        _conflicted.pop_back ();
+        _position[var] = string::npos;
+    }
+}
+
+// assign the given value to its variable
+template<class T>
+void localsearch<T>::_flip (const size_t value) {
+    const mutextable_t& mutextable = *_manager.get_mutextable ();
+    const vartable_t& vartable = _manager.get_vartable ();
+    size_t var = mutextable.get_var (value);
+    size_t old = vartable.get_value (var);
+
+    // first, the old value is not assigned anymore, so that its mutexes lose
+    // one conflict. Other variables whose value loses its last conflict are
+    // not conflicted anymore
+    if (old != string::npos) {
+        _violations -= _conflicts[old];
+        mutextable.for_each (old, [&] (const size_t j) {
+            size_t other = mutextable.get_var (j);
+            if (!--_conflicts[j] && vartable.get_value (other) == j) {
+                _update (other);
+            }
+        });
+    }
+
+    // next, the new value is assigned, so that its mutexes gain one conflict.
+    // Other variables whose value gets its first conflict become conflicted
+    _manager.set_var_value (var, value, old);
+    mutextable.for_each (value, [&] (const size_t j) {
+        size_t other = mutextable.get_var (j);
+        if (!_conflicts[j]++ && vartable.get_value (other) == j) {
+            _update (other);
+        }
+    });
+    _violations += _conflicts[value];
+    _update (var);
+}
+
+// assign a random value to every variable
+template<class T>
+void localsearch<T>::_randomize () {
+    const vartable_t& vartable = _manager.get_vartable ();
+    for (size_t i = 0 ; i < vartable.size () ; i++) {
+        size_t n = 1 + vartable.get_last (i) - vartable.get_first (i);
+        _flip (vartable.get_first (i) + _generator () % n);
+    }
+}
+
+// return the value to assign to the given variable
+template<class T>
+size_t localsearch<T>::_select (const size_t var) {
+    const vartable_t& vartable = _manager.get_vartable ();
+    size_t current = vartable.get_value (var);
+    size_t first = vartable.get_first (var), last = vartable.get_last (var);
+
+    // with the probability of a random walk, return any other value
+    if (first < last && uniform_real_distribution<double> (0.0, 1.0) (_generator) < _walk) {
+        size_t value = first + _generator () % (last - first);
+        return (value >= current) ? value + 1 : value;
+    }
+
+    // otherwise, return the value with the fewest conflicts which is not
+    // tabu, unless it improves the best assignment found so far. Ties are
+    // broken at random with reservoir sampling
+    size_t result = current, best = numeric_limits<size_t>::max (), ties = 0;
+    for (auto j = first ; j <= last ; j++) {
+        if (j == current ||
+            (_tabu[j] > _nbflips &&
+             _violations - _conflicts[current] + _conflicts[j] >= _nbviolations)) {
+            continue;
+        }
+        if (_conflicts[j] < best) {
+            result = j;
+            best = _conflicts[j];
+            ties = 1;
+        } else if (_conflicts[j] == best && !(_generator () % ++ties)) {
+            result = j;
+        }
+    }
+    return result;
+}
+
+// search for a solution of the CSP task
+template<class T>
+status_t localsearch<T>::solve () {
+
+    // initialize the search
+    auto start = chrono::steady_clock::now ();
+    _manager.freeze ();
+    const vartable_t& vartable = _manager.get_vartable ();
+    _status = status_t::UNKNOWN;
+    _solution.clear ();
+    _nbviolations = numeric_limits<size_t>::max ();
+    _nbflips = _nbrestarts = 0;
+    _conflicts = vector<size_t> (_manager.get_valtable ().size (), 0);
+    _violations = 0;
+    _conflicted.clear ();
+    _position = vector<size_t> (vartable.size (), string::npos);
+    _tabu = vector<size_t> (_manager.get_valtable ().size (), 0);
+    _generator.seed (_seed);
+
+    // start from a random assignment
+    _randomize ();
+    size_t since = 0;
+    while (true) {
+
+        // record the current assignment if it is the best one so far
+        if (_violations < _nbviolations) {
+            _nbviolations = _violations;
+            _solution.clear ();
+            for (size_t i = 0 ; i < vartable.size () ; i++) {
+                _solution.push_back (vartable.get_value (i));
+            }
+        }
+
+        // stop as soon as a solution is found or the budget is exhausted,
+        // checking the clock only every once in a while
+        if (!_violations) {
+            _status = status_t::SATISFIABLE;
+            break;
+        }
+        if (_nbflips >= _flip_limit) {
+            _status = status_t::NODE_LIMIT;
+            break;
+        }
+        if (!(_nbflips % 256) &&
+            chrono::duration<double> (chrono::steady_clock::now () - start).count () >= _time_limit) {
+            _status = status_t::TIME_LIMIT;
+            break;
+        }
+
+        // restart from a new random assignment after a number of flips
+        if (_restart && since >= _restart) {
+            _randomize ();
+            since = 0;
+            _nbrestarts++;
+            continue;
+        }
+
+        // otherwise, flip the value of a conflicted variable chosen at random.
+        // The abandoned value becomes tabu
+        size_t var = _conflicted[_generator () % _conflicted.size ()];
+        size_t old = vartable.get_value (var);
+        size_t value = _select (var);
+        if (value != old) {
+            _flip (value);
+            _tabu[old] = _nbflips + 1 + _tenure;
+        }
+        _nbflips++;
+        since++;
+    }
+
+    // restore the manager to its state before the search
+    for (size_t i = 0 ; i < vartable.size () ; i++) {
+        _manager.set_var_value (i, string::npos, vartable.get_value (i));
+    }
+    _elapsed = chrono::duration<double> (chrono::steady_clock::now () - start).count ();
+    return _status;
+}
+
+#endif // _MUXLOCALSEARCH_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -14,20 +14,38 @@
 #ifndef _MUXMANAGER_H_
 #define _MUXMANAGER_H_
 
+#include<atomic>
+#include<exception>
+#include<limits>
 #include<memory>
 #include<set>
+#include<stdexcept>
 #include<string>
+#include<thread>
+#include<type_traits>
+#include<utility>
 #include<vector>
 
-#include "../structs/MUXmultivector_t.h"
+#include "../structs/MUXcosttable_t.h"
+#include "../structs/MUXmultibmap_t.h"
+#include "../structs/MUXmutextable_t.h"
 #include "../structs/MUXvaltable_t.h"
 #include "../structs/MUXvalue_t.h"
 #include "../structs/MUXvariable_t.h"
 #include "../structs/MUXvartable_t.h"
+#include "../solver/MUXpredicates.h"
 #include "../solver/MUXsstack_t.h"
+#include "../solver/MUXtrail_t.h"
 
 using namespace std;
 
+// enumerators of solutions are defined in MUXenumerator.h, which has to be
+// included to enumerate solutions. By default, they select variables with the
+// smallest domain first and try values in lexicographic order
+class varorder_dom_t;
+class valorder_lex_t;
+template<class T, class VarOrder = varorder_dom_t, class ValOrder = valorder_lex_t> class enumerator;
+
 // Class deffinition
 //
 // Base definition of a manager. Note that the manager is a template because in
@@ -52,10 +70,29 @@ class manager {
         // assigned to each variable
         vartable_t _vartable;
 
-        // Information about mutexes and whether some values are enabled or not is
-        // stored in a multivector. Because multivectors can not be created by
-        // default, they are stored as a pointer
-        unique_ptr<multivector_t> _multivector;
+        // Information about mutexes is stored in a table of mutexes which
+        // stores the mutexes between the values of every pair of variables
+        // either as a bit matrix (if they are dense) or in adjacency lists.
+        // Because tables of mutexes can not be created by default, they are
+        // stored as a pointer. Once frozen, it is never modified, so that it is
+        // shared among all copies of this manager
+        shared_ptr<mutextable_t> _mutextable;
+
+        // Costs of soft constraints are stored separately in a table of costs,
+        // which is created only when the first soft constraint is posted.
+        // As the table of mutexes, it is shared among all copies of this
+        // manager once frozen
+        shared_ptr<costtable_t> _costtable;
+
+        // minimum ratio between the number of mutexes between the values of
+        // two variables and the size of the cross product of their domains
+        // for storing them as a bit matrix. By default, it is the ratio where
+        // bit matrices take the same memory than adjacency lists
+        double _density;
+
+        // number of threads used to evaluate the constraints posted over
+        // large domains. If it is one, constraints are always posted serially
+        size_t _nbthreads;
 
         // the following private function performs a binary search over the
         // table of variables to determine the variable a specific value belongs
@@ -90,13 +127,325 @@ class manager {
             return mid;
         }
 
+        // return the cost of every combination of values of the variables
+        // index1 and index2 computed with the given function, if it is
+        // positive, along with the indices of both values. An exception is
+        // raised if any cost is negative
+        template<typename Handler>
+        vector<pair<pair<size_t, size_t>, size_t>> _eval_soft_constraint (Handler& func, const size_t index1,
+                                                                         const size_t index2) const {
+            vector<pair<pair<size_t, size_t>, size_t>> costs;
+            for (auto i = _vartable.get_first (index1) ; i <= _vartable.get_last (index1) ; i++) {
+                for (auto j = _vartable.get_first (index2) ; j <= _vartable.get_last (index2) ; j++) {
+                    auto cost = (func) (_valtable[i], _valtable[j]);
+                    if (cost < 0) {
+                        throw invalid_argument ("[manager::add_soft_constraint] Negative cost");
+                    }
+                    if (cost > 0) {
+                        costs.push_back ({{i, j}, size_t (cost)});
+                    }
+                }
+            }
+            return costs;
+        }
+
+        // store the given costs, computed with _eval_soft_constraint, in the
+        // table of costs, which is created if it does not exist yet
+        void _store_costs (const vector<pair<pair<size_t, size_t>, size_t>>& costs) {
+            if (!_costtable) {
+                _costtable = make_shared<costtable_t> (_valtable.size ());
+            }
+            for (auto& cost : costs) {
+                _costtable->add (cost.first.first, cost.first.second, cost.second);
+            }
+        }
+
+        // store the cost of every combination of values of the variables
+        // index1 and index2 computed with the given function in the table of
+        // costs. All costs are computed before storing any, so that the table
+        // of costs is left untouched if any is negative
+        template<typename Handler>
+        void _add_soft_constraint (Handler func, const size_t index1, const size_t index2) {
+            _store_costs (_eval_soft_constraint (func, index1, index2));
+        }
+
+        // return true if the given handler can be evaluated in batches, i.e.,
+        // over one value and a contiguous array of values of another variable
+        // (see predicate_t in MUXpredicates.h)
+        template<typename Handler>
+        static constexpr bool _batch () {
+            return is_invocable<Handler&, const T&, const T*, size_t, uint64_t*>::value;
+        }
+
+        // evaluate the given function over the values in the rows [lo, hi) of
+        // the bit matrix of mutexes between the variables index1 and index2,
+        // i.e., over the values first1+lo to first1+hi-1 of the first
+        // variable. Mutexes are set in the given bit matrix, and the number
+        // of mutexes of every value of both variables is added to the given
+        // vectors. It returns the number of mutexes found
+        template<typename Handler>
+        size_t _post_rows (Handler& func, const size_t index1, const size_t index2,
+                           const size_t lo, const size_t hi, multibmap_t& mutexes,
+                           vector<size_t>& nbmutexes1, vector<size_t>& nbmutexes2) const {
+            size_t first1 = _vartable.get_first (index1);
+            size_t first2 = _vartable.get_first (index2);
+            size_t n2 = 1 + _vartable.get_last (index2) - first2;
+            size_t result = 0;
+
+            // batch handlers are invoked once per value of the first variable
+            // with all values of the second one, which are exported only once.
+            // Every bit not set in the mask returned is a mutex. Other
+            // handlers are invoked once per pair of values
+            if constexpr (_batch<Handler> ()) {
+                vector<T> values2 = _valtable.get_values (first2, first2 + n2 - 1);
+                vector<uint64_t> mask ((n2 + 63)/64, 0);
+                for (size_t i = lo ; i < hi ; i++) {
+                    (func) (_valtable[first1 + i], values2.data (), n2, mask.data ());
+                    for (size_t w = 0 ; w < mask.size () ; w++) {
+                        uint64_t word = ~mask[w];
+                        if (64*(w + 1) > n2) {
+                            word &= (uint64_t (1) << (n2%64)) - 1;
+                        }
+                        for ( ; word ; word &= word - 1) {
+                            size_t j = 64*w + __builtin_ctzll (word);
+                            mutexes.set (i, first2%64 + j, true);
+                            nbmutexes1[i]++;
+                            nbmutexes2[j]++;
+                            result++;
+                        }
+                    }
+                }
+            } else {
+                for (size_t i = lo ; i < hi ; i++) {
+                    for (size_t j = 0 ; j < n2 ; j++) {
+
+                        // if the constraint returns false, then a mutex has
+                        // been found. Note this solver only allows mutexes
+                        // which are reflexive
+                        if (!(func) (_valtable[first1 + i], _valtable[first2 + j])) {
+                            mutexes.set (i, first2%64 + j, true);
+                            nbmutexes1[i]++;
+                            nbmutexes2[j]++;
+                            result++;
+                        }
+                    }
+                }
+            }
+            return result;
+        }
+
+        // return whether the given number of mutexes between two variables with
+        // n1 and n2 values has to be stored as a bit matrix
+        bool _dense (const size_t nbmutexes, const size_t n1, const size_t n2) const {
+            return double (nbmutexes) >= _density * double (n1) * double (n2);
+        }
+
+        // update the number of mutexes of all values of the variables index1
+        // and index2 and register the mutexes found (if any) in the table of
+        // mutexes using the representation suggested by their density
+        //
+        // WARNING! adding constraints again over the same set of variables
+        // previously used but with different orderings counts the same mutexes
+        // twice until the manager is frozen!
+        void _register (const size_t index1, const size_t index2, const multibmap_t& mutexes,
+                        const vector<size_t>& nbmutexes1, const vector<size_t>& nbmutexes2,
+                        const size_t nbmutexes) {
+            size_t first1 = _vartable.get_first (index1);
+            size_t first2 = _vartable.get_first (index2);
+            for (size_t i = 0 ; i < nbmutexes1.size () ; i++) {
+                if (nbmutexes1[i]) {
+                    _valtable.increment_nbmutexes (first1 + i, nbmutexes1[i]);
+                }
+            }
+            for (size_t j = 0 ; j < nbmutexes2.size () ; j++) {
+                if (nbmutexes2[j]) {
+                    _valtable.increment_nbmutexes (first2 + j, nbmutexes2[j]);
+                }
+            }
+            if (nbmutexes) {
+                _mutextable->add (index1, index2, mutexes,
+                                  _dense (nbmutexes, nbmutexes1.size (), nbmutexes2.size ()));
+            }
+        }
+
+        // invoke the given function with every index in [0, n) using the
+        // threads of this manager, every one taking the next index not
+        // processed yet. If any invocation raises an exception, no other index
+        // is taken and the exception is rethrown once all threads are done
+        template<typename Function>
+        void _run (const size_t n, Function func) const {
+            atomic<size_t> next { 0 };
+            vector<exception_ptr> errors (min (_nbthreads, n), nullptr);
+            auto worker = [&] (const size_t t) {
+                try {
+                    for (auto k = next++ ; k < n ; k = next++) {
+                        func (k);
+                    }
+                } catch (...) {
+                    errors[t] = current_exception ();
+                    next = n;
+                }
+            };
+            if (errors.size () > 1) {
+                vector<thread> threads;
+                for (size_t t = 0 ; t < errors.size () ; t++) {
+                    threads.emplace_back (worker, t);
+                }
+                for (auto& thread : threads) {
+                    thread.join ();
+                }
+            } else if (n) {
+                worker (0);
+            }
+            for (auto& error : errors) {
+                if (error) {
+                    rethrow_exception (error);
+                }
+            }
+        }
+
+        // post the constraints between all the given pairs of variables, where
+        // the handler of the k-th constraint is given by get (k). Constraints
+        // are soft if soft is true and hard otherwise. See add_constraints and
+        // add_soft_constraints
+        template<bool soft, typename Getter>
+        void _add_constraints (Getter get, const vector<pair<size_t, size_t>>& pairs) {
+
+            // first, verify that all constraints are correct and that the
+            // manager has not been frozen yet
+            for (auto& vars : pairs) {
+                if (vars.first >= _vartable.size () || vars.second >= _vartable.size ()) {
+                    throw invalid_argument ("[manager::add_constraints] Unregistered variable");
+                }
+                if (vars.first == vars.second) {
+                    throw invalid_argument {"[manager::add_constraints] Constraints can not be defined over the same variable"};
+                }
+            }
+            if (frozen ()) {
+                throw runtime_error ("[manager::add_constraints] It is forbidden to add constraints after freezing the manager!");
+            }
+            if (pairs.empty ()) {
+                return;
+            }
+
+            // the costs of soft constraints are computed in parallel, every
+            // one in its own buffer, and stored in the table of costs in the
+            // same order of the constraints only once all have been computed
+            if constexpr (soft) {
+                vector<vector<pair<pair<size_t, size_t>, size_t>>> costs (pairs.size ());
+                _run (pairs.size (), [&] (const size_t k) {
+                    costs[k] = _eval_soft_constraint (get (k), pairs[k].first, pairs[k].second);
+                });
+                for (auto& buffer : costs) {
+                    _store_costs (buffer);
+                }
+                return;
+            }
+            if (!_mutextable) {
+                _mutextable = shared_ptr<mutextable_t>{new mutextable_t (_vartable)};
+            }
+
+            // allocate the number of mutexes of the values of both variables
+            // of every constraint. Mutexes are kept either as a bit matrix, if
+            // they are dense, or as a list with the positions of every mutex in
+            // the bit matrix otherwise, so that memory is bounded by the size
+            // of the table of mutexes
+            vector<multibmap_t> mutexes (pairs.size (), multibmap_t (0, 0));
+            vector<vector<pair<uint32_t, uint32_t>>> lists (pairs.size ());
+            vector<vector<size_t>> nbmutexes1, nbmutexes2;
+            vector<size_t> nbmutexes (pairs.size (), 0);
+            for (auto& vars : pairs) {
+                nbmutexes1.emplace_back (1 + _vartable.get_last (vars.first) - _vartable.get_first (vars.first), 0);
+                nbmutexes2.emplace_back (1 + _vartable.get_last (vars.second) - _vartable.get_first (vars.second), 0);
+            }
+
+            // evaluate all constraints. Every thread takes the next constraint
+            // not evaluated yet, and stores its mutexes in its own bit matrix,
+            // so that the result does not depend on the number of threads.
+            // Bit matrices of sparse constraints are released right after
+            // evaluating them
+            _run (pairs.size (), [&] (const size_t k) {
+                size_t n1 = nbmutexes1[k].size (), n2 = nbmutexes2[k].size ();
+                multibmap_t matrix (n1, _vartable.get_first (pairs[k].second)%64 + n2);
+                nbmutexes[k] = _post_rows (get (k), pairs[k].first, pairs[k].second, 0, n1,
+                                           matrix, nbmutexes1[k], nbmutexes2[k]);
+                if (_dense (nbmutexes[k], n1, n2)) {
+                    mutexes[k] = move (matrix);
+                    return;
+                }
+                lists[k].reserve (nbmutexes[k]);
+                for (size_t i = 0 ; i < n1 ; i++) {
+                    brow_t row = matrix[i];
+                    for (auto j = row.find_first () ; j != string::npos ; j = row.find_next (j)) {
+                        lists[k].push_back ({uint32_t (i), uint32_t (j)});
+                    }
+                }
+            });
+
+            // next, count the mutexes of every value which are stored in
+            // adjacency lists and reserve room for them
+            vector<size_t> degrees (_valtable.size (), 0);
+            for (size_t k = 0 ; k < pairs.size () ; k++) {
+                if (!nbmutexes[k] ||
+                    _dense (nbmutexes[k], nbmutexes1[k].size (), nbmutexes2[k].size ())) {
+                    continue;
+                }
+                size_t first1 = _vartable.get_first (pairs[k].first);
+                size_t first2 = _vartable.get_first (pairs[k].second);
+                for (size_t i = 0 ; i < nbmutexes1[k].size () ; i++) {
+                    degrees[first1 + i] += nbmutexes1[k][i];
+                }
+                for (size_t j = 0 ; j < nbmutexes2[k].size () ; j++) {
+                    degrees[first2 + j] += nbmutexes2[k][j];
+                }
+            }
+            _mutextable->reserve (degrees);
+
+            // and finally register all mutexes in the same order of the
+            // constraints, releasing every bit matrix and list as soon as
+            // possible. The bit matrices of sparse constraints are rebuilt one
+            // at a time from their lists
+            for (size_t k = 0 ; k < pairs.size () ; k++) {
+                if (!lists[k].empty ()) {
+                    mutexes[k] = multibmap_t (nbmutexes1[k].size (),
+                                              _vartable.get_first (pairs[k].second)%64 + nbmutexes2[k].size ());
+                    for (auto& mutex : lists[k]) {
+                        mutexes[k].set (mutex.first, mutex.second, true);
+                    }
+                    lists[k] = vector<pair<uint32_t, uint32_t>> ();
+                }
+                _register (pairs[k].first, pairs[k].second, mutexes[k],
+                           nbmutexes1[k], nbmutexes2[k], nbmutexes[k]);
+                mutexes[k] = multibmap_t (0, 0);
+            }
+        }
+
     public:
 
-        // Managers can be created only by default
+        // Default constructor
         manager () :
             _valtable { valtable_t<T> () },
             _vartable { vartable_t () },
-            _multivector { nullptr }
+            _mutextable { nullptr },
+            _costtable { nullptr },
+            _density { 1.0/32 },
+            _nbthreads { 1 }
+        {}
+
+        // Copy constructor - the tables of variables and values are copied so
+        // that both managers can be modified independently, e.g., by searches
+        // running in different threads. A frozen table of mutexes is shared
+        // between them instead of being copied, because it is the largest
+        // structure and it is never modified anymore
+        manager (const manager<T>& other) :
+            _valtable { other._valtable },
+            _vartable { other._vartable },
+            _mutextable { (other._mutextable && !other._mutextable->frozen ()) ?
+                          make_shared<mutextable_t> (*other._mutextable) : other._mutextable },
+            _costtable { (other._costtable && !other._costtable->frozen ()) ?
+                         make_shared<costtable_t> (*other._costtable) : other._costtable },
+            _density { other._density },
+            _nbthreads { other._nbthreads }
         {}
 
         // Accessors
@@ -112,8 +461,53 @@ class manager {
         }
 
         // the following service is provided for testing purposes
-        const unique_ptr<multivector_t>& get_multivector () const {
-            return _multivector;
+        const shared_ptr<mutextable_t>& get_mutextable () const {
+            return _mutextable;
+        }
+
+        // return the table of costs of soft constraints, or nullptr if no soft
+        // constraint has been posted
+        const shared_ptr<costtable_t>& get_costtable () const {
+            return _costtable;
+        }
+
+        // return the overall cost of the given assignment of values to all
+        // variables, i.e., the sum of the costs of all pairs of values
+        // violating a soft constraint
+        size_t cost (const vector<size_t>& assignment) const {
+            size_t result = 0;
+            if (_costtable) {
+                for (size_t i = 0 ; i < assignment.size () ; i++) {
+                    for (auto& entry : (*_costtable)[assignment[i]]) {
+                        if (entry._value > assignment[i] &&
+                            assignment[val_to_var (entry._value)] == entry._value) {
+                            result += entry._cost;
+                        }
+                    }
+                }
+            }
+            return result;
+        }
+
+        // return the raw values of the domain of the given variable stored
+        // contiguously
+        vector<T> get_domain (const size_t var) const {
+            if (var >= _vartable.size ()) {
+                throw out_of_range ("[manager::get_domain] Out of bounds");
+            }
+            return _valtable.get_values (_vartable.get_first (var), _vartable.get_last (var));
+        }
+
+        // return the minimum density of the mutexes between two variables for
+        // storing them as a bit matrix
+        double get_density () const {
+            return _density;
+        }
+
+        // return the number of threads used to post constraints over large
+        // domains
+        size_t get_nbthreads () const {
+            return _nbthreads;
         }
 
         // return the variable a specific value belongs to. If the given index
@@ -144,7 +538,7 @@ class manager {
             // information on mutexes has not been created yet ---in other
             // words, to ensure that no add_constraint has been executed. If so,
             // it is forbidden to create new variables
-            if (_multivector) {
+            if (_mutextable || _costtable) {
                 throw runtime_error ("[manager::add_variable] It is forbidden to add variables after adding constraints!");
             }
 
@@ -183,10 +577,42 @@ class manager {
             _vartable.insert (variable, first, last);
         }
 
+        // set the minimum density of the mutexes between two variables for
+        // storing them as a bit matrix. It only affects constraints posted
+        // afterwards. Values larger than 1 disable bit matrices, and null
+        // values force all constraints to be stored as bit matrices
+        void set_density (const double density) {
+            _density = density;
+        }
+
+        // set the number of threads used to post constraints whose cross
+        // product of domains has at least 2^16 pairs of values. In this case,
+        // the function given to add_constraint is invoked concurrently from
+        // different threads, so that it has to be thread-safe. The mutexes
+        // posted are exactly the same regardless of the number of threads
+        void set_nbthreads (const size_t nbthreads) {
+            if (!nbthreads) {
+                throw invalid_argument ("[manager::set_nbthreads] Wrong number of threads");
+            }
+            _nbthreads = nbthreads;
+        }
+
         // add_constraint invokes the function given in first place over all
         // values of the domains of the given variables. Every combination of
         // values which makes the function to return false is stored as a mutex.
         //
+        // Functions can be also evaluated in batches, i.e., over one value of
+        // the first variable and all values of the second one at once, which
+        // are given contiguously as in get_domain. Such functions receive the
+        // value, a pointer to the values, their number n and a mask of
+        // (n+63)/64 words, whose j-th bit has to be set if and only if the
+        // value is compatible with the j-th one. Built-in predicates with
+        // vectorized batch evaluations are defined in MUXpredicates.h
+        //
+        // The density of the mutexes found, i.e., their number divided by the
+        // size of the cross product of both domains, determines whether they
+        // are stored as a bit matrix or in adjacency lists. See set_density
+        //
         // Mutexes are represented with functions that might be either
         // commutative or not. In case they are commutative, then a mutex could
         // be defined over the same variable, i.e., func (Xi, Xi). However, this
@@ -197,9 +623,14 @@ class manager {
         // strictly forbidden to invoke the same constraint over the same set of
         // variables with different orderings, i.e., add_constraint (func, Xi,
         // Xj) and add_constraint (func, Xj, Xi) are strictly equivalent and
-        // invoking both might cause unpredictable effects ---the reason being
-        // that the same mutexes are stored more than once, but the search
-        // algorithm should remove them only once
+        // invoking both stores the same mutexes more than once. Duplicates are
+        // removed only when the manager is frozen
+        //
+        // The result of the function is always interpreted as a boolean, even
+        // if it returns any other type. Soft constraints, whose functions
+        // return costs, are posted with add_soft_constraint instead
+        //
+        // Constraints can not be posted once the manager has been frozen
         template<typename Handler>
         void add_constraint (Handler func,
                              const variable_t& var1, const variable_t& var2) {
@@ -222,47 +653,230 @@ class manager {
                 throw invalid_argument {"[manager::add_constraint] Constraints can not be defined over the same variable"};
             }
 
-            // Next, in case the multivector storing all mutexes has not been
-            // created yet, do it now
-            if (!_multivector) {
+            // and also that the manager has not been frozen yet
+            if (frozen ()) {
+                throw runtime_error ("[manager::add_constraint] It is forbidden to add constraints after freezing the manager!");
+            }
+
+            // Next, in case the table storing all mutexes has not been created
+            // yet, do it now
+            if (!_mutextable) {
 
-                // the length of the multivector has to be strictly equal to the
-                // overall number of values registered in this manager
-                _multivector = unique_ptr<multivector_t>{new multivector_t (_valtable.size ())};
+                // the table of mutexes is created for the domains of all
+                // variables registered in this manager
+                _mutextable = shared_ptr<mutextable_t>{new mutextable_t (_vartable)};
             }
 
             // Now comes the fun: for all combination of values (a, b) in the
             // domains of each CSP variable, a in var1, b in var2, invoke the
-            // constraint
-            for (size_t i = _vartable.get_first(index1) ;
-                 i <= _vartable.get_last(index1) ;
-                 i++) {
-
-                for (size_t j = _vartable.get_first(index2) ;
-                     j <= _vartable.get_last(index2) ;
-                     j++) {
-
-                    // if the constraint returns false, then a mutex has been
-                    // found
-                    if (!(func) (_valtable[i], _valtable[j])) {
-
-                        // set this mutex in the multibitmap. Note this solver
-                        // only allows mutexes which are reflexive
-                        _multivector->set (i, j);
-                        _multivector->set (j, i);
-
-                        // and update the number of mutexes of these entries
-                        //
-                        // WARNING! adding constraints again over the same set
-                        // of variables previously used but with different
-                        // orderings would cause unpredictable effects!
-                        _valtable.increment_nbmutexes (i);
-                        _valtable.increment_nbmutexes (j);
+            // constraint. Mutexes are first recorded in a bit matrix aligned
+            // as required by the table of mutexes, and the number of mutexes
+            // of every value is counted separately
+            size_t first1 = _vartable.get_first (index1);
+            size_t first2 = _vartable.get_first (index2);
+            size_t n1 = 1 + _vartable.get_last (index1) - first1;
+            size_t n2 = 1 + _vartable.get_last (index2) - first2;
+            multibmap_t mutexes (n1, first2%64 + n2);
+            vector<size_t> nbmutexes1 (n1, 0), nbmutexes2 (n2, 0);
+            size_t nbmutexes = 0;
+
+            // large cross products are split into consecutive ranges of rows
+            // of the bit matrix, one per thread. Every thread sets the bits of
+            // its own rows, and counts the mutexes of the values of the second
+            // variable in its own vector, which are added up afterwards in
+            // the order of the threads. Thus, the result is exactly the same
+            // than the one computed serially
+            size_t nbthreads = min (_nbthreads, n1);
+            if (nbthreads > 1 && n1 * n2 >= (size_t (1) << 16)) {
+                vector<vector<size_t>> buffers (nbthreads, vector<size_t> (n2, 0));
+                vector<size_t> counts (nbthreads, 0);
+                vector<exception_ptr> errors (nbthreads, nullptr);
+                vector<thread> threads;
+                for (size_t t = 0 ; t < nbthreads ; t++) {
+                    threads.emplace_back ([&, t] {
+                        try {
+                            counts[t] = _post_rows (func, index1, index2,
+                                                    t * n1 / nbthreads, (t + 1) * n1 / nbthreads,
+                                                    mutexes, nbmutexes1, buffers[t]);
+                        } catch (...) {
+                            errors[t] = current_exception ();
+                        }
+                    });
+                }
+                for (auto& thread : threads) {
+                    thread.join ();
+                }
+
+                // exceptions raised by the function are rethrown here
+                for (auto& error : errors) {
+                    if (error) {
+                        rethrow_exception (error);
+                    }
+                }
+                for (size_t t = 0 ; t < nbthreads ; t++) {
+                    nbmutexes += counts[t];
+                    for (size_t j = 0 ; j < n2 ; j++) {
+                        nbmutexes2[j] += buffers[t][j];
                     }
                 }
+            } else {
+                nbmutexes = _post_rows (func, index1, index2, 0, n1,
+                                        mutexes, nbmutexes1, nbmutexes2);
             }
+
+            // finally, update the number of mutexes of all values and
+            // register the mutexes found (if any) in the table of mutexes
+            _register (index1, index2, mutexes, nbmutexes1, nbmutexes2, nbmutexes);
         }
 
+        // add_soft_constraint invokes the function given in first place over
+        // all values of the domains of the given variables, which returns the
+        // cost of every combination of values instead of a boolean. All
+        // combinations with a positive cost are stored in the table of costs
+        // instead of the table of mutexes, so that they are never considered
+        // by searches over hard constraints. The costs of the same pair of
+        // values in different constraints are added up. Negative costs are
+        // not allowed, and no cost is stored if any is negative. As with hard
+        // constraints, soft constraints can not be defined over the same
+        // variable nor posted once the manager has been frozen
+        template<typename Handler>
+        void add_soft_constraint (Handler func,
+                                  const variable_t& var1, const variable_t& var2) {
+
+            // verify the given variables exist and are different, and that
+            // the manager has not been frozen yet
+            size_t index1, index2;
+            try {
+                index1 = _vartable[var1.get_name ()];
+                index2 = _vartable[var2.get_name ()];
+            } catch (runtime_error e) {
+                throw invalid_argument ("[manager::add_soft_constraint] Unregistered variable");
+            }
+            if (index1 == index2) {
+                throw invalid_argument {"[manager::add_soft_constraint] Constraints can not be defined over the same variable"};
+            }
+            if (frozen ()) {
+                throw runtime_error ("[manager::add_soft_constraint] It is forbidden to add constraints after freezing the manager!");
+            }
+
+            // and store the costs of all combinations of values
+            _add_soft_constraint (func, index1, index2);
+        }
+
+        // add_constraints posts many constraints at once between the given
+        // pairs of variables, given by their indices, either with the same
+        // handler or with a different handler for each pair. It is equivalent
+        // to invoking add_constraint over every pair in the same order, but
+        // variables are not looked up by name, constraints are evaluated in
+        // parallel with the number of threads of this manager (see
+        // set_nbthreads), so that handlers have to be thread-safe, and the
+        // adjacency lists of all values are sized in advance to store all
+        // their mutexes without reallocations. Only the bit matrices of the
+        // constraints being evaluated and those of dense constraints are kept
+        // in memory at once, the mutexes of sparse constraints being kept in
+        // compact lists until they are posted. No constraint is posted if any
+        // pair is wrong or any handler raises an exception
+        template<typename Handler>
+        void add_constraints (Handler func, const vector<pair<size_t, size_t>>& pairs) {
+            _add_constraints<false> ([&func] (const size_t) -> Handler& {
+                return func;
+            }, pairs);
+        }
+        template<typename Handler>
+        void add_constraints (const vector<pair<Handler, pair<size_t, size_t>>>& constraints) {
+            vector<pair<size_t, size_t>> pairs;
+            pairs.reserve (constraints.size ());
+            for (auto& constraint : constraints) {
+                pairs.push_back (constraint.second);
+            }
+            _add_constraints<false> ([&constraints] (const size_t k) -> const Handler& {
+                return constraints[k].first;
+            }, pairs);
+        }
+
+        // add_soft_constraints posts many soft constraints at once between the
+        // given pairs of variables, given by their indices, as add_constraints
+        // does with hard constraints. It is equivalent to invoking
+        // add_soft_constraint over every pair in the same order, but costs are
+        // computed in parallel, so that handlers have to be thread-safe. No
+        // cost is stored if any pair is wrong, any cost is negative or any
+        // handler raises an exception
+        template<typename Handler>
+        void add_soft_constraints (Handler func, const vector<pair<size_t, size_t>>& pairs) {
+            _add_constraints<true> ([&func] (const size_t) -> Handler& {
+                return func;
+            }, pairs);
+        }
+        template<typename Handler>
+        void add_soft_constraints (const vector<pair<Handler, pair<size_t, size_t>>>& constraints) {
+            vector<pair<size_t, size_t>> pairs;
+            pairs.reserve (constraints.size ());
+            for (auto& constraint : constraints) {
+                pairs.push_back (constraint.second);
+            }
+            _add_constraints<true> ([&constraints] (const size_t k) -> const Handler& {
+                return constraints[k].first;
+            }, pairs);
+        }
+
+        // freeze the definition of the CSP task. Once frozen, no more
+        // constraints can be posted and the mutexes of every value are
+        // compacted into contiguous memory, sorted and deduplicated. Because
+        // duplicates are removed, the number of mutexes of every value is
+        // recomputed. Freezing a manager twice has no effect
+        void freeze () {
+
+            // in case no constraint was ever posted, create an empty table of
+            // mutexes so that the manager is consistently frozen
+            if (!_mutextable) {
+                _mutextable = shared_ptr<mutextable_t>{new mutextable_t (_vartable)};
+            }
+            if (_mutextable->frozen ()) {
+                return;
+            }
+
+            // compact the tables of mutexes and costs, and update the number
+            // of mutexes of each value
+            _mutextable->freeze ();
+            if (_costtable) {
+                _costtable->freeze ();
+            }
+            for (size_t i = 0 ; i < _valtable.size () ; i++) {
+                _valtable.set_nbmutexes (i, _mutextable->degree (i));
+            }
+        }
+
+        // return whether this manager has been frozen or not
+        bool frozen () const {
+            return _mutextable && _mutextable->frozen ();
+        }
+
+        // Solutions
+        //
+        // The following services are defined in MUXenumerator.h
+
+        // return an enumerator of the solutions of the CSP task, which are
+        // computed one at a time as they are requested with its service next
+        // or by iterating over it. If a projection is given as the indices of
+        // some variables, only solutions with different values of them are
+        // enumerated. At most max_solutions are enumerated. The manager is
+        // frozen if it was not yet, and it is restored once the enumeration
+        // ends or the enumerator is destroyed
+        enumerator<T> solutions (const vector<size_t>& projection = vector<size_t>(),
+                                 const size_t max_solutions = numeric_limits<size_t>::max ());
+
+        // invoke the given function with the table of variables of every
+        // solution of the CSP task, so that get_value (i) returns the value
+        // assigned to the i-th variable. Solutions are never copied. The
+        // enumeration stops as soon as the function returns false or
+        // max_solutions have been enumerated. If a projection is given, only
+        // solutions with different values of the given variables are
+        // enumerated. It returns the number of solutions enumerated
+        template<typename Function>
+        size_t for_each_solution (Function func,
+                                  const vector<size_t>& projection = vector<size_t>(),
+                                  const size_t max_solutions = numeric_limits<size_t>::max ());
+
         // Handlers
 
         // The following handler restores the number of feasible values of one
@@ -330,6 +944,30 @@ class manager {
             // and now update it
             _valtable.set_nbmutexes (i, prev);
         }
+
+        // The following service undoes a change recorded in a trail, i.e., it
+        // restores the previous number of feasible values of a variable, the
+        // previous value assigned to a variable, the previous status of a
+        // value or the previous number of feasible mutexes of a value. Unlike
+        // handlers, it does not check the current state
+        void undo (const opcode_t opcode, const size_t i, const size_t prev) {
+            switch (opcode) {
+                case opcode_t::VAR_NBVALUES:
+                    _vartable.set_nbvalues (i, prev);
+                    break;
+                case opcode_t::VAR_VALUE:
+                    _vartable.assign (i, prev);
+                    break;
+                case opcode_t::VAL_STATUS:
+                    _valtable.set_status (i, prev);
+                    break;
+                case opcode_t::VAL_NBMUTEXES:
+                    _valtable.set_nbmutexes (i, prev);
+                    break;
+                default:
+                    throw invalid_argument ("[manager::undo] Unknown opcode");
+            }
+        }
 };
 
 #endif // _MUXMANAGER_H_
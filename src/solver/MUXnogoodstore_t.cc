@@ -0,0 +1,56 @@
+// -*- coding: utf-8 -*-
+// MUXnogoodstore_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <sáb 21-08-2021 10:28:14.306815732 (1629534494)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// A store of nogoods, i.e., sets of values which can not be simultaneously
+// assigned to their variables. Nogoods are propagated with two watched
+// literals and they are deleted according to their activity
+
+#include "MUXnogoodstore_t.h"
+
+using namespace std;
+
+// rescale the activity of all nogoods when it grows too large
+void nogoodstore_t::_rescale () {
+    for (auto& nogood : _nogoods) {
+        nogood._activity *= 1e-100;
+    }
+    _increment *= 1e-100;
+}
+
+// add a new nogood with the given literals and return its index
+size_t nogoodstore_t::add (const vector<size_t>& literals) {
+
+    // first, make sure the nogood is not empty and all its literals are
+    // within bounds
+    if (literals.empty ()) {
+        throw invalid_argument ("[nogoodstore_t::add] Empty nogood");
+    }
+    for (auto literal : literals) {
+        if (literal >= _watches.size ()) {
+            throw out_of_range ("[nogoodstore_t::add] out of bounds");
+        }
+    }
+
+    // copy its literals to the arena and watch the first two
+    size_t i = _nogoods.size ();
+    _nogoods.push_back (_nogood_t {_arena.size (), uint32_t (literals.size ()), _increment});
+    for (auto literal : literals) {
+        _arena.push_back (literal);
+    }
+    for (size_t l = 0 ; l < min (size_t (2), literals.size ()) ; l++) {
+        _watches[literals[l]].push_back (i);
+    }
+    return i;
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,241 @@
+// -*- coding: utf-8 -*-
+// MUXnogoodstore_t.h
+// -----------------------------------------------------------------------------
+//
+// Started on <sáb 21-08-2021 10:27:33.912744016 (1629534453)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// A store of nogoods, i.e., sets of values which can not be simultaneously
+// assigned to their variables. Nogoods are propagated with two watched
+// literals and they are deleted according to their activity
+
+#ifndef _MUXNOGOODSTORE_T_H_
+#define _MUXNOGOODSTORE_T_H_
+
+#include<algorithm>
+#include<cstdint>
+#include<limits>
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+#include "../structs/MUXmultivector_t.h"
+
+// Class definition
+//
+// Definition of a store of nogoods. Every nogood is a set of literals, each
+// one being the index of a value, which is true when the value is assigned to
+// its variable. A nogood is violated when all its literals are true. The first
+// two literals of every nogood are watched, so that it is only visited when one
+// of them becomes true
+class nogoodstore_t {
+
+    private:
+
+        struct _nogood_t {
+
+            // INVARIANT: a nogood stores the location of its first literal in
+            // the arena, its number of literals and its activity
+            size_t _offset;
+            uint32_t _size;
+            double _activity;
+        };
+
+        // INVARIANT: the literals of all nogoods are stored contiguously in a
+        // single arena. For every value, the nogoods watching it are stored
+        // in a separate list
+        std::vector<_nogood_t> _nogoods;
+        std::vector<uint32_t> _arena;
+        std::vector<std::vector<uint32_t>> _watches;
+
+        // the activity of nogoods is bumped by an increment which grows
+        // geometrically every time it decays, so that recent conflicts weigh
+        // more
+        double _increment;
+        double _decay;
+
+        // rescale the activity of all nogoods when it grows too large
+        void _rescale ();
+
+    public:
+
+        // The default constructor is strictly forbidden
+        nogoodstore_t () = delete;
+
+        // Explicit constructor - given the number of values. Note that
+        // implicit casting is forbidden
+        explicit nogoodstore_t (const size_t nbvalues) :
+            _nogoods { std::vector<_nogood_t>() },
+            _arena { std::vector<uint32_t>() },
+            _watches { std::vector<std::vector<uint32_t>>(nbvalues, std::vector<uint32_t>()) },
+            _increment { 1.0 },
+            _decay { 0.999 }
+        {}
+
+        // default copy and move assignments
+        nogoodstore_t& operator=(const nogoodstore_t&) = default;
+        nogoodstore_t& operator=(nogoodstore_t&&) = default;
+
+        // accessors
+
+        // return the literals of the i-th nogood
+        multivector_t::row_t operator[] (const size_t i) const {
+            return multivector_t::row_t (_arena.data () + _nogoods[i]._offset,
+                                         _arena.data () + _nogoods[i]._offset + _nogoods[i]._size);
+        }
+
+        // return the activity of the i-th nogood
+        double get_activity (const size_t i) const {
+            return _nogoods[i]._activity;
+        }
+
+        // return the indices of all nogoods watching the given value
+        const std::vector<uint32_t>& get_watches (const size_t value) const {
+            return _watches[value];
+        }
+
+        // modifiers
+
+        // add a new nogood with the given literals and return its index. The
+        // first two literals are watched. Literals should be given so that
+        // the first one is not true and the second one is the last one to
+        // become not true when backtracking
+        size_t add (const std::vector<size_t>& literals);
+
+        // bump the activity of the i-th nogood
+        void bump (const size_t i) {
+            _nogoods[i]._activity += _increment;
+            if (_nogoods[i]._activity > 1e100) {
+                _rescale ();
+            }
+        }
+
+        // decay the activity of all nogoods
+        void decay () {
+            _increment /= _decay;
+        }
+
+        // visit all nogoods watching the given value once it has become true.
+        // The predicate istrue (literal) returns whether a literal is true or
+        // not. For every nogood, another literal which is not true is watched
+        // instead if possible. Otherwise, func (i, literal) is invoked with
+        // the index of the nogood and its only literal which is not true, or
+        // string::npos if all of them are true, i.e., if the nogood is
+        // violated. If func returns false, the propagation is stopped and
+        // false is returned; otherwise, it returns true
+        template<typename Predicate, typename Function>
+        bool propagate (const size_t value, Predicate istrue, Function func) {
+
+            std::vector<uint32_t>& watches = _watches[value];
+            size_t k = 0;
+            while (k < watches.size ()) {
+
+                // make sure the value is the first literal of this nogood
+                size_t i = watches[k];
+                uint32_t* literals = _arena.data () + _nogoods[i]._offset;
+                size_t size = _nogoods[i]._size;
+                if (size > 1 && literals[0] != value) {
+                    std::swap (literals[0], literals[1]);
+                }
+
+                // look for another literal which is not true and watch it
+                // instead
+                size_t l = 2;
+                while (l < size && istrue (literals[l])) {
+                    l++;
+                }
+                if (l < size) {
+                    std::swap (literals[0], literals[l]);
+                    _watches[literals[0]].push_back (i);
+                    watches[k] = watches.back ();
+                    watches.pop_back ();
+                    continue;
+                }
+
+                // otherwise, the nogood is either unit or violated
+                if (!func (i, (size > 1 && !istrue (literals[1])) ? literals[1] : std::string::npos)) {
+                    return false;
+                }
+                k++;
+            }
+            return true;
+        }
+
+        // remove nogoods until at most the given number remain. Nogoods for
+        // which the predicate locked (i) returns true are never removed and,
+        // among the others, those with the lowest activity are removed first.
+        // It returns a vector with the new index of every nogood, or
+        // string::npos if it was removed
+        template<typename Predicate>
+        std::vector<size_t> reduce (const size_t target, Predicate locked);
+
+        // capacity
+
+        // return the number of nogoods in this store
+        size_t size () const {
+            return _nogoods.size ();
+        }
+
+        // return the overall number of literals in this store
+        size_t nbliterals () const {
+            return _arena.size ();
+        }
+};
+
+// remove nogoods until at most the given number remain
+template<typename Predicate>
+std::vector<size_t> nogoodstore_t::reduce (const size_t target, Predicate locked) {
+
+    // sort the nogoods which can be removed in increasing order of activity
+    std::vector<size_t> candidates;
+    for (size_t i = 0 ; i < _nogoods.size () ; i++) {
+        if (!locked (i)) {
+            candidates.push_back (i);
+        }
+    }
+    std::sort (candidates.begin (), candidates.end (),
+               [&] (size_t i, size_t j) {
+                   return _nogoods[i]._activity < _nogoods[j]._activity;
+               });
+
+    // and mark as many as needed for removal
+    std::vector<size_t> remap (_nogoods.size (), 0);
+    for (size_t k = 0 ; k < candidates.size () && _nogoods.size () - k > target ; k++) {
+        remap[candidates[k]] = std::string::npos;
+    }
+
+    // compact the arena with the literals of the remaining ones and create
+    // their watches again
+    std::vector<_nogood_t> nogoods;
+    size_t offset = 0;
+    for (auto& watches : _watches) {
+        watches.clear ();
+    }
+    for (size_t i = 0 ; i < _nogoods.size () ; i++) {
+        if (remap[i] == std::string::npos) {
+            continue;
+        }
+        remap[i] = nogoods.size ();
+        std::copy (_arena.begin () + _nogoods[i]._offset,
+                   _arena.begin () + _nogoods[i]._offset + _nogoods[i]._size,
+                   _arena.begin () + offset);
+        nogoods.push_back (_nogood_t {offset, _nogoods[i]._size, _nogoods[i]._activity});
+        for (size_t l = 0 ; l < std::min (size_t (2), size_t (_nogoods[i]._size)) ; l++) {
+            _watches[_arena[offset + l]].push_back (remap[i]);
+        }
+        offset += _nogoods[i]._size;
+    }
+    _nogoods.swap (nogoods);
+    _arena.resize (offset);
+    return remap;
+}
+
+#endif // _MUXNOGOODSTORE_T_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,20 @@
+// -*- coding: utf-8 -*-
+// MUXportfolio.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 23-08-2021 09:35:52.117409823 (1629704152)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// A portfolio runs several backtracking searches with different configurations
+// in parallel over the same CSP task. Note that the portfolio is a template
+// because it can act on values defined over any type T
+
+#include "MUXportfolio.h"
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,259 @@
+// -*- coding: utf-8 -*-
+// MUXportfolio.h
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 23-08-2021 09:35:18.402691274 (1629704118)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// A portfolio runs several backtracking searches with different configurations
+// in parallel over the same CSP task, and stops as soon as one of them solves
+// it
+
+#ifndef _MUXPORTFOLIO_H_
+#define _MUXPORTFOLIO_H_
+
+#include<atomic>
+#include<chrono>
+#include<cstdint>
+#include<exception>
+#include<functional>
+#include<limits>
+#include<stdexcept>
+#include<string>
+#include<thread>
+#include<type_traits>
+#include<vector>
+
+#include "MUXbacktracking.h"
+#include "MUXmanager.h"
+
+using namespace std;
+
+// Class definition
+//
+// Definition of a portfolio of searches. Every configuration runs in a separate
+// thread over its own copy of the manager. Copies only duplicate the tables of
+// variables and values, because the table of mutexes is frozen and shared among
+// all of them. The first search which finds a solution or proves there is none
+// interrupts all the others. Note that the portfolio is a template because it
+// can act on values defined over any type T
+template<class T>
+class portfolio {
+
+    private:
+
+        struct _result_t {
+
+            // INVARIANT: the outcome of every search consists of its status,
+            // its solution (if any) and the number of nodes expanded
+            status_t _status;
+            vector<size_t> _solution;
+            size_t _nbnodes;
+        };
+
+        // every configuration is a function which solves the given manager
+        // with the given stop flag and time limit
+        typedef function<_result_t (manager<T>&, const atomic<bool>&, const double)> _config_t;
+
+        // INVARIANT: a portfolio acts over the CSP task defined in a manager,
+        // which is never modified, with a number of configurations
+        manager<T>& _manager;
+        vector<_config_t> _configs;
+
+        // maximum time allowed (in seconds) to every search
+        double _time_limit;
+
+        // outcome of the last search: its status, the solution found (if
+        // any), the index of the configuration which solved the task (or
+        // string::npos if none did) and some statistics
+        status_t _status;
+        vector<size_t> _solution;
+        size_t _winner;
+        size_t _nbnodes;
+        double _elapsed;
+
+    public:
+
+        // The default constructor is strictly forbidden
+        portfolio () = delete;
+
+        // Explicit constructor - given the manager with the definition of the
+        // CSP task to solve. Note that implicit casting is forbidden
+        explicit portfolio (manager<T>& mgr) :
+            _manager { mgr },
+            _configs { vector<_config_t>() },
+            _time_limit { numeric_limits<double>::max () },
+            _status { status_t::UNKNOWN },
+            _solution { vector<size_t>() },
+            _winner { string::npos },
+            _nbnodes { 0 },
+            _elapsed { 0.0 }
+        {}
+
+        // accessors
+
+        // return the status of the last search
+        status_t get_status () const {
+            return _status;
+        }
+
+        // return the solution found in the last search, if any
+        const vector<size_t>& get_solution () const {
+            return _solution;
+        }
+
+        // return the index of the configuration which solved the task in the
+        // last search, or string::npos if none did
+        size_t get_winner () const {
+            return _winner;
+        }
+
+        // return the overall number of nodes expanded by all searches
+        size_t get_nbnodes () const {
+            return _nbnodes;
+        }
+
+        // return the time elapsed in the last search in seconds
+        double get_elapsed () const {
+            return _elapsed;
+        }
+
+        // modifiers
+
+        // add a new configuration with the given variable and value
+        // orderings, propagation, backjumping, learning and restarts. The
+        // seed is used only by random value orderings
+        template<class VarOrder = varorder_lex_t, class ValOrder = valorder_lex_t>
+        void add (const propagation_t propagation, const bool backjumping=false,
+                  const bool learning=false, const restart_t restart=restart_t::NONE,
+                  const uint64_t seed=0) {
+            _configs.push_back ([=] (manager<T>& mgr, const atomic<bool>& stop, const double time_limit) {
+                backtracking<T, VarOrder, ValOrder> search (mgr);
+                search.set_propagation (propagation);
+                search.set_backjumping (backjumping);
+                search.set_learning (learning);
+                if (restart != restart_t::NONE) {
+                    search.set_restart (restart);
+                }
+                if constexpr (is_same<ValOrder, valorder_random_t>::value) {
+                    search.get_valorder ().set_seed (seed);
+                }
+                search.set_stop (&stop);
+                search.set_time_limit (time_limit);
+                search.solve ();
+                return _result_t {search.get_status (), search.get_solution (), search.get_nbnodes ()};
+            });
+        }
+
+        // add n diverse configurations, cycling over different orderings,
+        // propagations and seeds
+        void populate (const size_t n) {
+            for (size_t i = 0 ; i < n ; i++) {
+                switch (i % 4) {
+                    case 0:
+                        add<varorder_domwdeg_t, valorder_lex_t> (propagation_t::MAINTAINING_ARC_CONSISTENCY);
+                        break;
+                    case 1:
+                        add<varorder_domwdeg_t, valorder_random_t> (propagation_t::MAINTAINING_ARC_CONSISTENCY,
+                                                                    false, false, restart_t::LUBY, i);
+                        break;
+                    case 2:
+                        add<varorder_dom_t, valorder_minmutexes_t> (propagation_t::FORWARD_CHECKING, true, true);
+                        break;
+                    default:
+                        add<varorder_domddeg_t, valorder_random_t> (propagation_t::FORWARD_CHECKING,
+                                                                    true, true, restart_t::GEOMETRIC, i);
+                }
+            }
+        }
+
+        // set the maximum time allowed in seconds
+        void set_time_limit (const double limit) {
+            _time_limit = limit;
+        }
+
+        // run all configurations in parallel until one of them finds a
+        // solution or proves there is none. The manager is frozen if it was
+        // not yet, and it is never modified. If no configuration solves the
+        // task, the status of the first one is returned
+        status_t solve ();
+
+        // capacity
+
+        // return the number of configurations of this portfolio
+        size_t size () const {
+            return _configs.size ();
+        }
+};
+
+// run all configurations in parallel until one of them solves the task
+template<class T>
+status_t portfolio<T>::solve () {
+
+    // make sure there is at least one configuration
+    if (_configs.empty ()) {
+        throw runtime_error ("[portfolio::solve] No configurations");
+    }
+
+    // freeze the manager and create one copy of it for every configuration.
+    // All copies share the same table of mutexes
+    auto start = chrono::steady_clock::now ();
+    _manager.freeze ();
+    vector<manager<T>> replicas (_configs.size (), _manager);
+
+    // run every configuration in a separate thread. The first one to solve
+    // the task raises the stop flag, and so does any configuration raising an
+    // exception, which is rethrown once all threads are done
+    atomic<bool> stop {false};
+    atomic<size_t> winner {string::npos};
+    vector<_result_t> results (_configs.size ());
+    vector<exception_ptr> errors (_configs.size (), nullptr);
+    vector<thread> threads;
+    for (size_t i = 0 ; i < _configs.size () ; i++) {
+        threads.emplace_back ([&, i] {
+            try {
+                results[i] = _configs[i] (replicas[i], stop, _time_limit);
+            } catch (...) {
+                errors[i] = current_exception ();
+                stop.store (true);
+                return;
+            }
+            if (results[i]._status == status_t::SATISFIABLE ||
+                results[i]._status == status_t::UNSATISFIABLE) {
+                size_t expected = string::npos;
+                if (winner.compare_exchange_strong (expected, i)) {
+                    stop.store (true);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join ();
+    }
+    for (auto& error : errors) {
+        if (error) {
+            rethrow_exception (error);
+        }
+    }
+
+    // and collect the results
+    _winner = winner.load ();
+    _status = (_winner != string::npos) ? results[_winner]._status : results[0]._status;
+    _solution = (_winner != string::npos) ? results[_winner]._solution : vector<size_t>();
+    _nbnodes = 0;
+    for (auto& result : results) {
+        _nbnodes += result._nbnodes;
+    }
+    _elapsed = chrono::duration<double> (chrono::steady_clock::now () - start).count ();
+    return _status;
+}
+
+#endif // _MUXPORTFOLIO_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
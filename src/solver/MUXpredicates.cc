@@ -0,0 +1,21 @@
+// -*- coding: utf-8 -*-
+// MUXpredicates.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 31-08-2021 10:08:51.720046183 (1630397331)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Built-in constraints over arithmetic values which can be evaluated either
+// for one pair of values or for one value and a whole domain at once. Note that
+// predicates are templates because they can act on values of any arithmetic
+// type T
+
+#include "MUXpredicates.h"
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,249 @@
+// -*- coding: utf-8 -*-
+// MUXpredicates.h
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 31-08-2021 10:08:26.375518094 (1630397306)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Built-in constraints over arithmetic values which can be evaluated either
+// for one pair of values or for one value and a whole domain at once
+
+#ifndef _MUXPREDICATES_H_
+#define _MUXPREDICATES_H_
+
+#include<algorithm>
+#include<cstdint>
+#ifdef __AVX2__
+#include<immintrin.h>
+#endif
+#include<limits>
+#include<type_traits>
+
+// Class definition
+//
+// Base class of all built-in predicates. Every predicate can be invoked over a
+// pair of values, returning true if they are compatible as any other function
+// given to manager::add_constraint, but also over one value and n values of
+// another variable stored contiguously (see manager::get_domain), in which
+// case the j%64-th bit of the j/64-th word of the given mask is set if and only
+// if the given value is compatible with the j-th one. Bits beyond n are
+// ignored. Batch evaluations of predicates over 32-bit integers use AVX2 when
+// available. Arithmetic over integers is computed in a wider type, so that
+// predicates are exact over the whole range of T. Note that predicates are
+// templates because they can act on values of any arithmetic type T
+template<class T>
+class predicate_t {
+
+    static_assert (std::is_arithmetic<T>::value,
+                   "[predicate_t] Predicates are defined only over arithmetic types");
+
+    protected:
+
+        // type used to compute differences and sums of values, which can not
+        // overflow for integers
+        typedef typename std::conditional<!std::is_integral<T>::value, T,
+                                          typename std::conditional<(sizeof (T) < sizeof (int64_t)),
+                                                                    int64_t, __int128>::type>::type wide_t;
+
+        // evaluate the given test over n values and store their outcome in
+        // the mask. Every word is computed without branches, so that
+        // compilers can vectorize it
+        template<typename Test>
+        static void _batch (const T* values, const size_t n, uint64_t* mask, Test test) {
+            for (size_t w = 0 ; 64*w < n ; w++) {
+                const T* chunk = values + 64*w;
+                size_t m = std::min (size_t (64), n - 64*w);
+                uint64_t word = 0;
+                for (size_t j = 0 ; j < m ; j++) {
+                    word |= uint64_t (test (chunk[j])) << j;
+                }
+                mask[w] = word;
+            }
+        }
+
+#ifdef __AVX2__
+        // evaluate the given test over n 32-bit integers eight at a time, and
+        // the rest with the given scalar test. The vector test returns all
+        // bits set in the lanes of compatible values
+        template<typename VectorTest, typename Test>
+        static void _batch_avx2 (const int32_t* values, const size_t n, uint64_t* mask,
+                                 VectorTest vtest, Test test) {
+            size_t j = 0;
+            for ( ; j + 8 <= n ; j += 8) {
+                __m256i lanes = vtest (_mm256_loadu_si256 ((const __m256i*) (values + j)));
+                uint64_t bits = uint64_t (_mm256_movemask_ps (_mm256_castsi256_ps (lanes)));
+                if (!(j%64)) {
+                    mask[j/64] = 0;
+                }
+                mask[j/64] |= bits << (j%64);
+            }
+            for ( ; j < n ; j++) {
+                if (!(j%64)) {
+                    mask[j/64] = 0;
+                }
+                mask[j/64] |= uint64_t (test (values[j])) << (j%64);
+            }
+        }
+#endif
+};
+
+// Class definition
+//
+// Two values are compatible if and only if they are different
+template<class T>
+class predicate_neq_t : public predicate_t<T> {
+
+    public:
+
+        // evaluate one pair of values
+        bool operator() (const T& value1, const T& value2) const {
+            return value1 != value2;
+        }
+
+        // evaluate one value and n values of another variable
+        void operator() (const T& value1, const T* values, const size_t n, uint64_t* mask) const {
+            auto test = [value1] (const T value2) {
+                return value1 != value2;
+            };
+#ifdef __AVX2__
+            if constexpr (std::is_same<T, int32_t>::value) {
+                __m256i v1 = _mm256_set1_epi32 (value1);
+                predicate_t<T>::_batch_avx2 (values, n, mask, [v1] (__m256i v2) {
+                    return _mm256_xor_si256 (_mm256_cmpeq_epi32 (v1, v2), _mm256_set1_epi32 (-1));
+                }, test);
+                return;
+            }
+#endif
+            predicate_t<T>::_batch (values, n, mask, test);
+        }
+};
+
+// Class definition
+//
+// Two values are compatible if and only if their absolute difference is not k,
+// e.g., queens in different rows k apart can not be in the same diagonal
+template<class T>
+class predicate_absdiff_neq_t : public predicate_t<T> {
+
+    private:
+
+        typedef typename predicate_t<T>::wide_t wide_t;
+
+        // INVARIANT: the absolute difference forbidden
+        T _k;
+
+    public:
+
+        // The default constructor is strictly forbidden
+        predicate_absdiff_neq_t () = delete;
+
+        // Explicit constructor - given the absolute difference forbidden
+        explicit predicate_absdiff_neq_t (const T k) :
+            _k { k }
+        {}
+
+        // evaluate one pair of values
+        bool operator() (const T& value1, const T& value2) const {
+            wide_t w1 = value1, w2 = value2;
+            return ((w1 > w2) ? w1 - w2 : w2 - w1) != wide_t (_k);
+        }
+
+        // evaluate one value and n values of another variable
+        void operator() (const T& value1, const T* values, const size_t n, uint64_t* mask) const {
+            wide_t w1 = value1, k = _k;
+            auto test = [w1, k] (const T value2) {
+                wide_t w2 = value2;
+                return ((w1 > w2) ? w1 - w2 : w2 - w1) != k;
+            };
+#ifdef __AVX2__
+
+            // the vector test compares every value with value1-k and value1+k
+            // instead of computing their differences, which could overflow.
+            // Bounds which are not 32-bit integers are replaced with the other
+            // one, and there is at least one of them if k is not negative
+            if constexpr (std::is_same<T, int32_t>::value) {
+                if (k >= 0) {
+                    wide_t lo = w1 - k, hi = w1 + k;
+                    if (lo < std::numeric_limits<int32_t>::min ()) {
+                        lo = hi;
+                    }
+                    if (hi > std::numeric_limits<int32_t>::max ()) {
+                        hi = lo;
+                    }
+                    __m256i vlo = _mm256_set1_epi32 (int32_t (lo)), vhi = _mm256_set1_epi32 (int32_t (hi));
+                    predicate_t<T>::_batch_avx2 (values, n, mask, [vlo, vhi] (__m256i v2) {
+                        __m256i eq = _mm256_or_si256 (_mm256_cmpeq_epi32 (v2, vlo), _mm256_cmpeq_epi32 (v2, vhi));
+                        return _mm256_xor_si256 (eq, _mm256_set1_epi32 (-1));
+                    }, test);
+                    return;
+                }
+            }
+#endif
+            predicate_t<T>::_batch (values, n, mask, test);
+        }
+};
+
+// Class definition
+//
+// Two values are compatible if and only if their sum does not exceed c
+template<class T>
+class predicate_sum_leq_t : public predicate_t<T> {
+
+    private:
+
+        typedef typename predicate_t<T>::wide_t wide_t;
+
+        // INVARIANT: the maximum sum allowed
+        T _c;
+
+    public:
+
+        // The default constructor is strictly forbidden
+        predicate_sum_leq_t () = delete;
+
+        // Explicit constructor - given the maximum sum allowed
+        explicit predicate_sum_leq_t (const T c) :
+            _c { c }
+        {}
+
+        // evaluate one pair of values
+        bool operator() (const T& value1, const T& value2) const {
+            return wide_t (value1) + wide_t (value2) <= wide_t (_c);
+        }
+
+        // evaluate one value and n values of another variable
+        void operator() (const T& value1, const T* values, const size_t n, uint64_t* mask) const {
+            wide_t w1 = value1, c = _c;
+            auto test = [w1, c] (const T value2) {
+                return w1 + wide_t (value2) <= c;
+            };
+#ifdef __AVX2__
+
+            // the vector test compares every value with c-value1 instead of
+            // computing their sums, which could overflow. Bounds above the
+            // largest 32-bit integer are clamped, while those below the
+            // smallest one, where no value is compatible, use the scalar test
+            if constexpr (std::is_same<T, int32_t>::value) {
+                wide_t bound = std::min (c - w1, wide_t (std::numeric_limits<int32_t>::max ()));
+                if (bound >= std::numeric_limits<int32_t>::min ()) {
+                    __m256i vbound = _mm256_set1_epi32 (int32_t (bound));
+                    predicate_t<T>::_batch_avx2 (values, n, mask, [vbound] (__m256i v2) {
+                        return _mm256_xor_si256 (_mm256_cmpgt_epi32 (v2, vbound), _mm256_set1_epi32 (-1));
+                    }, test);
+                    return;
+                }
+            }
+#endif
+            predicate_t<T>::_batch (values, n, mask, test);
+        }
+};
+
+#endif // _MUXPREDICATES_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -32,14 +32,31 @@ class sstack_t {
     private:
 
         // INVARIANT: a stack consists just of a vector of frames which stand
-        // for all actions performed along a path during search
+        // for all actions performed along a path during search. Only the
+        // first _size frames are in the stack; the others were unwound and are
+        // kept (empty) so that their memory is reused by the next frames
         vector<frame_t> _sstack;
+        size_t _size;
+
+        // whether the frame at the top of the stack is open or not
+        bool _open;
+
+        // make room for a new frame at the top of the stack and return it.
+        // Frames previously unwound are reused if possible
+        frame_t& _push () {
+            if (_size == _sstack.size ()) {
+                _sstack.push_back (frame_t ());
+            }
+            return _sstack[_size++];
+        }
 
     public:
 
         // Default constructor - stacks are built by default
         sstack_t () :
-            _sstack { vector<frame_t>() }
+            _sstack { vector<frame_t>() },
+            _size { 0 },
+            _open { false }
         {}
 
         // Stacks can not be copy-constructed
@@ -47,32 +64,78 @@ class sstack_t {
 
         // modifiers
 
-        // inserts a new frame in the stack
+        // inserts a new frame in the stack. Note that the frame is copied
+        // into the memory of a frame previously unwound, if any
         sstack_t& operator+= (const frame_t& frame) {
-            _sstack.push_back (frame);
+
+            // frames can not be inserted while another one is open
+            if (_open) {
+                throw runtime_error ("[sstack_t::operator+=] A frame is open!");
+            }
+            _push () = frame;
             return *this;
         }
 
+        // open a new empty frame at the top of the stack and return it.
+        // Actions can be added straight to it, either directly or with
+        // operator+=, until it is closed. The reference returned is valid
+        // only until another frame is pushed
+        frame_t& open_frame () {
+
+            // only one frame can be open at the same time
+            if (_open) {
+                throw runtime_error ("[sstack_t::open_frame] A frame is already open!");
+            }
+            _open = true;
+            return _push ();
+        }
+
+        // inserts a new action in the open frame at the top of the stack
+        sstack_t& operator+= (const action_t& action) {
+            if (!_open) {
+                throw runtime_error ("[sstack_t::operator+=] There is no open frame!");
+            }
+            _sstack[_size-1] += action;
+            return *this;
+        }
+
+        // close the frame at the top of the stack
+        void close_frame () {
+            if (!_open) {
+                throw runtime_error ("[sstack_t::close_frame] There is no open frame!");
+            }
+            _open = false;
+        }
+
         // execute and remove the frame at the top of the stack. This function
-        // is the combination of exec and pop indeed
+        // is the combination of exec and pop indeed. If the frame at the top is
+        // open, it is closed as well. The memory of the frame is kept so that
+        // it can be reused
         void unwind (){
 
             // before proceeding make sure there is at least one frame
-            if (_sstack.size () == 0) {
+            if (_size == 0) {
                 throw runtime_error ("[sstack_t::unwind] Empty stack!");
             }
 
             // first, execute the frame at the top of the stack, i.e., the last one
-            _sstack.back ().exec ();
+            _sstack[_size-1].exec ();
 
             // and remove it upon successful termination
-            _sstack.pop_back ();
+            _sstack[--_size].clear ();
+            _open = false;
         }
 
         // capacity
 
         // return the number of frames in this stack
         size_t size () const {
+            return _size;
+        }
+
+        // return the number of frames allocated by this stack, either in the
+        // stack or ready to be reused
+        size_t capacity () const {
             return _sstack.size ();
         }
 };
@@ -0,0 +1,19 @@
+// -*- coding: utf-8 -*-
+// MUXtrail_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <mié 18-08-2021 10:03:11.502817344 (1629273791)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Implements a trail of changes performed during a search which can be undone
+// thus restoring the previous state
+
+#include "MUXtrail_t.h"
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,134 @@
+// -*- coding: utf-8 -*-
+// MUXtrail_t.h
+// -----------------------------------------------------------------------------
+//
+// Started on <mié 18-08-2021 10:02:36.418206795 (1629273756)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+//
+// Implements a trail of changes performed during a search. Every change is
+// recorded as a compact record with the type of change, the index of the
+// variable or value modified and its previous value, and all records are stored
+// in a single contiguous buffer. Frames are delimited with integer marks so
+// that all changes performed since the last mark can be undone at once. Unlike
+// stacks of frames, trails do not allocate memory once they have grown to the
+// depth of the search
+
+#ifndef _MUXTRAIL_T_H_
+#define _MUXTRAIL_T_H_
+
+#include<cstdint>
+#include<limits>
+#include<stdexcept>
+#include<vector>
+
+using namespace std;
+
+// the following type describes all changes that can be undone with a trail:
+// the number of feasible values of a variable, the value assigned to a
+// variable, the status of a value, and the number of feasible mutexes of a
+// value
+enum class opcode_t : uint32_t { VAR_NBVALUES, VAR_VALUE, VAL_STATUS, VAL_NBMUTEXES };
+
+// Class definition
+//
+// Definition of a trail of changes
+class trail_t {
+
+    private:
+
+        struct _record_t {
+
+            // INVARIANT: a record stores the type of change, the index of the
+            // variable or value modified and its previous value. Indices are
+            // stored with 32 bits as in the table of mutexes
+            opcode_t _opcode;
+            uint32_t _index;
+            size_t _prev;
+        };
+
+        // INVARIANT: a trail consists of a vector of records and a vector of
+        // marks, each one with the number of records in the trail when its
+        // frame was opened
+        vector<_record_t> _records;
+        vector<size_t> _marks;
+
+    public:
+
+        // Default constructor - trails are built by default
+        trail_t () :
+            _records { vector<_record_t>() },
+            _marks { vector<size_t>() }
+        {}
+
+        // Trails can not be copy-constructed
+        trail_t (const trail_t&) = delete;
+
+        // modifiers
+
+        // open a new frame. All changes recorded from now on are undone
+        // together when unwinding the trail
+        void open_frame () {
+            _marks.push_back (_records.size ());
+        }
+
+        // record a change in the frame at the top of the trail: the type of
+        // change, the index of the variable or value modified and its previous
+        // value. Indices which can not be stored with 32 bits are rejected
+        void push (const opcode_t opcode, const size_t index, const size_t prev) {
+            if (index > numeric_limits<uint32_t>::max ()) {
+                throw overflow_error ("[trail_t::push] Index too large");
+            }
+            _records.push_back (_record_t {opcode, uint32_t (index), prev});
+        }
+
+        // undo all changes of the frame at the top of the trail in reverse
+        // order and remove it. Changes are undone by the given manager with
+        // its service undo (opcode, index, prev)
+        template<class M>
+        void unwind (M& manager) {
+
+            // before proceeding make sure there is at least one frame
+            if (_marks.empty ()) {
+                throw runtime_error ("[trail_t::unwind] Empty trail!");
+            }
+
+            // undo all records after the last mark. Note that the buffer keeps
+            // its capacity
+            size_t mark = _marks.back ();
+            _marks.pop_back ();
+            while (_records.size () > mark) {
+                const _record_t& record = _records.back ();
+                manager.undo (record._opcode, record._index, record._prev);
+                _records.pop_back ();
+            }
+        }
+
+        // remove all frames without undoing them
+        void clear () {
+            _records.clear ();
+            _marks.clear ();
+        }
+
+        // capacity
+
+        // return the number of frames in this trail
+        size_t size () const {
+            return _marks.size ();
+        }
+
+        // return the number of records in this trail
+        size_t nbrecords () const {
+            return _records.size ();
+        }
+};
+
+#endif // _MUXTRAIL_T_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,19 @@
+// -*- coding: utf-8 -*-
+// MUXvalorder.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <vie 20-08-2021 09:13:21.560417993 (1629443601)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Value ordering strategies used by search algorithms. Note that selecting
+// values is a template because they can be defined over any type T
+
+#include "MUXvalorder.h"
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,312 @@
+// -*- coding: utf-8 -*-
+// MUXvalorder.h
+// -----------------------------------------------------------------------------
+//
+// Started on <vie 20-08-2021 09:12:44.803961527 (1629443564)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Value ordering strategies used by search algorithms. All of them provide
+// the same services:
+//
+//    init (vartable, mutextable): invoked at the beginning of every search
+//    restart (k): invoked at the beginning of the k-th restart of a search
+//    assign (var, statuses): invoked when a variable is assigned
+//    unassign (var, statuses): invoked when the assignment of a variable is
+//       undone
+//    disable (j, statuses): invoked when the j-th value is disabled
+//    enable (j, statuses): invoked when the j-th value is enabled again
+//    select (var, vartable, valtable, tried): return the next value to try in
+//       the domain of the variable var among those which are enabled in the
+//       table of values and not set in the bitmap of values already tried, or
+//       string::npos if there is none
+//
+// so that they can be given as a template parameter to search algorithms.
+// Notifications receive the bitmap of statuses of all values after the change,
+// and changes are always undone in reverse order. All strategies read counters
+// (either those of the tables of variables and values or their own) with a
+// single pass over the candidate values, i.e., domains are never sorted
+
+#ifndef _MUXVALORDER_H_
+#define _MUXVALORDER_H_
+
+#include<cstdint>
+#include<random>
+#include<string>
+#include<vector>
+
+#include "../structs/MUXbmap_t.h"
+#include "../structs/MUXmutextable_t.h"
+#include "../structs/MUXvaltable_t.h"
+#include "../structs/MUXvartable_t.h"
+
+// return the first value in the range [from, last] which is set in the bitmap
+// of statuses but not in the bitmap of values already tried, or string::npos if
+// there is none. Candidates are computed a whole word at a time
+inline size_t find_candidate (const bmap_t& statuses, const bmap_t& tried,
+                              const size_t from, const size_t last) {
+    const uint64_t* swords = statuses.data ();
+    const uint64_t* twords = tried.data ();
+    for (auto w = from/64 ; from <= last && w <= last/64 ; w++) {
+        uint64_t word = swords[w] & ~twords[w];
+        if (w == from/64) {
+            word &= ~uint64_t (0) << (from%64);
+        }
+        if (w == last/64 && last%64 != 63) {
+            word &= (uint64_t (1) << (last%64 + 1)) - 1;
+        }
+        if (word) {
+            return 64*w + __builtin_ctzll (word);
+        }
+    }
+    return std::string::npos;
+}
+
+// Class definition
+//
+// Values are tried in the same order they were added to the manager
+class valorder_lex_t {
+
+    public:
+
+        // nothing has to be initialized nor updated
+        void init (const vartable_t&, const mutextable_t&) {}
+        void restart (const size_t) {}
+        void assign (const size_t, const bmap_t&) {}
+        void unassign (const size_t, const bmap_t&) {}
+        void disable (const size_t, const bmap_t&) {}
+        void enable (const size_t, const bmap_t&) {}
+
+        // return the first candidate value
+        template<class T>
+        size_t select (const size_t var, const vartable_t& vartable,
+                       const valtable_t<T>& valtable, const bmap_t& tried) const {
+            return find_candidate (valtable.get_statuses (), tried,
+                                   vartable.get_first (var), vartable.get_last (var));
+        }
+};
+
+// Class definition
+//
+// The candidate value with the smallest number of enabled mutexes is tried
+// first (least constraining value). Ties are broken in favour of the first
+// value. Note that the number of enabled mutexes is only maintained during
+// search with forward checking or maintaining arc consistency; with plain
+// backtracking, it is the number of mutexes of every value
+class valorder_minmutexes_t {
+
+    public:
+
+        // nothing has to be initialized nor updated
+        void init (const vartable_t&, const mutextable_t&) {}
+        void restart (const size_t) {}
+        void assign (const size_t, const bmap_t&) {}
+        void unassign (const size_t, const bmap_t&) {}
+        void disable (const size_t, const bmap_t&) {}
+        void enable (const size_t, const bmap_t&) {}
+
+        // return the candidate value with the smallest number of enabled
+        // mutexes
+        template<class T>
+        size_t select (const size_t var, const vartable_t& vartable,
+                       const valtable_t<T>& valtable, const bmap_t& tried) const {
+            size_t result = std::string::npos;
+            const bmap_t& statuses = valtable.get_statuses ();
+            size_t last = vartable.get_last (var);
+            for (auto j = find_candidate (statuses, tried, vartable.get_first (var), last) ;
+                 j != std::string::npos ;
+                 j = find_candidate (statuses, tried, j+1, last)) {
+                if (result == std::string::npos ||
+                    valtable.get_nbmutexes (j) < valtable.get_nbmutexes (result)) {
+                    result = j;
+                }
+            }
+            return result;
+        }
+};
+
+// Class definition
+//
+// The candidate value with the largest number of supports, i.e., enabled
+// values of unassigned variables it is not mutex with, is tried first. Ties
+// are broken in favour of the first value. The number of supports of every
+// candidate is the number of enabled values of the unassigned neighbours of
+// its variable, which is the same for all candidates, minus the number of its
+// enabled mutexes with values of unassigned variables. The latter is
+// maintained incrementally for every value: every assignment (or disabled
+// value of an unassigned variable) traverses the enabled mutexes of the
+// values removed, so that selecting a value only reads one counter per
+// candidate
+class valorder_maxsupport_t {
+
+    private:
+
+        // INVARIANT: the strategy acts over the blocks of a table of mutexes
+        // and the assignments of a table of variables, and it records the
+        // number of enabled mutexes of every enabled value with values of
+        // unassigned variables. Counters of disabled values are not updated
+        // and they are valid again once they are enabled, because changes
+        // are undone in reverse order
+        const vartable_t* _vartable;
+        const mutextable_t* _mutextable;
+        std::vector<size_t> _nbfree;
+
+        // add the given increment to the counters of all enabled values which
+        // are mutex with the j-th value
+        void _update (const size_t j, const bmap_t& statuses, const int increment) {
+            _mutextable->for_each (j, statuses, [&] (size_t k) {
+                _nbfree[k] += increment;
+            });
+        }
+
+    public:
+
+        // Default constructor
+        valorder_maxsupport_t () :
+            _vartable { nullptr },
+            _mutextable { nullptr },
+            _nbfree { std::vector<size_t>() }
+        {}
+
+        // initialize the strategy with all variables unassigned and all values
+        // enabled
+        void init (const vartable_t& vartable, const mutextable_t& mutextable) {
+            _vartable = &vartable;
+            _mutextable = &mutextable;
+            _nbfree.resize (mutextable.size ());
+            for (size_t j = 0 ; j < mutextable.size () ; j++) {
+                _nbfree[j] = mutextable.degree (j);
+            }
+        }
+        void restart (const size_t) {}
+
+        // the enabled values of a variable being assigned (or unassigned)
+        // stop (or start again) being mutexes with unassigned variables
+        void assign (const size_t var, const bmap_t& statuses) {
+            for (auto j = _vartable->get_first (var) ; j <= _vartable->get_last (var) ; j++) {
+                if (statuses[j]) {
+                    _update (j, statuses, -1);
+                }
+            }
+        }
+        void unassign (const size_t var, const bmap_t& statuses) {
+            for (auto j = _vartable->get_first (var) ; j <= _vartable->get_last (var) ; j++) {
+                if (statuses[j]) {
+                    _update (j, statuses, +1);
+                }
+            }
+        }
+
+        // values of unassigned variables being disabled (or enabled) stop (or
+        // start again) being mutexes with unassigned variables
+        void disable (const size_t j, const bmap_t& statuses) {
+            if (_vartable->get_value (_mutextable->get_var (j)) == std::string::npos) {
+                _update (j, statuses, -1);
+            }
+        }
+        void enable (const size_t j, const bmap_t& statuses) {
+            if (_vartable->get_value (_mutextable->get_var (j)) == std::string::npos) {
+                _update (j, statuses, +1);
+            }
+        }
+
+        // return the number of enabled mutexes of the j-th value, which has to
+        // be enabled, with values of unassigned variables
+        size_t get_nbfree (const size_t j) const {
+            return _nbfree[j];
+        }
+
+        // return the candidate value with the largest number of supports, i.e.,
+        // the one with the fewest enabled mutexes with unassigned variables
+        template<class T>
+        size_t select (const size_t var, const vartable_t& vartable,
+                       const valtable_t<T>& valtable, const bmap_t& tried) const {
+            size_t result = std::string::npos;
+            const bmap_t& statuses = valtable.get_statuses ();
+            size_t last = vartable.get_last (var);
+            for (auto j = find_candidate (statuses, tried, vartable.get_first (var), last) ;
+                 j != std::string::npos ;
+                 j = find_candidate (statuses, tried, j+1, last)) {
+                if (result == std::string::npos || _nbfree[j] < _nbfree[result]) {
+                    result = j;
+                }
+            }
+            return result;
+        }
+};
+
+// Class definition
+//
+// Candidate values are tried in random order. The sequence of random numbers
+// is fully determined by the seed, so that searches can be reproduced. Every
+// restart uses a different seed derived from it
+class valorder_random_t {
+
+    private:
+
+        // INVARIANT: the strategy uses a pseudo-random generator initialized
+        // with the given seed at the beginning of every search
+        std::mt19937_64 _generator;
+        uint64_t _seed;
+
+    public:
+
+        // Default constructor - by default the seed is 0
+        valorder_random_t () :
+            _generator { std::mt19937_64 (0) },
+            _seed { 0 }
+        {}
+
+        // return the seed used by this strategy
+        uint64_t get_seed () const {
+            return _seed;
+        }
+
+        // set the seed to use in the next searches
+        void set_seed (const uint64_t seed) {
+            _seed = seed;
+        }
+
+        // restart the sequence of random numbers
+        void init (const vartable_t&, const mutextable_t&) {
+            _generator.seed (_seed);
+        }
+
+        // seed the k-th restart
+        void restart (const size_t k) {
+            _generator.seed (_seed + k);
+        }
+
+        // changes in the assignments and values are ignored
+        void assign (const size_t, const bmap_t&) {}
+        void unassign (const size_t, const bmap_t&) {}
+        void disable (const size_t, const bmap_t&) {}
+        void enable (const size_t, const bmap_t&) {}
+
+        // return a candidate value chosen uniformly at random. This is done
+        // with a single pass over all candidates (reservoir sampling)
+        template<class T>
+        size_t select (const size_t var, const vartable_t& vartable,
+                       const valtable_t<T>& valtable, const bmap_t& tried) {
+            size_t result = std::string::npos, nbcandidates = 0;
+            const bmap_t& statuses = valtable.get_statuses ();
+            size_t last = vartable.get_last (var);
+            for (auto j = find_candidate (statuses, tried, vartable.get_first (var), last) ;
+                 j != std::string::npos ;
+                 j = find_candidate (statuses, tried, j+1, last)) {
+                if (!(_generator () % ++nbcandidates)) {
+                    result = j;
+                }
+            }
+            return result;
+        }
+};
+
+#endif // _MUXVALORDER_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,74 @@
+// -*- coding: utf-8 -*-
+// MUXvarorder.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <jue 19-08-2021 10:03:02.447914508 (1629360182)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Variable ordering strategies used by search algorithms
+
+#include "MUXvarorder.h"
+
+using namespace std;
+
+// add a variable to the given bucket
+void varorder_dom_t::_push (const size_t var, const size_t k) {
+    _bucket[var] = k;
+    _pos[var] = _buckets[k].size ();
+    _buckets[k].push_back (var);
+    _min = (k < _min) ? k : _min;
+}
+
+// remove a variable from its bucket. The last variable of the bucket takes its
+// location
+void varorder_dom_t::_pop (const size_t var) {
+    vector<size_t>& bucket = _buckets[_bucket[var]];
+    size_t last = bucket.back ();
+    bucket[_pos[var]] = last;
+    _pos[last] = _pos[var];
+    bucket.pop_back ();
+    _bucket[var] = string::npos;
+}
+
+// initialize the strategy with all variables unassigned
+void varorder_dom_t::init (const vartable_t& vartable, const mutextable_t&) {
+
+    // create as many buckets as the size of the largest domain
+    _vartable = &vartable;
+    size_t largest = 0;
+    for (size_t var = 0 ; var < vartable.size () ; var++) {
+        size_t nbvalues = 1 + vartable.get_last (var) - vartable.get_first (var);
+        largest = (nbvalues > largest) ? nbvalues : largest;
+    }
+    _buckets.assign (1 + largest, vector<size_t>());
+    _bucket.assign (vartable.size (), string::npos);
+    _pos.assign (vartable.size (), 0);
+    _min = 0;
+
+    // and insert all variables
+    for (size_t var = 0 ; var < vartable.size () ; var++) {
+        _push (var, vartable.get_nbvalues (var));
+    }
+}
+
+// return the unassigned variable with the smallest number of feasible values
+size_t varorder_dom_t::select () {
+
+    // skip all empty buckets. Note that _min only increases here, so that the
+    // cost is amortized over all updates
+    while (_min < _buckets.size () && _buckets[_min].empty ()) {
+        _min++;
+    }
+    if (_min == _buckets.size ()) {
+        return string::npos;
+    }
+    return _buckets[_min].back ();
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
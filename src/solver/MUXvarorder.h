@@ -0,0 +1,284 @@
+// -*- coding: utf-8 -*-
+// MUXvarorder.h
+// -----------------------------------------------------------------------------
+//
+// Started on <jue 19-08-2021 10:02:17.985310624 (1629360137)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Variable ordering strategies used by search algorithms. All of them provide
+// the same services:
+//
+//    init (vartable, mutextable): invoked at the beginning of every search with
+//       all variables unassigned
+//    remove (var): invoked when a variable is assigned
+//    insert (var): invoked when the assignment of a variable is undone
+//    update (var): invoked every time the number of feasible values of a
+//       variable changes
+//    conflict (b): invoked when the domain of a variable is wiped out by the
+//       mutexes of the b-th block of the table of mutexes
+//    select (): return the next variable to assign, or string::npos if all of
+//       them have been assigned
+//
+// so that they can be given as a template parameter to search algorithms. All
+// updates are done incrementally, so that selecting the next variable never
+// traverses all variables
+
+#ifndef _MUXVARORDER_H_
+#define _MUXVARORDER_H_
+
+#include<limits>
+#include<string>
+#include<vector>
+
+#include "../structs/MUXbmap_t.h"
+#include "../structs/MUXheap_t.h"
+#include "../structs/MUXmutextable_t.h"
+#include "../structs/MUXvartable_t.h"
+
+// Class definition
+//
+// Variables are selected in the same order they were added to the manager
+class varorder_lex_t {
+
+    private:
+
+        // INVARIANT: the unassigned variables are stored in a bitmap
+        bmap_t _free;
+
+    public:
+
+        // Default constructor
+        varorder_lex_t () :
+            _free { bmap_t (0) }
+        {}
+
+        // initialize the strategy with all variables unassigned
+        void init (const vartable_t& vartable, const mutextable_t&) {
+            _free = bmap_t (vartable.size (), true);
+        }
+
+        // remove/insert a variable from/into the set of unassigned variables
+        void remove (const size_t var) {
+            _free.set (var, false);
+        }
+        void insert (const size_t var) {
+            _free.set (var, true);
+        }
+
+        // the number of feasible values and conflicts are ignored
+        void update (const size_t) {}
+        void conflict (const size_t) {}
+
+        // return the first unassigned variable
+        size_t select () const {
+            return _free.find_first ();
+        }
+};
+
+// Class definition
+//
+// The variable with the smallest number of feasible values is selected first
+// (dom). Unassigned variables are stored in a bucket queue indexed by their
+// number of feasible values, so that all updates take constant time
+class varorder_dom_t {
+
+    private:
+
+        // INVARIANT: every unassigned variable is stored in the bucket of its
+        // number of feasible values. For every variable, its bucket (or
+        // string::npos if it is assigned) and its location in the bucket are
+        // stored as well. _min is a lower bound of the first non-empty bucket
+        const vartable_t* _vartable;
+        std::vector<std::vector<size_t>> _buckets;
+        std::vector<size_t> _bucket;
+        std::vector<size_t> _pos;
+        size_t _min;
+
+        // add/remove a variable to/from the buckets
+        void _push (const size_t var, const size_t k);
+        void _pop (const size_t var);
+
+    public:
+
+        // Default constructor
+        varorder_dom_t () :
+            _vartable { nullptr },
+            _buckets { std::vector<std::vector<size_t>>() },
+            _bucket { std::vector<size_t>() },
+            _pos { std::vector<size_t>() },
+            _min { 0 }
+        {}
+
+        // initialize the strategy with all variables unassigned
+        void init (const vartable_t& vartable, const mutextable_t& mutextable);
+
+        // remove/insert a variable from/into the set of unassigned variables
+        void remove (const size_t var) {
+            _pop (var);
+        }
+        void insert (const size_t var) {
+            _push (var, _vartable->get_nbvalues (var));
+        }
+
+        // move the variable to the bucket of its current number of feasible
+        // values
+        void update (const size_t var) {
+            size_t nbvalues = _vartable->get_nbvalues (var);
+            if (_bucket[var] != std::string::npos && _bucket[var] != nbvalues) {
+                _pop (var);
+                _push (var, nbvalues);
+            }
+        }
+
+        // conflicts are ignored
+        void conflict (const size_t) {}
+
+        // return the unassigned variable with the smallest number of feasible
+        // values
+        size_t select ();
+};
+
+// Class definition
+//
+// The variable with the smallest ratio between its number of feasible values
+// and its degree is selected first. If weighted is false, the degree is the
+// number of unassigned variables it shares mutexes with (dom/ddeg). Otherwise,
+// every block of the table of mutexes is given a weight which is incremented
+// every time it wipes out the domain of a variable, and the degree is the sum
+// of the weights of all blocks shared with unassigned variables (dom/wdeg).
+// Unassigned variables are stored in an indexed heap so that all updates take
+// logarithmic time
+template<bool weighted>
+class varorder_degree_t {
+
+    private:
+
+        // INVARIANT: the strategy stores the weight of every block and the
+        // degree of every variable, along with the unassigned variables, which
+        // are also stored in a heap sorted by their ratio
+        const vartable_t* _vartable;
+        const mutextable_t* _mutextable;
+        std::vector<size_t> _weight;
+        std::vector<size_t> _degree;
+        bmap_t _free;
+        heap_t _heap;
+
+        // return the other variable of the b-th block
+        size_t _other (const size_t b, const size_t var) const {
+            return (_mutextable->get_var1 (b) == var) ?
+                _mutextable->get_var2 (b) : _mutextable->get_var1 (b);
+        }
+
+        // return the key of the given variable. Variables without
+        // neighbours go last
+        double _key (const size_t var) const {
+            if (!_degree[var]) {
+                return std::numeric_limits<double>::max ();
+            }
+            return double (_vartable->get_nbvalues (var)) / double (_degree[var]);
+        }
+
+        // add the given quantity to the degree of a variable
+        void _add (const size_t var, const long long delta) {
+            _degree[var] += delta;
+            if (_heap.contains (var)) {
+                _heap.update (var, _key (var));
+            }
+        }
+
+    public:
+
+        // Default constructor
+        varorder_degree_t () :
+            _vartable { nullptr },
+            _mutextable { nullptr },
+            _weight { std::vector<size_t>() },
+            _degree { std::vector<size_t>() },
+            _free { bmap_t (0) },
+            _heap { heap_t (0) }
+        {}
+
+        // initialize the strategy with all variables unassigned and all
+        // blocks with a unitary weight
+        void init (const vartable_t& vartable, const mutextable_t& mutextable) {
+            _vartable = &vartable;
+            _mutextable = &mutextable;
+            _weight.assign (mutextable.nbblocks (), 1);
+            _degree.assign (vartable.size (), 0);
+            for (size_t var = 0 ; var < vartable.size () ; var++) {
+                _degree[var] = mutextable.get_blocks (var).size ();
+            }
+            _free = bmap_t (vartable.size (), true);
+            _heap = heap_t (vartable.size ());
+            for (size_t var = 0 ; var < vartable.size () ; var++) {
+                _heap.insert (var, _key (var));
+            }
+        }
+
+        // remove a variable from the set of unassigned variables, which
+        // decrements the degree of its unassigned neighbours
+        void remove (const size_t var) {
+            _heap.erase (var);
+            _free.set (var, false);
+            for (auto b : _mutextable->get_blocks (var)) {
+                _add (_other (b, var), -(long long) (_weight[b]));
+            }
+        }
+
+        // insert a variable into the set of unassigned variables, which
+        // increments the degree of its neighbours
+        void insert (const size_t var) {
+            for (auto b : _mutextable->get_blocks (var)) {
+                _add (_other (b, var), _weight[b]);
+            }
+            _free.set (var, true);
+            _heap.insert (var, _key (var));
+        }
+
+        // update the key of a variable after a change in its number of
+        // feasible values
+        void update (const size_t var) {
+            if (_heap.contains (var)) {
+                _heap.update (var, _key (var));
+            }
+        }
+
+        // increment the weight of the b-th block and thus, the degree of its
+        // variables if the other one is unassigned
+        void conflict (const size_t b) {
+            if (weighted) {
+                _weight[b]++;
+                size_t var1 = _mutextable->get_var1 (b), var2 = _mutextable->get_var2 (b);
+                if (_free[var2]) {
+                    _add (var1, 1);
+                }
+                if (_free[var1]) {
+                    _add (var2, 1);
+                }
+            }
+        }
+
+        // return the unassigned variable with the smallest ratio
+        size_t select () const {
+            return _heap.top ();
+        }
+
+        // return the weight of the b-th block
+        size_t get_weight (const size_t b) const {
+            return _weight[b];
+        }
+};
+
+// dom/ddeg and dom/wdeg
+typedef varorder_degree_t<false> varorder_domddeg_t;
+typedef varorder_degree_t<true> varorder_domwdeg_t;
+
+#endif // _MUXVARORDER_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
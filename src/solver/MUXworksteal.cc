@@ -0,0 +1,20 @@
+// -*- coding: utf-8 -*-
+// MUXworksteal.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 24-08-2021 11:06:14.903311208 (1629795974)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Parallel depth-first search over the CSP task defined in a manager where idle
+// workers steal the untried branches of busy workers. Note that the search is
+// a template because it can act on values defined over any type T
+
+#include "MUXworksteal.h"
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,418 @@
+// -*- coding: utf-8 -*-
+// MUXworksteal.h
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 24-08-2021 11:05:37.220418936 (1629795937)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Parallel depth-first search over the CSP task defined in a manager where idle
+// workers steal the untried branches of busy workers
+
+#ifndef _MUXWORKSTEAL_H_
+#define _MUXWORKSTEAL_H_
+
+#include<atomic>
+#include<chrono>
+#include<cstdint>
+#include<exception>
+#include<limits>
+#include<memory>
+#include<random>
+#include<stdexcept>
+#include<string>
+#include<thread>
+#include<vector>
+
+#include "../structs/MUXwsdeque_t.h"
+#include "MUXbacktracking.h"
+#include "MUXmanager.h"
+
+using namespace std;
+
+// Class definition
+//
+// Definition of a parallel depth-first search with work stealing. Every worker
+// runs in a separate thread over its own copy of the manager, which shares the
+// frozen table of mutexes, and traverses the search tree with its own
+// backtracking search, i.e., with its own trail. Every branch of the search
+// tree is a task described by the value assigned at it and its parent task, so
+// that all tasks share the prefixes of their ancestors and creating one takes
+// constant time. When a worker expands a node, it pushes one task per value of
+// the next variable at the bottom of its own deque, and then it takes the last
+// one, so that it proceeds depth-first. Idle workers steal tasks from the top
+// of the deque of other workers, i.e., the shallowest untried branches.
+// Workers rebuild the state of every task by undoing their assignments down to
+// its deepest ancestor in their current branch and replaying the values from
+// it, so that taking a child of the current node replays only its value. Tasks
+// are exchanged through lock-free deques, and the search finishes when there
+// are no pending tasks. The search either stops at the first solution or counts
+// all of them. Note that the search is a template because it can act on values
+// defined over any type T, and workers select variables and values with the
+// given ordering strategies
+template<class T, class VarOrder = varorder_lex_t, class ValOrder = valorder_lex_t>
+class worksteal {
+
+    private:
+
+        // every task is a branch of the search tree given by its parent, the
+        // value assigned at it and its depth. The root has no parent and its
+        // depth is 0
+        struct _task_t {
+            mutable shared_ptr<const _task_t> _parent;
+            size_t _value;
+            size_t _depth;
+
+            // release the ancestors no longer referenced by any other task one
+            // after another, as releasing them recursively could exhaust the
+            // stack with branches as deep as the number of variables
+            ~_task_t () {
+                shared_ptr<const _task_t> parent = move (_parent);
+                while (parent && parent.use_count () == 1) {
+                    parent = move (parent->_parent);
+                }
+            }
+        };
+
+        // INVARIANT: a parallel search acts over the CSP task defined in a
+        // manager, which is never modified, with a number of workers and the
+        // propagation performed after every assignment
+        manager<T>& _manager;
+        size_t _nbworkers;
+        propagation_t _propagation;
+
+        // maximum time allowed (in seconds)
+        double _time_limit;
+
+        // outcome of the last search: its status, the first solution found (if
+        // any), the number of solutions found and some statistics
+        status_t _status;
+        vector<size_t> _solution;
+        size_t _nbsolutions;
+        size_t _nbnodes;
+        size_t _nbsteals;
+        double _elapsed;
+
+        // shared state of the workers: one deque of tasks per worker, the
+        // number of tasks pushed but not yet expanded, the number of solutions
+        // found, a flag raised to stop all workers and another one raised by
+        // the first worker finding a solution
+        vector<unique_ptr<wsdeque_t<_task_t*>>> _deques;
+        atomic<size_t> _pending;
+        atomic<size_t> _solutions;
+        atomic<bool> _stop;
+        atomic<bool> _found;
+        atomic<bool> _timeout;
+
+        // traverse the search tree with the given worker over its own copy of
+        // the manager until there are no pending tasks or all workers are
+        // stopped. If all is false, the first solution found stops all
+        // workers. The number of nodes expanded and tasks stolen are returned
+        // in the given variables
+        void _work (const size_t w, manager<T>& mgr, const bool all,
+                    const chrono::steady_clock::time_point& start,
+                    size_t& nbnodes, size_t& nbsteals);
+
+        // run all workers over the CSP task
+        status_t _run (const bool all);
+
+    public:
+
+        // The default constructor is strictly forbidden
+        worksteal () = delete;
+
+        // Explicit constructor - given the manager with the definition of the
+        // CSP task to solve. By default, there is one worker per hardware
+        // thread, no propagation and no limit on time. Note that implicit
+        // casting is forbidden
+        explicit worksteal (manager<T>& mgr) :
+            _manager { mgr },
+            _nbworkers { max (size_t (1), size_t (thread::hardware_concurrency ())) },
+            _propagation { propagation_t::BACKTRACKING },
+            _time_limit { numeric_limits<double>::max () },
+            _status { status_t::UNKNOWN },
+            _solution { vector<size_t>() },
+            _nbsolutions { 0 },
+            _nbnodes { 0 },
+            _nbsteals { 0 },
+            _elapsed { 0.0 },
+            _deques { vector<unique_ptr<wsdeque_t<_task_t*>>>() },
+            _pending { 0 },
+            _solutions { 0 },
+            _stop { false },
+            _found { false },
+            _timeout { false }
+        {}
+
+        // Searches can not be copied
+        worksteal (const worksteal&) = delete;
+
+        // accessors
+
+        // return the status of the last search
+        status_t get_status () const {
+            return _status;
+        }
+
+        // return the first solution found in the last search, if any. When
+        // counting solutions, it is always empty
+        const vector<size_t>& get_solution () const {
+            return _solution;
+        }
+
+        // return the number of solutions found in the last search, which is
+        // at most one unless solutions were counted
+        size_t get_nbsolutions () const {
+            return _nbsolutions;
+        }
+
+        // return the overall number of nodes expanded by all workers,
+        // including the assignments replayed after taking a task
+        size_t get_nbnodes () const {
+            return _nbnodes;
+        }
+
+        // return the number of tasks stolen in the last search
+        size_t get_nbsteals () const {
+            return _nbsteals;
+        }
+
+        // return the time elapsed in the last search in seconds
+        double get_elapsed () const {
+            return _elapsed;
+        }
+
+        // return the number of workers
+        size_t get_nbworkers () const {
+            return _nbworkers;
+        }
+
+        // return the propagation performed after every assignment
+        propagation_t get_propagation () const {
+            return _propagation;
+        }
+
+        // modifiers
+
+        // set the number of workers, which has to be positive
+        void set_nbworkers (const size_t nbworkers) {
+            if (!nbworkers) {
+                throw invalid_argument ("[worksteal::set_nbworkers] Wrong number of workers");
+            }
+            _nbworkers = nbworkers;
+        }
+
+        // set the propagation performed after every assignment
+        void set_propagation (const propagation_t propagation) {
+            _propagation = propagation;
+        }
+
+        // set the maximum time allowed in seconds
+        void set_time_limit (const double limit) {
+            _time_limit = limit;
+        }
+
+        // search for the first solution of the CSP task. The manager is frozen
+        // if it was not yet, and it is never modified. It returns SATISFIABLE
+        // if a solution was found, UNSATISFIABLE if there is none, and
+        // TIME_LIMIT if time was exhausted
+        status_t solve () {
+            return _run (false);
+        }
+
+        // count all solutions of the CSP task. It returns SATISFIABLE if there
+        // is at least one solution, UNSATISFIABLE if there is none, and
+        // TIME_LIMIT if time was exhausted, in which case the number of
+        // solutions is only a lower bound
+        status_t count () {
+            return _run (true);
+        }
+};
+
+// traverse the search tree with the given worker until there are no pending
+// tasks or all workers are stopped
+template<class T, class VarOrder, class ValOrder>
+void worksteal<T, VarOrder, ValOrder>::_work (const size_t w, manager<T>& mgr, const bool all,
+                                              const chrono::steady_clock::time_point& start,
+                                              size_t& nbnodes, size_t& nbsteals) {
+
+    // every worker traverses the search tree with its own search, whose
+    // assignments are the values of the tasks in its current branch
+    backtracking<T, VarOrder, ValOrder> search (mgr);
+    search.set_propagation (_propagation);
+    search.open ();
+    vector<shared_ptr<const _task_t>> current, replay;
+    mt19937_64 generator (w);
+    size_t iteration = 0;
+    nbsteals = 0;
+    while (!_stop.load (memory_order_relaxed) && _pending.load (memory_order_acquire)) {
+
+        // check the clock every once in a while
+        if (!(++iteration % 256) &&
+            chrono::duration<double> (chrono::steady_clock::now () - start).count () >= _time_limit) {
+            _timeout.store (true);
+            _stop.store (true);
+            break;
+        }
+
+        // take the last task of this worker or, if there is none, steal the
+        // first one of another worker chosen at random
+        _task_t* ptask;
+        if (!_deques[w]->take (ptask)) {
+            size_t victim = generator () % _nbworkers;
+            if (victim == w || !_deques[victim]->steal (ptask)) {
+                this_thread::yield ();
+                continue;
+            }
+            nbsteals++;
+        }
+        shared_ptr<const _task_t> task (ptask);
+
+        // look for the deepest ancestor of this task in the current branch,
+        // undo all assignments beyond it, and replay the values of all tasks
+        // from it
+        replay.clear ();
+        shared_ptr<const _task_t> ancestor = task;
+        while (ancestor->_depth &&
+               (ancestor->_depth > current.size () || current[ancestor->_depth-1] != ancestor)) {
+            replay.push_back (ancestor);
+            ancestor = ancestor->_parent;
+        }
+        while (current.size () > ancestor->_depth) {
+            search.pop ();
+            current.pop_back ();
+        }
+        bool consistent = true;
+        for (auto it = replay.rbegin () ; consistent && it != replay.rend () ; ++it) {
+            consistent = search.push ((*it)->_value);
+            if (consistent) {
+                current.push_back (*it);
+            }
+        }
+
+        // if the branch is consistent, either a solution has been found or a
+        // new task is pushed for every value of the next variable in reverse
+        // order, so that the first one is taken next. Tasks are counted as
+        // pending before this one is released
+        if (consistent) {
+            size_t var = search.select ();
+            if (var == string::npos) {
+                _solutions.fetch_add (1, memory_order_relaxed);
+                bool expected = false;
+                if (!all && _found.compare_exchange_strong (expected, true)) {
+                    const vartable_t& vartable = mgr.get_vartable ();
+                    for (size_t i = 0 ; i < vartable.size () ; i++) {
+                        _solution.push_back (vartable.get_value (i));
+                    }
+                    _stop.store (true);
+                }
+            } else {
+                vector<size_t> values = search.candidates (var);
+                for (auto it = values.rbegin () ; it != values.rend () ; ++it) {
+                    _pending.fetch_add (1, memory_order_relaxed);
+                    _deques[w]->push (new _task_t {task, *it, task->_depth + 1});
+                }
+            }
+        }
+        task.reset ();
+        _pending.fetch_sub (1, memory_order_release);
+    }
+
+    // restore the copy of the manager of this worker
+    search.close ();
+    nbnodes = search.get_nbnodes ();
+}
+
+// run all workers over the CSP task
+template<class T, class VarOrder, class ValOrder>
+status_t worksteal<T, VarOrder, ValOrder>::_run (const bool all) {
+
+    // initialize the search
+    auto start = chrono::steady_clock::now ();
+    _solution.clear ();
+    _nbsolutions = _nbnodes = _nbsteals = 0;
+    _solutions.store (0);
+    _stop.store (false);
+    _found.store (false);
+    _timeout.store (false);
+
+    // propagate at the root once to detect inconsistent tasks right away.
+    // This also freezes the manager
+    backtracking<T, VarOrder, ValOrder> root (_manager);
+    root.set_propagation (_propagation);
+    bool consistent = root.open ();
+    root.close ();
+    if (!consistent) {
+        _status = status_t::UNSATISFIABLE;
+        _elapsed = chrono::duration<double> (chrono::steady_clock::now () - start).count ();
+        return _status;
+    }
+
+    // create one copy of the manager and one deque per worker. All copies
+    // share the same table of mutexes. The first worker starts with the root
+    vector<manager<T>> replicas (_nbworkers, _manager);
+    _deques.clear ();
+    for (size_t w = 0 ; w < _nbworkers ; w++) {
+        _deques.push_back (unique_ptr<wsdeque_t<_task_t*>> (new wsdeque_t<_task_t*> ()));
+    }
+    _pending.store (1);
+    _deques[0]->push (new _task_t {nullptr, string::npos, 0});
+
+    // run every worker in a separate thread. Any worker raising an exception
+    // stops all the others, and it is rethrown once all threads are done
+    vector<size_t> nbnodes (_nbworkers, 0), nbsteals (_nbworkers, 0);
+    vector<exception_ptr> errors (_nbworkers, nullptr);
+    vector<thread> threads;
+    for (size_t w = 0 ; w < _nbworkers ; w++) {
+        threads.emplace_back ([&, w] {
+            try {
+                _work (w, replicas[w], all, start, nbnodes[w], nbsteals[w]);
+            } catch (...) {
+                errors[w] = current_exception ();
+                _stop.store (true);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join ();
+    }
+
+    // release all tasks left when the search was stopped
+    for (auto& deque : _deques) {
+        _task_t* task;
+        while (deque->take (task)) {
+            delete task;
+        }
+    }
+    for (auto& error : errors) {
+        if (error) {
+            rethrow_exception (error);
+        }
+    }
+
+    // and collect the results
+    _nbsolutions = _solutions.load ();
+    for (size_t w = 0 ; w < _nbworkers ; w++) {
+        _nbnodes += nbnodes[w];
+        _nbsteals += nbsteals[w];
+    }
+    if (_timeout.load () && (all || !_found.load ())) {
+        _status = status_t::TIME_LIMIT;
+    } else {
+        _status = _nbsolutions ? status_t::SATISFIABLE : status_t::UNSATISFIABLE;
+    }
+    if (!all) {
+        _nbsolutions = _nbsolutions ? 1 : 0;
+    }
+    _elapsed = chrono::duration<double> (chrono::steady_clock::now () - start).count ();
+    return _status;
+}
+
+#endif // _MUXWORKSTEAL_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
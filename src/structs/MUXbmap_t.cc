@@ -9,72 +9,225 @@
 // Description:
 // implementation of a bit map of any length
 //
-// Note that bits are not stored in contiguous locations as in:
+// Bits are stored in 64-bit words in increasing order, and within every word
+// the offset grows from the LSB to the MSB as in:
 //
-// +--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+
-// | 0| 1| 2| 3| 4| 5| 6| 7| 8| 9|10|11|12|13|14|15|
-// +--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+
-// <------- byte 0 --------><------- byte 1 ------->
-//
-// instead bytes are stored in increasing order but the offset is sorted in
-// descending order as in:
-//
-// +--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+
-// | 7| 6| 5| 4| 3| 2| 1| 0|15|14|13|12|11|10| 9| 8|
-// +--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+--+
-// <------- byte 0 --------><------- byte 1 ------->
+// +--+--+-----+--+--+---+---+-----+--+--+
+// |63|62| ... | 1| 0|127|126| ... |65|64|
+// +--+--+-----+--+--+---+---+-----+--+--+
+// <----- word 0 ----><----- word 1 ----->
 //
-
-#include<stdexcept>
+// so that the i-th bit is found in the word i/64 at the offset i%64
 
 #include "MUXbmap_t.h"
 
-// get the value at the i-th bit
-bool bmap_t::get (const size_t i) const {
+// set (to 1) all bits in the range [first, last]. If last < first nothing is
+// done
+void bmap_t::set_range (const size_t first, const size_t last) {
+
+    // first, make sure the range requested is within the length of the bit map
+    if (last < first) {
+        return;
+    }
+    if (last >= _length) {
+        throw out_of_range ("[bmap_t::set_range] out of bounds");
+    }
+
+    // compute the masks of the first and last words. In case both bounds fall
+    // in the same word, both masks are combined
+    size_t fword = first/64, lword = last/64;
+    uint64_t fmask = ~uint64_t (0) << (first%64);
+    uint64_t lmask = ~uint64_t (0) >> (63 - last%64);
+    if (fword == lword) {
+        _bmap[fword] |= fmask & lmask;
+        return;
+    }
+
+    // otherwise, set the bits of the first and last word separately and all
+    // words in between at once
+    _bmap[fword] |= fmask;
+    for (auto i = fword + 1 ; i < lword ; i++) {
+        _bmap[i] = ~uint64_t (0);
+    }
+    _bmap[lword] |= lmask;
+}
+
+// clear (to 0) all bits in the range [first, last]. If last < first nothing is
+// done
+void bmap_t::clear_range (const size_t first, const size_t last) {
+
+    // first, make sure the range requested is within the length of the bit map
+    if (last < first) {
+        return;
+    }
+    if (last >= _length) {
+        throw out_of_range ("[bmap_t::clear_range] out of bounds");
+    }
+
+    // this is the same as set_range but resetting bits with the negation of
+    // the masks
+    size_t fword = first/64, lword = last/64;
+    uint64_t fmask = ~uint64_t (0) << (first%64);
+    uint64_t lmask = ~uint64_t (0) >> (63 - last%64);
+    if (fword == lword) {
+        _bmap[fword] &= ~(fmask & lmask);
+        return;
+    }
+    _bmap[fword] &= ~fmask;
+    for (auto i = fword + 1 ; i < lword ; i++) {
+        _bmap[i] = 0;
+    }
+    _bmap[lword] &= ~lmask;
+}
+
+// change the number of bits stored in this bitmap. New bits (if any) are
+// initialized with the given value
+void bmap_t::resize (const size_t len, const bool value) {
+
+    // resize the vector of words. Because bits beyond the length of the bitmap
+    // are always null, new bits are zero unless otherwise requested
+    size_t prev = _length;
+    _bmap.resize (_nbwords (len), 0);
+    _length = len;
+    if (value && len > prev) {
+        set_range (prev, len-1);
+    }
+
+    // and make sure bits beyond the new length are null
+    _trim ();
+}
+
+// return the index of the first bit set, or string::npos if there is none
+size_t brow_t::find_first () const {
+
+    // skip all null words and return the position of the least significant
+    // bit of the first non-null word
+    for (size_t i = 0 ; i < nbwords () ; i++) {
+        if (_words[i]) {
+            return 64*i + __builtin_ctzll (_words[i]);
+        }
+    }
+
+    // at this point, no bit is set
+    return string::npos;
+}
+
+// return the index of the first bit set strictly after the i-th bit, or
+// string::npos if there is none
+size_t brow_t::find_next (const size_t i) const {
+
+    // if the next location is beyond the length of the view, then there is
+    // nothing else to find
+    size_t next = i + 1;
+    if (next >= _length) {
+        return string::npos;
+    }
+
+    // first, look for the next bit in the same word, masking out all bits up
+    // to the i-th location
+    size_t iword = next/64;
+    uint64_t word = _words[iword] & (~uint64_t (0) << (next%64));
+    while (!word) {
+
+        // in case this word has no more bits set, proceed with the next one
+        if (++iword >= nbwords ()) {
+            return string::npos;
+        }
+        word = _words[iword];
+    }
+    return 64*iword + __builtin_ctzll (word);
+}
+
+// return the number of bits set
+size_t brow_t::count () const {
+
+    // note that bits beyond the length of the view are guaranteed to be null
+    size_t result = 0;
+    for (size_t i = 0 ; i < nbwords () ; i++) {
+        result += __builtin_popcountll (_words[i]);
+    }
+    return result;
+}
+
+// return true if at least one bit is set
+bool brow_t::any () const {
+    for (size_t i = 0 ; i < nbwords () ; i++) {
+        if (_words[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// return true if this view and the given one have at least one bit set in
+// common
+bool brow_t::intersects (const brow_t& right) const {
+
+    // first, make sure both views have the same length
+    if (_length != right._length) {
+        throw invalid_argument ("[brow_t::intersects] Different lengths");
+    }
+    for (size_t i = 0 ; i < nbwords () ; i++) {
+        if (_words[i] & right._words[i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// bitwise and
+bmap_t& bmap_t::operator&= (const bmap_t& right) {
 
-    // first, make sure the value requested is within the length of the bit map
-    if (i < 0 || i >= (int) size ()) {
-        throw out_of_range ("[bmap_t::get] out of bounds");
+    // first, make sure both bitmaps have the same length
+    if (_length != right._length) {
+        throw invalid_argument ("[bmap_t::operator&=] Different lengths");
     }
+    for (size_t i = 0 ; i < _bmap.size () ; i++) {
+        _bmap[i] &= right._bmap[i];
+    }
+    return *this;
+}
 
-    // get the location of the required bit. It resides in the i-th byte which
-    // is computed dividing by 8, and with an offset equal to the remainder of
-    // the same division
-    int ibyte = i/8;
-    int offset = i%8;
+// bitwise or
+bmap_t& bmap_t::operator|= (const bmap_t& right) {
 
-    // the return the required content. This is achieved by right shifting the
-    // i-th byte as many locations as the offset and then extracting the LSB
-    // (less significant bit)
-    return _bmap[ibyte] >> offset & 1;
+    // first, make sure both bitmaps have the same length
+    if (_length != right._length) {
+        throw invalid_argument ("[bmap_t::operator|=] Different lengths");
+    }
+    for (size_t i = 0 ; i < _bmap.size () ; i++) {
+        _bmap[i] |= right._bmap[i];
+    }
+    return *this;
 }
 
-// set the value of the i-th bit
-void bmap_t::set (const size_t i, const bool value) {
+// bitwise xor
+bmap_t& bmap_t::operator^= (const bmap_t& right) {
 
-    // first, make sure the value requested is within the length of the bit map
-    if (i < 0 || i >= (int) size ()) {
-        throw out_of_range ("[bmap_t::set] out of bounds");
+    // first, make sure both bitmaps have the same length
+    if (_length != right._length) {
+        throw invalid_argument ("[bmap_t::operator^=] Different lengths");
     }
 
-    // get the location of the required bit. It resides in the i-th byte which
-    // is computed dividing by 8, and with an offset equal to the remainder of
-    // the same division
-    int ibyte = i/8;
-    int offset = i%8;
+    // note that bits beyond the length are null in both bitmaps, so that they
+    // remain null
+    for (size_t i = 0 ; i < _bmap.size () ; i++) {
+        _bmap[i] ^= right._bmap[i];
+    }
+    return *this;
+}
 
-    // to set a bit in one specific location, it just suffices left shifting it
-    // its offset and computing the bitwise with the current contents of the
-    // bitmap
-    if (value) {
-        _bmap[ibyte] |= 1 << offset;
-    } else {
+// reset all bits which are set in the given bitmap, i.e., *this &= ~right
+bmap_t& bmap_t::andnot (const bmap_t& right) {
 
-        // to reset a bit the idea is pretty much the same: performing a bitwise
-        // and with a mask made of 1s but the desired location which gets the
-        // value 0
-        _bmap[ibyte] &= ~(1 << offset);
+    // first, make sure both bitmaps have the same length
+    if (_length != right._length) {
+        throw invalid_argument ("[bmap_t::andnot] Different lengths");
+    }
+    for (size_t i = 0 ; i < _bmap.size () ; i++) {
+        _bmap[i] &= ~right._bmap[i];
     }
+    return *this;
 }
 
 
@@ -12,64 +12,284 @@
 #ifndef _BMAP_T_H_
 #define _BMAP_T_H_
 
+#include<cstdint>
+#include<stdexcept>
+#include<string>
 #include<vector>
 
 using namespace std;
 
+//
+// Class definition
+//
+// A read-only view over a sequence of words storing bits. Views are used to
+// access the rows of multibitmaps, and bitmaps can be implicitly converted
+// into views so that all operations between views accept bitmaps as well
+class brow_t {
+
+    private:
+
+        // INVARIANT: a view consists of a pointer to its first word and the
+        // number of bits it stores. Bits beyond its length in the last word
+        // are always zero
+        const uint64_t* _words;
+        size_t _length;
+
+    public:
+
+        // The default constructor is strictly forbidden
+        brow_t () = delete;
+
+        // Explicit constructor - given the first word and the number of bits
+        brow_t (const uint64_t* words, const size_t len) :
+            _words { words },
+            _length { len }
+        {}
+
+        // accessors
+
+        // get the value at the i-th bit
+        bool get (const size_t i) const {
+            if (i >= _length) {
+                throw out_of_range ("[brow_t::get] out of bounds");
+            }
+            return (*this)[i];
+        }
+
+        // the random access operator does not perform any bounds checking
+        bool operator[] (const size_t i) const {
+            return _words[i/64] >> (i%64) & 1;
+        }
+
+        // return a pointer to the first word of this view
+        const uint64_t* data () const {
+            return _words;
+        }
+
+        // return the number of words of this view
+        size_t nbwords () const {
+            return _length/64 + size_t (_length%64 != 0);
+        }
+
+        // return the number of bits of this view
+        size_t size () const {
+            return _length;
+        }
+
+        // return the index of the first bit set, or string::npos if there is
+        // none
+        size_t find_first () const;
+
+        // return the index of the first bit set strictly after the i-th bit,
+        // or string::npos if there is none
+        size_t find_next (const size_t i) const;
+
+        // return the number of bits set
+        size_t count () const;
+
+        // return true if at least one bit is set
+        bool any () const;
+
+        // return true if this view and the given one have at least one bit set
+        // in common, i.e., (*this & right).any () without computing the
+        // intersection. Both must have the same length
+        bool intersects (const brow_t& right) const;
+};
+
 //
 // Class definition
 class bmap_t {
 
     private:
 
-        // INVARIANT: A bitmap consists of a vector of bytes (chars) which store
+        // INVARIANT: A bitmap consists of a vector of 64-bit words which store
         // information (1 or 0) in individual bits. These bits can be addressed
-        // (get/set) individually
-        vector<char> _bmap;
+        // (get/set) individually or processed a whole word at a time. Bits
+        // beyond the length of the bitmap in the last word are always zero, so
+        // that bulk operations never have to mask them out
+        vector<uint64_t> _bmap;
 
         // the length is stored separately and it is defined as the number of
-        // bytes necessary to store the bitmap
+        // bits stored in the bitmap
         size_t _length;
 
+        // return the number of words necessary to store len bits
+        static size_t _nbwords (const size_t len) {
+            return len/64 + size_t (len%64 != 0);
+        }
+
+        // reset all bits beyond the length of the bitmap in the last word
+        void _trim () {
+            if (_length%64) {
+                _bmap.back () &= (uint64_t (1) << (_length%64)) - 1;
+            }
+        }
+
     public:
 
+        // the following value is returned by all search services when no bit
+        // is found
+        static constexpr size_t npos = string::npos;
+
         // The default constructor is strictly forbidden
         bmap_t () = delete;
 
-        // Explicit constructor - given a number of bits to store
-        bmap_t (const size_t len) {
-
-            // compute the required number of bytes to store up to len bits.
-            // Note that if len is not divisible by the number of bits in a byte
-            // more locations are then offered
-            _length = len/8 + int (len%8 != 0);
-
-            // create the vector and initialize it to zero
-            _bmap = vector<char>(_length, 0);
+        // Explicit constructor - given a number of bits to store, all of which
+        // are initialized with the given value
+        bmap_t (const size_t len, const bool value=false) :
+            _bmap { vector<uint64_t>(_nbwords (len), value ? ~uint64_t (0) : 0) },
+            _length { len }
+        {
+            _trim ();
         }
 
         // accessors
 
         // get the value at the i-th bit
-        bool get (const size_t i) const;
+        bool get (const size_t i) const {
+
+            // first, make sure the value requested is within the length of the
+            // bit map
+            if (i >= _length) {
+                throw out_of_range ("[bmap_t::get] out of bounds");
+            }
+            return (*this)[i];
+        }
+
+        // the random access operator does not perform any bounds checking
         bool operator[](const size_t i) const {
-            return get (i);
+            return _bmap[i/64] >> (i%64) & 1;
         }
 
         // set the value of the i-th bit
-        void set (const size_t i, const bool value);
+        void set (const size_t i, const bool value) {
+
+            // first, make sure the value requested is within the length of the
+            // bit map
+            if (i >= _length) {
+                throw out_of_range ("[bmap_t::set] out of bounds");
+            }
+
+            // to set a bit in one specific location, it just suffices left
+            // shifting it its offset and computing the bitwise or with the
+            // current contents of its word; to reset it, a bitwise and with a
+            // mask made of 1s but the desired location is used instead
+            if (value) {
+                _bmap[i/64] |= uint64_t (1) << (i%64);
+            } else {
+                _bmap[i/64] &= ~(uint64_t (1) << (i%64));
+            }
+        }
+
+        // set (to 1) all bits in the range [first, last]. If last < first
+        // nothing is done
+        void set_range (const size_t first, const size_t last);
+
+        // clear (to 0) all bits in the range [first, last]. If last < first
+        // nothing is done
+        void clear_range (const size_t first, const size_t last);
+
+        // change the number of bits stored in this bitmap. New bits (if any)
+        // are initialized with the given value
+        void resize (const size_t len, const bool value=false);
+
+        // return the index of the first bit set in this bitmap, or npos if
+        // there is none
+        size_t find_first () const {
+            return brow_t (*this).find_first ();
+        }
+
+        // return the index of the first bit set strictly after the i-th bit,
+        // or npos if there is none. This allows iterating over all bits set
+        // with one word access every 64 bits:
+        //
+        //    for (auto i = b.find_first () ; i != bmap_t::npos ; i = b.find_next (i))
+        size_t find_next (const size_t i) const {
+            return brow_t (*this).find_next (i);
+        }
+
+        // return the number of bits set in this bitmap
+        size_t count () const {
+            return brow_t (*this).count ();
+        }
+
+        // return true if at least one bit is set
+        bool any () const {
+            return brow_t (*this).any ();
+        }
+
+        // return true if no bit is set
+        bool none () const {
+            return !any ();
+        }
+
+        // return true if this bitmap and the given one have at least one bit
+        // set in common
+        bool intersects (const brow_t& right) const {
+            return brow_t (*this).intersects (right);
+        }
+
+        // bulk operations. All of them require both bitmaps to have the same
+        // length or an exception is raised
+
+        // bitwise and
+        bmap_t& operator&= (const bmap_t& right);
+
+        // bitwise or
+        bmap_t& operator|= (const bmap_t& right);
+
+        // bitwise xor
+        bmap_t& operator^= (const bmap_t& right);
+
+        // reset all bits which are set in the given bitmap, i.e., *this &=
+        // ~right
+        bmap_t& andnot (const bmap_t& right);
+
+        // return whether two bitmaps are identical or not
+        bool operator== (const bmap_t& right) const {
+            return _length == right._length && _bmap == right._bmap;
+        }
+
+        // Likewise, define whether they are different
+        bool operator!= (const bmap_t& right) const {
+            return !((*this) == right);
+        }
+
+        // bitmaps can be implicitly seen as read-only views
+        operator brow_t () const {
+            return brow_t (_bmap.data (), _length);
+        }
 
         // public services
 
+        // return a pointer to the first word of this bitmap
+        const uint64_t* data () const {
+            return _bmap.data ();
+        }
+
+        // return the number of words of this bitmap
+        size_t nbwords () const {
+            return _bmap.size ();
+        }
+
         // return the number of bits stored in this bitmap
         size_t size () const {
-
-            // since _length is the number of bytes multiply by the number of
-            // bits in a byte
-            return 8*_length;
+            return _length;
         }
 };
 
+// binary bitwise operators are implemented in terms of their compound
+// counterparts
+inline bmap_t operator& (bmap_t left, const bmap_t& right) {
+    return left &= right;
+}
+inline bmap_t operator| (bmap_t left, const bmap_t& right) {
+    return left |= right;
+}
+inline bmap_t operator^ (bmap_t left, const bmap_t& right) {
+    return left ^= right;
+}
+
 #endif // _BMAP_T_H_
 
 // Local Variables:
@@ -0,0 +1,112 @@
+// -*- coding: utf-8 -*-
+// MUXcosttable_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <sáb 28-08-2021 10:31:06.871236593 (1630139466)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// A table of costs stores the cost of every pair of values of different
+// variables violating a soft constraint as adjacency lists of weighted entries
+
+#include "MUXcosttable_t.h"
+
+using namespace std;
+
+// return the overall cost of the i-th and j-th values, or zero if they do not
+// violate any soft constraint
+size_t costtable_t::get (const size_t i, const size_t j) const {
+
+    // first, make sure both indices are within bounds
+    if (i >= _length || j >= _length) {
+        throw out_of_range ("[costtable_t::get] out of bounds");
+    }
+
+    // once frozen, entries are sorted and every pair appears only once
+    row_t row = (*this)[i];
+    if (_frozen) {
+        auto it = lower_bound (row.begin (), row.end (), j,
+                               [] (const entry_t& entry, const size_t value) {
+                                   return entry._value < value;
+                               });
+        return (it != row.end () && it->_value == j) ? it->_cost : 0;
+    }
+
+    // otherwise, add up the costs of all entries of the same pair
+    size_t result = 0;
+    for (auto& entry : row) {
+        if (entry._value == j) {
+            result += entry._cost;
+        }
+    }
+    return result;
+}
+
+// add the given cost to the pair of the i-th and j-th values
+void costtable_t::add (const size_t i, const size_t j, const size_t cost) {
+
+    // make sure the table can be still modified and that the pair is correct
+    if (_frozen) {
+        throw runtime_error ("[costtable_t::add] The table of costs is frozen");
+    }
+    if (i >= _length || j >= _length || i == j) {
+        throw invalid_argument ("[costtable_t::add] Wrong values");
+    }
+    if (max (i, j) > numeric_limits<uint32_t>::max ()) {
+        throw overflow_error ("[costtable_t::add] Index too large");
+    }
+
+    // and store it in the entries of both values
+    _rows[i].push_back (entry_t {uint32_t (j), cost});
+    _rows[j].push_back (entry_t {uint32_t (i), cost});
+}
+
+// sort the entries of every value, add up the costs of repeated pairs and
+// compact all of them into contiguous memory
+void costtable_t::freeze () {
+
+    // freezing a table twice has no effect
+    if (_frozen) {
+        return;
+    }
+
+    // first, sort every row and merge the entries of the same pair, computing
+    // the offset where each row starts in the array of entries
+    _offsets = vector<size_t> (1 + _length, 0);
+    for (size_t i = 0 ; i < _length ; i++) {
+        vector<entry_t>& row = _rows[i];
+        sort (row.begin (), row.end (),
+              [] (const entry_t& left, const entry_t& right) {
+                  return left._value < right._value;
+              });
+        size_t k = 0;
+        for (size_t j = 0 ; j < row.size () ; j++) {
+            if (k && row[k-1]._value == row[j]._value) {
+                row[k-1]._cost += row[j]._cost;
+            } else {
+                row[k++] = row[j];
+            }
+        }
+        row.resize (k);
+        _offsets[i+1] = _offsets[i] + k;
+    }
+
+    // next, copy all rows into the array of entries, releasing the memory of
+    // each row as soon as it is copied
+    _entries.reserve (_offsets[_length]);
+    for (size_t i = 0 ; i < _length ; i++) {
+        _entries.insert (_entries.end (), _rows[i].begin (), _rows[i].end ());
+        vector<entry_t> ().swap (_rows[i]);
+    }
+    vector<vector<entry_t>> ().swap (_rows);
+
+    // and now this table is frozen
+    _frozen = true;
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
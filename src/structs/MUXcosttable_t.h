@@ -0,0 +1,153 @@
+// -*- coding: utf-8 -*-
+// MUXcosttable_t.h
+// -----------------------------------------------------------------------------
+//
+// Started on <sáb 28-08-2021 10:14:52.109384716 (1630138492)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// A table of costs stores the cost of every pair of values of different
+// variables violating a soft constraint as adjacency lists of weighted entries
+
+#ifndef _MUXCOSTTABLE_T_H_
+#define _MUXCOSTTABLE_T_H_
+
+#include<algorithm>
+#include<cstdint>
+#include<limits>
+#include<stdexcept>
+#include<vector>
+
+// Class definition
+//
+// Definition of a table of costs
+class costtable_t {
+
+    public:
+
+        // every entry of an adjacency list stores the index of the other value
+        // (with 32 bits as in the table of mutexes) and the cost of the pair
+        struct entry_t {
+            uint32_t _value;
+            size_t _cost;
+        };
+
+        // Class definition
+        //
+        // A row of a table of costs is a read-only view over the contiguous
+        // sequence of entries of one value
+        class row_t {
+
+            private:
+
+                // INVARIANT: a row consists of pointers to its first and past
+                // the last entry
+                const entry_t* _begin;
+                const entry_t* _end;
+
+            public:
+
+                // Explicit constructor - given the pointers to the first and
+                // past the last entry
+                row_t (const entry_t* begin, const entry_t* end) :
+                    _begin { begin },
+                    _end { end }
+                {}
+
+                // iterators
+                const entry_t* begin () const {
+                    return _begin;
+                }
+                const entry_t* end () const {
+                    return _end;
+                }
+
+                // capacity
+                size_t size () const {
+                    return _end - _begin;
+                }
+                bool empty () const {
+                    return _begin == _end;
+                }
+        };
+
+    private:
+
+        // INVARIANT: while a table of costs is being populated, the entries of
+        // every value are stored in a separate vector, possibly with repeated
+        // values. Once it is frozen, the entries of every value are sorted by
+        // the index of the other value, the costs of repeated pairs are added
+        // up, and all of them are compacted into a single array, the entries
+        // of the i-th value ranging in [_offsets[i], _offsets[i+1])
+        std::vector<std::vector<entry_t>> _rows;
+        std::vector<size_t> _offsets;
+        std::vector<entry_t> _entries;
+
+        // number of values and whether this table has been frozen or not
+        size_t _length;
+        bool _frozen;
+
+    public:
+
+        // The default constructor is strictly forbidden
+        costtable_t () = delete;
+
+        // Explicit constructor - given the number of values. Note that
+        // implicit casting is forbidden
+        explicit costtable_t (const size_t len) :
+            _rows { std::vector<std::vector<entry_t>>(len, std::vector<entry_t>()) },
+            _offsets { std::vector<size_t>() },
+            _entries { std::vector<entry_t>() },
+            _length { len },
+            _frozen { false }
+        {}
+
+        // accessors
+
+        // return the entries of the i-th value
+        row_t operator[] (const size_t i) const {
+            if (_frozen) {
+                return row_t (_entries.data () + _offsets[i],
+                              _entries.data () + _offsets[i+1]);
+            }
+            return row_t (_rows[i].data (), _rows[i].data () + _rows[i].size ());
+        }
+
+        // return the overall cost of the i-th and j-th values, or zero if they
+        // do not violate any soft constraint. Once frozen, this is a binary
+        // search
+        size_t get (const size_t i, const size_t j) const;
+
+        // return whether this table has been frozen or not
+        bool frozen () const {
+            return _frozen;
+        }
+
+        // modifiers
+
+        // add the given cost to the pair of the i-th and j-th values, which is
+        // stored in the entries of both. Once frozen, a table of costs can not
+        // be modified anymore
+        void add (const size_t i, const size_t j, const size_t cost);
+
+        // sort the entries of every value, add up the costs of repeated pairs
+        // and compact all of them into contiguous memory. After freezing the
+        // table, it can not be modified anymore
+        void freeze ();
+
+        // capacity
+
+        // return the number of values in this table
+        size_t size () const {
+            return _length;
+        }
+};
+
+#endif // _MUXCOSTTABLE_T_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,121 @@
+// -*- coding: utf-8 -*-
+// MUXheap_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <jue 19-08-2021 09:16:30.204157793 (1629357390)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Implementation of an indexed binary heap of integers in a fixed range sorted
+// in increasing order of their keys
+
+#include "MUXheap_t.h"
+
+using namespace std;
+
+// move the item at the given location up the heap until the heap property is
+// restored
+void heap_t::_sift_up (size_t loc) {
+
+    size_t item = _heap[loc];
+    while (loc > 0) {
+
+        // if the parent has to precede this item, then stop
+        size_t parent = (loc - 1)/2;
+        if (!_less (item, _heap[parent])) {
+            break;
+        }
+
+        // otherwise, move the parent down
+        _heap[loc] = _heap[parent];
+        _pos[_heap[loc]] = loc;
+        loc = parent;
+    }
+    _heap[loc] = item;
+    _pos[item] = loc;
+}
+
+// move the item at the given location down the heap until the heap property is
+// restored
+void heap_t::_sift_down (size_t loc) {
+
+    size_t item = _heap[loc];
+    while (2*loc + 1 < _heap.size ()) {
+
+        // select the child which has to go first
+        size_t child = 2*loc + 1;
+        if (child + 1 < _heap.size () && _less (_heap[child + 1], _heap[child])) {
+            child++;
+        }
+
+        // if this item has to precede it, then stop
+        if (!_less (_heap[child], item)) {
+            break;
+        }
+
+        // otherwise, move the child up
+        _heap[loc] = _heap[child];
+        _pos[_heap[loc]] = loc;
+        loc = child;
+    }
+    _heap[loc] = item;
+    _pos[item] = loc;
+}
+
+// insert the given item with the given key
+void heap_t::insert (const size_t i, const double key) {
+
+    // make sure the item is not already in the heap
+    if (i >= _pos.size () || contains (i)) {
+        throw invalid_argument ("[heap_t::insert] Wrong item");
+    }
+
+    // add it at the end and move it up
+    _key[i] = key;
+    _heap.push_back (i);
+    _sift_up (_heap.size () - 1);
+}
+
+// remove the given item from the heap
+void heap_t::erase (const size_t i) {
+
+    // make sure the item is in the heap
+    if (i >= _pos.size () || !contains (i)) {
+        throw invalid_argument ("[heap_t::erase] Wrong item");
+    }
+
+    // substitute it with the last item, and restore the heap property
+    size_t loc = _pos[i];
+    _pos[i] = string::npos;
+    size_t last = _heap.back ();
+    _heap.pop_back ();
+    if (loc < _heap.size ()) {
+        _heap[loc] = last;
+        _pos[last] = loc;
+        _sift_up (loc);
+        _sift_down (_pos[last]);
+    }
+}
+
+// update the key of the given item
+void heap_t::update (const size_t i, const double key) {
+
+    // update the key and, if the item is in the heap, move it either up or
+    // down
+    double prev = _key[i];
+    _key[i] = key;
+    if (contains (i)) {
+        if (key < prev) {
+            _sift_up (_pos[i]);
+        } else {
+            _sift_down (_pos[i]);
+        }
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,110 @@
+// -*- coding: utf-8 -*-
+// MUXheap_t.h
+// -----------------------------------------------------------------------------
+//
+// Started on <jue 19-08-2021 09:15:48.611703285 (1629357348)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Implementation of an indexed binary heap of integers in a fixed range sorted
+// in increasing order of their keys
+
+#ifndef _MUXHEAP_T_H_
+#define _MUXHEAP_T_H_
+
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+// Class definition
+//
+// Definition of an indexed heap. Every item in the range [0, n) can be inserted
+// at most once, and its key can be updated in logarithmic time. Ties are broken
+// in favour of the smallest item
+class heap_t {
+
+    private:
+
+        // INVARIANT: a heap consists of a binary heap of items stored in a
+        // vector, the location of every item in the heap (or string::npos if
+        // it is not in the heap) and the key of every item
+        std::vector<size_t> _heap;
+        std::vector<size_t> _pos;
+        std::vector<double> _key;
+
+        // return true if the item i has to precede the item j
+        bool _less (const size_t i, const size_t j) const {
+            return _key[i] < _key[j] || (_key[i] == _key[j] && i < j);
+        }
+
+        // move the item at the given location up/down the heap until the heap
+        // property is restored
+        void _sift_up (size_t loc);
+        void _sift_down (size_t loc);
+
+    public:
+
+        // The default constructor is strictly forbidden
+        heap_t () = delete;
+
+        // Explicit constructor - given the number of items. Note that implicit
+        // casting is forbidden
+        explicit heap_t (const size_t n) :
+            _heap { std::vector<size_t>() },
+            _pos { std::vector<size_t>(n, std::string::npos) },
+            _key { std::vector<double>(n, 0.0) }
+        {}
+
+        // accessors
+
+        // return whether the given item is in the heap or not
+        bool contains (const size_t i) const {
+            return _pos[i] != std::string::npos;
+        }
+
+        // return the key of the given item
+        double get_key (const size_t i) const {
+            return _key[i];
+        }
+
+        // return the item with the smallest key, or string::npos if the heap is
+        // empty
+        size_t top () const {
+            return _heap.empty () ? std::string::npos : _heap[0];
+        }
+
+        // modifiers
+
+        // insert the given item with the given key. If it is already in the
+        // heap an exception is raised
+        void insert (const size_t i, const double key);
+
+        // remove the given item from the heap. If it is not in the heap an
+        // exception is raised
+        void erase (const size_t i);
+
+        // update the key of the given item. If it is not in the heap, only its
+        // key is updated
+        void update (const size_t i, const double key);
+
+        // capacity
+
+        // return the number of items in the heap
+        size_t size () const {
+            return _heap.size ();
+        }
+
+        // return whether the heap is empty or not
+        bool empty () const {
+            return _heap.empty ();
+        }
+};
+
+#endif // _MUXHEAP_T_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
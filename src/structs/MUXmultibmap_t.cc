@@ -11,33 +11,181 @@
 // implementation of an array of bitmaps
 //
 
-#include<stdexcept>
+#include<cstring>
+#include<new>
 
 #include "MUXmultibmap_t.h"
 
+// Explicit constructor - given the length of the array and the number of bits
+// in each entry, all of which are initialized with the given value
+multibmap_t::multibmap_t (const size_t len, const size_t nbbits, const bool value) :
+    _multibmap { nullptr },
+    _length { len },
+    _nbbits { nbbits },
+    _stride { nbbits/64 + size_t (nbbits%64 != 0) }
+{
+
+    // rows spanning at least one cache line (8 words) are padded to a multiple
+    // of the cache line size so that all of them are aligned
+    if (_stride >= 8) {
+        _stride = 8*(_stride/8 + size_t (_stride%8 != 0));
+    }
+
+    // allocate memory for all rows and initialize all bits with the given
+    // value. Note the padding is initialized as well
+    _allocate ();
+    memset (_multibmap.get (), 0, _length*_stride*sizeof (uint64_t));
+    if (value) {
+        for (size_t i = 0 ; i < _length ; i++) {
+            fill_row (i, true);
+        }
+    }
+}
+
+// copy constructor
+multibmap_t::multibmap_t (const multibmap_t& other) :
+    _multibmap { nullptr },
+    _length { other._length },
+    _nbbits { other._nbbits },
+    _stride { other._stride }
+{
+    _allocate ();
+    memcpy (_multibmap.get (), other._multibmap.get (),
+            _length*_stride*sizeof (uint64_t));
+}
+
+// copy assignment
+multibmap_t& multibmap_t::operator=(const multibmap_t& other) {
+
+    // copying is done by copy-constructing a new multibitmap and moving it
+    // into this instance
+    if (this != &other) {
+        *this = multibmap_t (other);
+    }
+    return *this;
+}
+
+// allocate a buffer aligned to a cache line large enough to store the rows of
+// this multibitmap
+void multibmap_t::_allocate () {
+
+    // aligned_alloc requires the size to be a multiple of the alignment. Also,
+    // the buffer is never empty so that the views of empty multibitmaps are
+    // still valid pointers
+    size_t nbytes = _length*_stride*sizeof (uint64_t);
+    nbytes = 64*(1 + nbytes/64);
+    _multibmap.reset (static_cast<uint64_t*> (aligned_alloc (64, nbytes)));
+    if (!_multibmap) {
+        throw bad_alloc ();
+    }
+}
+
 // get the value of the j-th bit of the i-th entry
 bool multibmap_t::get (const size_t i, const size_t j) const {
 
     // first, make sure the value requested is within the length of the bit map
-    if (i >= _multibmap.size ()) {
+    if (i >= _length) {
         throw out_of_range ("[multibmap_t::get] out of bounds");
     }
 
     // if everything went fine then try to get the requested location
-    return _multibmap[i][j];
+    return (*this)[i].get (j);
 }
 
 // set the value of the j-th bit of the i-th entry
 void multibmap_t::set (const size_t i, const size_t j, const bool value) {
 
     // first, make sure the value requested is within the length of the bit map
-    if (i >= _multibmap.size ()) {
+    if (i >= _length || j >= _nbbits) {
         throw out_of_range ("[multibmap_t::set] out of bounds");
     }
 
-    // if everything went fine then try to set the requested value in the
-    // specified location
-    _multibmap[i].set (j, value);
+    // if everything went fine then set the requested value in the specified
+    // location
+    if (value) {
+        _row (i)[j/64] |= uint64_t (1) << (j%64);
+    } else {
+        _row (i)[j/64] &= ~(uint64_t (1) << (j%64));
+    }
+}
+
+// bitwise and of the i-th row with the given one
+void multibmap_t::and_row (const size_t i, const brow_t& right) {
+
+    // first, make sure the operation is well defined
+    if (i >= _length || right.size () != _nbbits) {
+        throw invalid_argument ("[multibmap_t::and_row] Wrong row");
+    }
+    uint64_t* row = _row (i);
+    const uint64_t* words = right.data ();
+    for (size_t j = 0 ; j < right.nbwords () ; j++) {
+        row[j] &= words[j];
+    }
+}
+
+// bitwise or of the i-th row with the given one
+void multibmap_t::or_row (const size_t i, const brow_t& right) {
+
+    // first, make sure the operation is well defined
+    if (i >= _length || right.size () != _nbbits) {
+        throw invalid_argument ("[multibmap_t::or_row] Wrong row");
+    }
+    uint64_t* row = _row (i);
+    const uint64_t* words = right.data ();
+    for (size_t j = 0 ; j < right.nbwords () ; j++) {
+        row[j] |= words[j];
+    }
+}
+
+// bitwise xor of the i-th row with the given one
+void multibmap_t::xor_row (const size_t i, const brow_t& right) {
+
+    // first, make sure the operation is well defined
+    if (i >= _length || right.size () != _nbbits) {
+        throw invalid_argument ("[multibmap_t::xor_row] Wrong row");
+    }
+    uint64_t* row = _row (i);
+    const uint64_t* words = right.data ();
+    for (size_t j = 0 ; j < right.nbwords () ; j++) {
+        row[j] ^= words[j];
+    }
+}
+
+// reset all bits of the i-th row which are set in the given one
+void multibmap_t::andnot_row (const size_t i, const brow_t& right) {
+
+    // first, make sure the operation is well defined
+    if (i >= _length || right.size () != _nbbits) {
+        throw invalid_argument ("[multibmap_t::andnot_row] Wrong row");
+    }
+    uint64_t* row = _row (i);
+    const uint64_t* words = right.data ();
+    for (size_t j = 0 ; j < right.nbwords () ; j++) {
+        row[j] &= ~words[j];
+    }
+}
+
+// set all bits of the i-th row to the given value
+void multibmap_t::fill_row (const size_t i, const bool value) {
+
+    // first, make sure the row exists
+    if (i >= _length) {
+        throw out_of_range ("[multibmap_t::fill_row] out of bounds");
+    }
+
+    // there is nothing to do in rows without bits
+    size_t nbwords = _nbbits/64 + size_t (_nbbits%64 != 0);
+    if (!nbwords) {
+        return;
+    }
+
+    // fill in all words, and then make sure that bits beyond the length of the
+    // row remain null
+    uint64_t* row = _row (i);
+    for (size_t j = 0 ; j < nbwords ; j++) {
+        row[j] = value ? ~uint64_t (0) : 0;
+    }
+    row[nbwords-1] &= _lmask ();
 }
 
 
@@ -12,7 +12,10 @@
 #ifndef _MULTIBMAP_T_H_
 #define _MULTIBMAP_T_H_
 
-#include<vector>
+#include<cstdint>
+#include<cstdlib>
+#include<memory>
+#include<stdexcept>
 
 #include "MUXbmap_t.h"
 
@@ -24,9 +27,44 @@ class multibmap_t {
 
     private:
 
-        // INVARIANT: A multimap consists of an array of bitmaps which are
-        // stored as a vector bitmaps
-        vector<bmap_t> _multibmap;
+        // the deleter of the buffer releases memory allocated with
+        // aligned_alloc
+        struct _deleter_t {
+            void operator() (uint64_t* ptr) const {
+                free (ptr);
+            }
+        };
+
+        // INVARIANT: A multibitmap consists of an array of bitmaps (rows) all
+        // of the same length. All rows are stored contiguously in a single
+        // buffer aligned to a cache line (64 bytes), the i-th row starting at
+        // the word i*_stride, so that traversing rows in order is a linear scan
+        // over memory. Rows spanning at least one full cache line are padded
+        // to a multiple of cache lines so that every one starts at the
+        // beginning of a cache line. Bits beyond the length of each row are
+        // always zero
+        unique_ptr<uint64_t[], _deleter_t> _multibmap;
+
+        // number of rows, number of bits per row, and number of words between
+        // the beginning of two consecutive rows
+        size_t _length;
+        size_t _nbbits;
+        size_t _stride;
+
+        // allocate a buffer aligned to a cache line large enough to store the
+        // rows of this multibitmap
+        void _allocate ();
+
+        // return a mask with the bits of the last word of each row which are
+        // within its length
+        uint64_t _lmask () const {
+            return (_nbbits%64) ? (uint64_t (1) << (_nbbits%64)) - 1 : ~uint64_t (0);
+        }
+
+        // return a pointer to the first word of the i-th row
+        uint64_t* _row (const size_t i) {
+            return _multibmap.get () + i*_stride;
+        }
 
     public:
 
@@ -34,17 +72,25 @@ class multibmap_t {
         multibmap_t () = delete;
 
         // Explicit constructor - given the length of the array and the number
-        // of bits in each entry, all of which are initially enabled
-        multibmap_t (const size_t len, const size_t nbbits) :
-            _multibmap { vector<bmap_t>(len, bmap_t (nbbits)) }
-        {}
+        // of bits in each entry, all of which are initialized with the given
+        // value
+        multibmap_t (const size_t len, const size_t nbbits, const bool value=false);
+
+        // copy and move constructors
+        multibmap_t (const multibmap_t& other);
+        multibmap_t (multibmap_t&&) = default;
+
+        // copy and move assignments
+        multibmap_t& operator=(const multibmap_t& other);
+        multibmap_t& operator=(multibmap_t&&) = default;
 
         // accessors
 
-        // get the i-th vector. This can be used to simulate 2-dimensional
-        // access to the underlying bits
-        const bmap_t& operator[] (const size_t i) const {
-            return _multibmap[i];
+        // get a view of the i-th row. This can be used to simulate
+        // 2-dimensional access to the underlying bits. No bounds checking is
+        // performed
+        brow_t operator[] (const size_t i) const {
+            return brow_t (_multibmap.get () + i*_stride, _nbbits);
         }
 
         // get the value of the j-th bit of the i-th entry
@@ -53,9 +99,33 @@ class multibmap_t {
         // set the value of the j-th bit of the i-th entry
         void set (const size_t i, const size_t j, const bool value);
 
+        // whole-row operations. All of them require the given row (or bitmap)
+        // to have the same length than the rows of this multibitmap
+
+        // bitwise and of the i-th row with the given one
+        void and_row (const size_t i, const brow_t& right);
+
+        // bitwise or of the i-th row with the given one
+        void or_row (const size_t i, const brow_t& right);
+
+        // bitwise xor of the i-th row with the given one
+        void xor_row (const size_t i, const brow_t& right);
+
+        // reset all bits of the i-th row which are set in the given one
+        void andnot_row (const size_t i, const brow_t& right);
+
+        // set all bits of the i-th row to the given value
+        void fill_row (const size_t i, const bool value);
+
         // return the number of entries of this multibitmap
         size_t size () const {
-            return _multibmap.size ();
+            return _length;
+        }
+
+        // return the number of words between the beginning of two consecutive
+        // rows
+        size_t stride () const {
+            return _stride;
         }
 };
 
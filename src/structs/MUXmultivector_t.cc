@@ -12,32 +12,66 @@
 
 #include "MUXmultivector_t.h"
 
+// compact all entries into a single contiguous array of neighbours with a
+// separate array of offsets. All entries are sorted in increasing order and
+// duplicates are removed. After freezing the multivector, it can not be
+// modified anymore
+void multivector_t::freeze () {
+
+    // freezing a multivector twice has no effect
+    if (_frozen) {
+        return;
+    }
+
+    // first, sort and deduplicate every entry and compute the offset where
+    // each one starts in the array of neighbours
+    _offsets = std::vector<size_t> (1 + _length, 0);
+    for (size_t i = 0 ; i < _length ; i++) {
+        std::sort (_mutex[i].begin (), _mutex[i].end ());
+        _mutex[i].erase (std::unique (_mutex[i].begin (), _mutex[i].end ()),
+                         _mutex[i].end ());
+        _offsets[i+1] = _offsets[i] + _mutex[i].size ();
+    }
+
+    // next, copy all entries into the array of neighbours, releasing the
+    // memory of each entry as soon as it is copied
+    _neighbours.reserve (_offsets[_length]);
+    for (size_t i = 0 ; i < _length ; i++) {
+        _neighbours.insert (_neighbours.end (), _mutex[i].begin (), _mutex[i].end ());
+        std::vector<uint32_t> ().swap (_mutex[i]);
+    }
+    std::vector<std::vector<uint32_t>> ().swap (_mutex);
+
+    // and now this multivector is frozen
+    _frozen = true;
+}
+
 // return true whether two multivectors are identical or not. This service is
 // provided for testing purposes
 bool multivector_t::operator==(const multivector_t& right) const {
 
     // first and overall, verify they both have the same number of items
-    if (_mutex.size () != right.size ()) {
+    if (_length != right.size ()) {
         return false;
     }
 
     // next we test equality explicitly
 
     // first, check the vectors separately one by one
-    for (auto i = 0 ; i < _mutex.size () ; i++) {
+    for (auto i = 0 ; i < _length ; i++) {
 
         // check that both multivectors have vectors of the same size at
         // the i-th location
-        if (_mutex[i].size () != right[i].size ()) {
+        auto lrow = (*this)[i];
+        auto rrow = right[i];
+        if (lrow.size () != rrow.size ()) {
             return false;
         }
 
         // verify also the contents. Note that items are expected to be in
         // precisely the same order in both multivectors
-        for (auto j = 0 ; j < _mutex[i].size () ; j++) {
-            if (_mutex[i][j] != right[i][j]) {
-                return false;
-            }
+        if (!std::equal (lrow.begin (), lrow.end (), rrow.begin ())) {
+            return false;
         }
     }
 
@@ -14,6 +14,9 @@
 #define _MUXMULTIVECTOR_H_
 
 #include<algorithm>
+#include<cstdint>
+#include<limits>
+#include<stdexcept>
 #include<vector>
 
 // Class definition
@@ -21,11 +24,71 @@
 // Definition of a multivector
 class multivector_t {
 
+    public:
+
+        // Class definition
+        //
+        // A row of a multivector is a read-only view over the contiguous
+        // sequence of indices stored in one of its entries
+        class row_t {
+
+            private:
+
+                // INVARIANT: a row consists of pointers to its first and past
+                // the last element
+                const uint32_t* _begin;
+                const uint32_t* _end;
+
+            public:
+
+                // Explicit constructor - given the pointers to the first and
+                // past the last element
+                row_t (const uint32_t* begin, const uint32_t* end) :
+                    _begin { begin },
+                    _end { end }
+                {}
+
+                // accessors
+
+                // the random access operator does not perform any bounds
+                // checking
+                size_t operator[] (const size_t i) const {
+                    return _begin[i];
+                }
+
+                // iterators
+                const uint32_t* begin () const {
+                    return _begin;
+                }
+                const uint32_t* end () const {
+                    return _end;
+                }
+
+                // capacity
+                size_t size () const {
+                    return _end - _begin;
+                }
+                bool empty () const {
+                    return _begin == _end;
+                }
+        };
+
     private:
 
         // INVARIANT: A multivector consists of an array of vectors that
-        // contains the mutexes of each entry
-        std::vector<std::vector<size_t>> _mutex;
+        // contains the mutexes of each entry. While it is being populated,
+        // every entry is stored in a separate vector. Once it is frozen, all
+        // entries are sorted, deduplicated and compacted into a single array of
+        // neighbours, the i-th entry ranging in [_offsets[i], _offsets[i+1]).
+        // In both cases indices are stored with 32 bits
+        std::vector<std::vector<uint32_t>> _mutex;
+        std::vector<size_t> _offsets;
+        std::vector<uint32_t> _neighbours;
+
+        // number of entries and whether this multivector has been frozen or
+        // not
+        size_t _length;
+        bool _frozen;
 
     public:
 
@@ -33,39 +96,77 @@ class multivector_t {
         multivector_t () = delete;
 
         // default copy and move constructors
-        multivector_t (multivector_t&) = default;
+        multivector_t (const multivector_t&) = default;
         multivector_t (multivector_t&&) = default;
 
         // default copy and move assignments
-        multivector_t& operator=(multivector_t&) = default;
+        multivector_t& operator=(const multivector_t&) = default;
         multivector_t& operator=(multivector_t&&) = default;
 
         // Explicit constructor - given the length of the array. Note that
         // implicit casting is forbidden
         explicit multivector_t (const size_t len) :
-            _mutex { std::vector<std::vector<size_t>>(len, std::vector<size_t>()) }
+            _mutex { std::vector<std::vector<uint32_t>>(len, std::vector<uint32_t>()) },
+            _offsets { std::vector<size_t>() },
+            _neighbours { std::vector<uint32_t>() },
+            _length { len },
+            _frozen { false }
         {}
 
         // accessors
 
         // Return true if and only if the specified value is found in the i-th
-        // vector. the following service is provided solely for testing purposes
+        // vector. Once the multivector is frozen this is a binary search
         bool find (const size_t i, const size_t value) const {
-            return (std::find (_mutex[i].begin (),
-                               _mutex[i].end (),
-                               value) != _mutex[i].end ());
+            auto row = (*this)[i];
+            if (_frozen) {
+                return std::binary_search (row.begin (), row.end (), value);
+            }
+            return (std::find (row.begin (), row.end (), value) != row.end ());
         }
 
         // get the i-th vector
-        const std::vector<size_t>& operator[] (const size_t i) const {
-            return _mutex[i];
+        row_t operator[] (const size_t i) const {
+            if (_frozen) {
+                return row_t (_neighbours.data () + _offsets[i],
+                              _neighbours.data () + _offsets[i+1]);
+            }
+            return row_t (_mutex[i].data (), _mutex[i].data () + _mutex[i].size ());
+        }
+
+        // return whether this multivector has been frozen or not
+        bool frozen () const {
+            return _frozen;
         }
 
-        // set the value j in the i-th vector
+        // set the value j in the i-th vector. Once frozen, a multivector can
+        // not be modified anymore
         void set (const size_t i, const size_t j) {
+            if (_frozen) {
+                throw std::runtime_error ("[multivector_t::set] The multivector is frozen");
+            }
+            if (j > std::numeric_limits<uint32_t>::max ()) {
+                throw std::overflow_error ("[multivector_t::set] Index too large");
+            }
             _mutex[i].push_back (j);
         }
 
+        // reserve room in the i-th vector for n more values, so that setting
+        // them does not reallocate it. Once frozen, a multivector can not be
+        // modified anymore
+        void reserve (const size_t i, const size_t n) {
+            if (_frozen) {
+                throw std::runtime_error ("[multivector_t::reserve] The multivector is frozen");
+            }
+            _mutex[i].reserve (_mutex[i].size () + n);
+        }
+
+        // compact all entries into a single contiguous array of neighbours
+        // with a separate array of offsets. All entries are sorted in
+        // increasing order and duplicates are removed. After freezing the
+        // multivector, it can not be modified anymore
+        void freeze ();
+
         // return whether two multivectors are identical or not. This service is
         // provided for testing purposes
         bool operator==(const multivector_t& right) const;
@@ -78,7 +179,7 @@ class multivector_t {
 
         // return the number of entries in the multivector
         size_t size () const {
-            return _mutex.size ();
+            return _length;
         }
 };
 
@@ -0,0 +1,318 @@
+// -*- coding: utf-8 -*-
+// MUXmutextable_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 15-08-2021 18:49:03.119275410 (1629046143)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// A table of mutexes stores all mutexes between values of different variables
+// either as adjacency lists or as bit matrices, depending on the density of
+// the mutexes between every pair of variables
+
+#include "MUXmutextable_t.h"
+
+using namespace std;
+
+// Explicit constructor - tables of mutexes are created for the domains of all
+// variables in a table of variables
+mutextable_t::mutextable_t (const vartable_t& vartable) :
+    _first { vector<size_t>() },
+    _var { vector<uint32_t>() },
+    _sparse { multivector_t (vartable.size () ? 1 + vartable.get_last (vartable.size ()-1) : 0) },
+    _dense { vector<_dense_t>() },
+    _compat { vector<_dense_t>() },
+    _blocks { vector<_block_t>() },
+    _varblocks { vector<vector<size_t>>(vartable.size (), vector<size_t>()) }
+{
+
+    // record the first value of every variable and the variable every value
+    // belongs to. Note that domains are known to be contiguous
+    for (size_t i = 0 ; i < vartable.size () ; i++) {
+        _first.push_back (vartable.get_first (i));
+        for (auto j = vartable.get_first (i) ; j <= vartable.get_last (i) ; j++) {
+            _var.push_back (i);
+        }
+    }
+    _first.push_back (_var.size ());
+}
+
+// return the block defined over two variables or string::npos if none exists
+size_t mutextable_t::_find_block (const size_t var1, const size_t var2) const {
+
+    // just look for the block among those the first variable participates in
+    for (auto b : _varblocks[var1]) {
+        if ((_blocks[b]._var1 == var1 && _blocks[b]._var2 == var2) ||
+            (_blocks[b]._var1 == var2 && _blocks[b]._var2 == var1)) {
+            return b;
+        }
+    }
+
+    // at this point, no block exists over both variables
+    return string::npos;
+}
+
+// return true if the i-th and j-th values are mutex
+bool mutextable_t::find (const size_t i, const size_t j) const {
+
+    // first, make sure both indices are within bounds
+    if (i >= _var.size () || j >= _var.size ()) {
+        throw out_of_range ("[mutextable_t::find] out of bounds");
+    }
+
+    // if there is no block between the variables of both values, they are not
+    // mutex
+    size_t b = _find_block (_var[i], _var[j]);
+    if (b == string::npos) {
+        return false;
+    }
+
+    // otherwise look for the mutex in the representation of its block
+    if (_blocks[b]._dense == string::npos) {
+        return _sparse.find (i, j);
+    }
+    return _row (_blocks[b], i)[j - _base (_var[j])];
+}
+
+// return the number of values which are mutex with the i-th value
+size_t mutextable_t::degree (const size_t i) const {
+
+    // first, make sure the index is within bounds
+    if (i >= _var.size ()) {
+        throw out_of_range ("[mutextable_t::degree] out of bounds");
+    }
+
+    // the degree is the number of mutexes in the adjacency lists plus the
+    // number of bits set in the rows of all dense blocks
+    size_t result = _sparse[i].size ();
+    for (auto b : _varblocks[_var[i]]) {
+        if (_blocks[b]._dense != string::npos) {
+            result += _row (_blocks[b], i).count ();
+        }
+    }
+    return result;
+}
+
+// return the index of the first value of the other variable of the b-th block
+// which is set in the given bitmap and is not mutex with the i-th value, or
+// string::npos if there is none
+size_t mutextable_t::find_support (const size_t i, const size_t b, const bmap_t& live) const {
+
+    // compute the range of values of the other variable of this block
+    const _block_t& block = _blocks[b];
+    size_t var = (_var[i] == block._var1) ? block._var2 : block._var1;
+    size_t first = _first[var], last = _first[var+1] - 1;
+
+    // if the block has bitmaps of compatible values, either because it is
+    // dense or because it is sparse over small domains, a support is a value
+    // set in both. Because bits beyond the domain of the other variable are
+    // null, no masking is needed at all
+    if (block._compat != string::npos) {
+        brow_t row = _row (_compat[block._compat], block, i);
+        const uint64_t* words = live.data () + first/64;
+        const uint64_t* rwords = row.data ();
+        size_t nbwords = row.nbwords ();
+        size_t w = 0;
+#ifdef __AVX2__
+        for ( ; w + 4 <= nbwords ; w += 4) {
+            __m256i word = _mm256_and_si256 (_mm256_loadu_si256 ((const __m256i*) (words + w)),
+                                             _mm256_loadu_si256 ((const __m256i*) (rwords + w)));
+            if (!_mm256_testz_si256 (word, word)) {
+                break;
+            }
+        }
+#endif
+        for ( ; w < nbwords ; w++) {
+            uint64_t word = words[w] & rwords[w];
+            if (word) {
+                return 64*(first/64 + w) + __builtin_ctzll (word);
+            }
+        }
+        return string::npos;
+    }
+
+    // sparse blocks look for the first value which is not in the adjacency
+    // list of the i-th value. Once frozen, adjacency lists are sorted and
+    // they are traversed only once
+    if (block._dense == string::npos) {
+        multivector_t::row_t row = _sparse[i];
+        const uint32_t* it = row.begin ();
+        for (auto j = first ; j <= last ; j++) {
+            if (!live[j]) {
+                continue;
+            }
+            if (_sparse.frozen ()) {
+                it = lower_bound (it, row.end (), j);
+                if (it == row.end () || *it != j) {
+                    return j;
+                }
+            } else if (!_sparse.find (i, j)) {
+                return j;
+            }
+        }
+        return string::npos;
+    }
+
+    // dense blocks compute the values which are set in the bitmap but not in
+    // the row of the i-th value a whole word at a time. Because rows are
+    // aligned with the words of the bitmap, only the bits of the first and last
+    // words beyond the range of values of the other variable have to be masked
+    brow_t row = _row (block, i);
+    const uint64_t* words = live.data ();
+    const uint64_t* rwords = row.data ();
+    for (auto w = first/64 ; w <= last/64 ; w++) {
+        uint64_t word = words[w] & ~rwords[w - first/64];
+        if (w == first/64) {
+            word &= ~uint64_t (0) << (first%64);
+        }
+        if (w == last/64 && last%64 != 63) {
+            word &= (uint64_t (1) << (last%64 + 1)) - 1;
+        }
+        if (word) {
+            return 64*w + __builtin_ctzll (word);
+        }
+    }
+    return string::npos;
+}
+
+// create the bit matrices with the compatible values of the given block
+mutextable_t::_dense_t mutextable_t::_make_compat (const _block_t& block) const {
+
+    // initially, all values of the other variable are compatible. Bits
+    // preceding the first value of the other variable are reset
+    size_t n1 = _first[block._var1+1] - _first[block._var1];
+    size_t n2 = _first[block._var2+1] - _first[block._var2];
+    _dense_t compat {multibmap_t (n1, _first[block._var2]%64 + n2, true),
+                     multibmap_t (n2, _first[block._var1]%64 + n1, true)};
+    for (auto k = 0 ; k < 2 ; k++) {
+        multibmap_t& rows = k ? compat._rows2 : compat._rows1;
+        size_t other = k ? block._var1 : block._var2;
+        for (size_t i = 0 ; i < rows.size () ; i++) {
+            for (size_t j = 0 ; j < _first[other]%64 ; j++) {
+                rows.set (i, j, false);
+            }
+        }
+    }
+
+    // and next, reset all mutexes of every value, which are found either in
+    // the rows of the dense block or in the adjacency lists
+    for (auto k = 0 ; k < 2 ; k++) {
+        size_t var = k ? block._var2 : block._var1;
+        size_t other = k ? block._var1 : block._var2;
+        multibmap_t& rows = k ? compat._rows2 : compat._rows1;
+        for (auto i = _first[var] ; i < _first[var+1] ; i++) {
+            if (block._dense != string::npos) {
+                rows.andnot_row (i - _first[var], _row (block, i));
+                continue;
+            }
+            multivector_t::row_t row = _sparse[i];
+            for (auto it = lower_bound (row.begin (), row.end (), _first[other]) ;
+                 it != row.end () && *it < _first[other+1] ; ++it) {
+                rows.set (i - _first[var], *it - _base (other), false);
+            }
+        }
+    }
+    return compat;
+}
+
+// freeze the adjacency lists of this table and compute the bitmaps of
+// compatible values
+void mutextable_t::freeze () {
+
+    // tables can be frozen only once
+    if (frozen ()) {
+        return;
+    }
+
+    // first, compact the adjacency lists so that they are sorted
+    _sparse.freeze ();
+
+    // next, compute the bitmaps of compatible values of all dense blocks and
+    // all sparse blocks defined over small domains
+    for (auto& block : _blocks) {
+        size_t n1 = _first[block._var1+1] - _first[block._var1];
+        size_t n2 = _first[block._var2+1] - _first[block._var2];
+        if (block._dense != string::npos || (n1 <= _max_compat && n2 <= _max_compat)) {
+            block._compat = _compat.size ();
+            _compat.push_back (_make_compat (block));
+        }
+    }
+}
+
+// add all mutexes between the values of var1 and var2 given in a bit matrix.
+// The mutexes are stored as a dense block if dense is true, and in the
+// adjacency lists otherwise. In case the block over var1 and var2 already
+// exists, the mutexes are added to it with its current representation.
+void mutextable_t::add (const size_t var1, const size_t var2,
+                        const multibmap_t& mutexes, const bool dense) {
+
+    // first, make sure the table can be still modified and that the
+    // dimensions of the bit matrix are correct
+    if (frozen ()) {
+        throw runtime_error ("[mutextable_t::add] The table of mutexes is frozen");
+    }
+    if (var1 >= _varblocks.size () || var2 >= _varblocks.size () || var1 == var2) {
+        throw invalid_argument ("[mutextable_t::add] Wrong variables");
+    }
+    size_t n1 = _first[var1+1] - _first[var1];
+    size_t n2 = _first[var2+1] - _first[var2];
+    if (mutexes.size () != n1 ||
+        (n1 > 0 && mutexes[0].size () != _first[var2]%64 + n2)) {
+        throw invalid_argument ("[mutextable_t::add] Wrong dimensions");
+    }
+
+    // get the block of both variables and, if it does not exist yet, create
+    // it now
+    size_t b = _find_block (var1, var2);
+    if (b == string::npos) {
+
+        // in case the block is dense, create the bit matrices with the rows
+        // of the values of each variable
+        size_t idx = string::npos;
+        if (dense) {
+            idx = _dense.size ();
+            _dense.push_back (_dense_t {multibmap_t (n1, _first[var2]%64 + n2),
+                                        multibmap_t (n2, _first[var1]%64 + n1)});
+        }
+
+        // and register the new block
+        b = _blocks.size ();
+        _blocks.push_back (_block_t {var1, var2, idx, string::npos});
+        _varblocks[var1].push_back (b);
+        _varblocks[var2].push_back (b);
+    }
+
+    // now, add every mutex to the block. Note that the block could have been
+    // created with the variables in the reverse order
+    const _block_t& block = _blocks[b];
+    for (size_t i = 0 ; i < n1 ; i++) {
+        brow_t row = mutexes[i];
+        for (auto j = row.find_first () ; j != string::npos ; j = row.find_next (j)) {
+
+            // compute the index of both values
+            size_t val1 = _first[var1] + i;
+            size_t val2 = _base (var2) + j;
+
+            // sparse blocks store every mutex in both adjacency lists
+            if (block._dense == string::npos) {
+                _sparse.set (val1, val2);
+                _sparse.set (val2, val1);
+                continue;
+            }
+
+            // dense blocks store them in the rows of both values
+            _dense_t& matrices = _dense[block._dense];
+            size_t u = (block._var1 == var1) ? val1 : val2;
+            size_t v = (block._var1 == var1) ? val2 : val1;
+            matrices._rows1.set (u - _first[block._var1], v - _base (block._var2), true);
+            matrices._rows2.set (v - _first[block._var2], u - _base (block._var1), true);
+        }
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
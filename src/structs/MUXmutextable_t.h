@@ -0,0 +1,316 @@
+// -*- coding: utf-8 -*-
+// MUXmutextable_t.h
+// -----------------------------------------------------------------------------
+//
+// Started on <dom 15-08-2021 18:42:17.204918733 (1629045737)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// A table of mutexes stores all mutexes between values of different variables
+// either as adjacency lists or as bit matrices, depending on the density of
+// the mutexes between every pair of variables
+
+#ifndef _MUXMUTEXTABLE_T_H_
+#define _MUXMUTEXTABLE_T_H_
+
+#include<algorithm>
+#include<cstdint>
+#ifdef __AVX2__
+#include<immintrin.h>
+#endif
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+#include "MUXbmap_t.h"
+#include "MUXmultibmap_t.h"
+#include "MUXmultivector_t.h"
+#include "MUXvartable_t.h"
+
+// Class definition
+//
+// Definition of a table of mutexes
+class mutextable_t {
+
+    private:
+
+        struct _block_t {
+
+            // INVARIANT: a block stores all mutexes between the values of two
+            // variables. If the block is dense, its mutexes are stored in two
+            // bit matrices (with the rows of var1 and var2 respectively) and
+            // _dense is its index in the vector of dense blocks; otherwise,
+            // all mutexes are stored in the adjacency lists of the sparse
+            // multivector and _dense takes the value string::npos. Once the
+            // table is frozen, _compat is the index of the bit matrices with
+            // the compatible values of the block, if any, or string::npos
+            size_t _var1, _var2;
+            size_t _dense;
+            size_t _compat;
+        };
+
+        struct _dense_t {
+
+            // INVARIANT: every row of a dense block stores the mutexes of one
+            // value of a variable with all the values of the other one. Bits
+            // are shifted so that they are aligned with the words of a bitmap
+            // defined over all values: the value first+k of the other variable
+            // is stored in the bit first%64+k. This way, rows can be directly
+            // operated with the words of a bitmap indexed by values, e.g., the
+            // statuses of all values
+            multibmap_t _rows1, _rows2;
+        };
+
+        // INVARIANT: a table of mutexes records the index of the first value
+        // of every variable (along with the overall number of values in the
+        // last position) and the variable every value belongs to
+        std::vector<size_t> _first;
+        std::vector<uint32_t> _var;
+
+        // mutexes of all sparse blocks are stored in adjacency lists. Dense
+        // blocks are stored separately
+        multivector_t _sparse;
+        std::vector<_dense_t> _dense;
+
+        // when the table is frozen, the complement of every block, i.e., the
+        // values of the other variable compatible with every value, is stored
+        // as bit matrices aligned as dense blocks. Bits of values beyond the
+        // domain of the other variable are always null. This is done for all
+        // dense blocks and for all sparse blocks whose domains do not exceed
+        // the following number of values
+        std::vector<_dense_t> _compat;
+        static constexpr size_t _max_compat = 512;
+
+        // the table of mutexes records all blocks, i.e., pairs of variables
+        // with mutexes, and also the blocks every variable participates in
+        std::vector<_block_t> _blocks;
+        std::vector<std::vector<size_t>> _varblocks;
+
+        // return the block defined over two variables or string::npos if none
+        // exists
+        size_t _find_block (const size_t var1, const size_t var2) const;
+
+        // return a view of the row of the dense block b with all mutexes of
+        // the value i
+        brow_t _row (const _block_t& block, const size_t i) const {
+            return _row (_dense[block._dense], block, i);
+        }
+
+        // return a view of the row of the value i in the given bit matrices
+        // of a block
+        brow_t _row (const _dense_t& dense, const _block_t& block, const size_t i) const {
+            if (_var[i] == block._var1) {
+                return dense._rows1[i - _first[block._var1]];
+            }
+            return dense._rows2[i - _first[block._var2]];
+        }
+
+        // create the bit matrices with the compatible values of the given
+        // block
+        _dense_t _make_compat (const _block_t& block) const;
+
+        // return the index of the value stored in the first bit of the rows
+        // with the mutexes of the values of the variable var
+        size_t _base (const size_t var) const {
+            return 64*(_first[var]/64);
+        }
+
+    public:
+
+        // The default constructor is strictly forbidden
+        mutextable_t () = delete;
+
+        // Explicit constructor - tables of mutexes are created for the
+        // domains of all variables in a table of variables. Note that
+        // implicit casting is forbidden
+        explicit mutextable_t (const vartable_t& vartable);
+
+        // default copy and move constructors
+        mutextable_t (const mutextable_t&) = default;
+        mutextable_t (mutextable_t&&) = default;
+
+        // accessors
+
+        // return the variable the i-th value belongs to
+        size_t get_var (const size_t i) const {
+            return _var[i];
+        }
+
+        // return the adjacency lists with all mutexes of sparse blocks. This
+        // service is provided for testing purposes
+        const multivector_t& get_multivector () const {
+            return _sparse;
+        }
+
+        // return whether the block defined over two variables is dense or
+        // not. If there are no mutexes between them, false is returned
+        bool dense (const size_t var1, const size_t var2) const {
+            size_t block = _find_block (var1, var2);
+            return block != std::string::npos && _blocks[block]._dense != std::string::npos;
+        }
+
+        // return true if the i-th and j-th values are mutex
+        bool find (const size_t i, const size_t j) const;
+
+        // return the number of values which are mutex with the i-th value
+        size_t degree (const size_t i) const;
+
+        // invoke the given function with the index of every value which is
+        // mutex with the i-th value
+        template<typename Function>
+        void for_each (const size_t i, Function func) const {
+
+            // first, process all mutexes stored in the adjacency lists
+            for (auto j : _sparse[i]) {
+                func (j);
+            }
+
+            // next, process the rows of all dense blocks this value
+            // participates in
+            for (auto b : _varblocks[_var[i]]) {
+                const _block_t& block = _blocks[b];
+                if (block._dense == std::string::npos) {
+                    continue;
+                }
+                brow_t row = _row (block, i);
+                size_t base = _base (_var[i] == block._var1 ? block._var2 : block._var1);
+                for (auto j = row.find_first () ; j != std::string::npos ; j = row.find_next (j)) {
+                    func (base + j);
+                }
+            }
+        }
+
+        // invoke the given function with the index of every value which is
+        // mutex with the i-th value and whose bit is set in the given bitmap
+        // indexed by values, e.g., the statuses of all values. Mutexes of
+        // dense blocks are computed a whole word at a time. Note the function
+        // is allowed to modify the bitmap
+        template<typename Function>
+        void for_each (const size_t i, const bmap_t& live, Function func) const {
+
+            // first, process all mutexes stored in the adjacency lists
+            for (auto j : _sparse[i]) {
+                if (live[j]) {
+                    func (j);
+                }
+            }
+
+            // next, intersect the rows of all dense blocks with the bitmap
+            const uint64_t* words = live.data ();
+            for (auto b : _varblocks[_var[i]]) {
+                const _block_t& block = _blocks[b];
+                if (block._dense == std::string::npos) {
+                    continue;
+                }
+                brow_t row = _row (block, i);
+                size_t base = _base (_var[i] == block._var1 ? block._var2 : block._var1);
+                const uint64_t* rwords = row.data ();
+                for (size_t w = 0 ; w < row.nbwords () ; w++) {
+                    uint64_t word = rwords[w] & words[base/64 + w];
+                    while (word) {
+                        func (base + 64*w + __builtin_ctzll (word));
+                        word &= word - 1;
+                    }
+                }
+            }
+        }
+
+        // return the number of blocks of this table
+        size_t nbblocks () const {
+            return _blocks.size ();
+        }
+
+        // return the indices of all blocks the given variable participates in
+        const std::vector<size_t>& get_blocks (const size_t var) const {
+            return _varblocks[var];
+        }
+
+        // return the index of the block defined over two variables or
+        // string::npos if none exists
+        size_t find_block (const size_t var1, const size_t var2) const {
+            return _find_block (var1, var2);
+        }
+
+        // return the first and second variable of the b-th block
+        size_t get_var1 (const size_t b) const {
+            return _blocks[b]._var1;
+        }
+        size_t get_var2 (const size_t b) const {
+            return _blocks[b]._var2;
+        }
+
+        // return the index of the first value of the other variable of the
+        // b-th block which is set in the given bitmap indexed by values and is
+        // not mutex with the i-th value, i.e., a support of the i-th value. If
+        // there is none, string::npos is returned. The i-th value has to
+        // belong to one of the variables of the block. Once frozen, supports
+        // are computed with the bitmap of compatible values of the i-th value
+        // (if any), i.e., as a bitwise and with the given bitmap followed by a
+        // non-zero test, four words at a time if AVX2 is available.
+        // Otherwise, supports in dense blocks are computed a whole word at a
+        // time
+        size_t find_support (const size_t i, const size_t b, const bmap_t& live) const;
+
+        // return whether the b-th block has bitmaps of compatible values
+        bool compat (const size_t b) const {
+            return _blocks[b]._compat != std::string::npos;
+        }
+
+        // return a view of the bitmap with the values of the other variable
+        // of the b-th block which are compatible with the i-th value, aligned
+        // as the rows of dense blocks. The b-th block has to have bitmaps of
+        // compatible values
+        brow_t get_compat (const size_t i, const size_t b) const {
+            return _row (_compat[_blocks[b]._compat], _blocks[b], i);
+        }
+
+        // return the number of values in this table
+        size_t size () const {
+            return _var.size ();
+        }
+
+        // modifiers
+
+        // add all mutexes between the values of var1 and var2 given in a bit
+        // matrix where the j-th bit of the i-th row is set if and only if the
+        // i-th value of var1 is mutex with the j-th value of var2. The matrix
+        // has to be aligned as the rows of dense blocks, i.e., the j-th value of
+        // var2 is stored at the bit first(var2)%64+j. The mutexes are stored as
+        // a dense block if dense is true, and in the adjacency lists
+        // otherwise. In case the block over var1 and var2 already exists, the
+        // mutexes are added to it with its current representation.
+        void add (const size_t var1, const size_t var2,
+                  const multibmap_t& mutexes, const bool dense);
+
+        // reserve room in the adjacency lists for the given number of mutexes
+        // of every value, so that adding them to sparse blocks does not
+        // reallocate any list. Once frozen, no more room can be reserved
+        void reserve (const std::vector<size_t>& nbmutexes) {
+            if (frozen ()) {
+                throw std::runtime_error ("[mutextable_t::reserve] The table of mutexes is frozen");
+            }
+            for (size_t i = 0 ; i < nbmutexes.size () && i < _sparse.size () ; i++) {
+                if (nbmutexes[i]) {
+                    _sparse.reserve (i, nbmutexes[i]);
+                }
+            }
+        }
+
+        // freeze the adjacency lists of this table and compute the bitmaps of
+        // compatible values. Once frozen, no more mutexes can be added
+        void freeze ();
+
+        // return whether this table has been frozen or not
+        bool frozen () const {
+            return _sparse.frozen ();
+        }
+};
+
+#endif // _MUXMUTEXTABLE_T_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
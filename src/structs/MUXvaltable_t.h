@@ -17,6 +17,7 @@
 #include<stdexcept>
 #include<vector>
 
+#include "MUXbmap_t.h"
 #include "MUXvalue_t.h"
 
 // Class definition
@@ -30,36 +31,32 @@ class valtable_t {
         template<class U>
         struct _entry_t {
 
-            // INVARIANT: each entry of the table of values stores the value,
-            // the status of each entry, i.e., whether it is still active or
-            // not, and the number of active mutexes it still has, i.e., the
-            // number of enabled values that are threatening it
+            // INVARIANT: each entry of the table of values stores the value
+            // and the number of active mutexes it still has, i.e., the number
+            // of enabled values that are threatening it
             value_t<U> _value;
-            bool _status;
             size_t _nbmutexes;
 
             // Default constructors of entries are strictly forbidden
             _entry_t<U> () = delete;
 
             // default copy and move constructors
-            _entry_t (_entry_t&) = default;
+            _entry_t (const _entry_t&) = default;
             _entry_t (_entry_t&&) = default;
 
             // default copy and move assignments
-            _entry_t& operator=(_entry_t&) = default;
+            _entry_t& operator=(const _entry_t&) = default;
             _entry_t& operator=(_entry_t&&) = default;
 
             // return whether two entries are the same or not
             bool operator==(const _entry_t& right) const {
                 return _value == right._value &&
-                    _status == right._status &&
                     _nbmutexes == right._nbmutexes;
             }
 
             // likewise, define whether they are different
             bool operator!=(const _entry_t& right) const {
                 return _value != right._value ||
-                    _status != right._status ||
                     _nbmutexes != right._nbmutexes;
             }
         };
@@ -68,11 +65,17 @@ class valtable_t {
         // index of a value is known, then it can be retrieved in O (1)
         std::vector<_entry_t<T>> _table;
 
+        // INVARIANT: the status of every value, i.e., whether it is still
+        // active or not, is stored separately in a bitmap so that the status
+        // of many values can be processed a whole word at a time
+        bmap_t _status;
+
     public:
 
         // Default constructor - tables can be created only by default
         valtable_t () :
-            _table { std::vector<_entry_t<T>>() }
+            _table { std::vector<_entry_t<T>>() },
+            _status { bmap_t (0) }
         {}
 
         // accessors
@@ -119,7 +122,13 @@ class valtable_t {
 
             // in case it is a correct index, return the status of the i-th
             // value
-            return _table[i]._status;
+            return _status[i];
+        }
+
+        // return the status of all values as a bitmap where the i-th bit is
+        // set if and only if the i-th value is enabled
+        const bmap_t& get_statuses () const {
+            return _status;
         }
 
         // set the status of the i-th value. It returns the new status
@@ -133,8 +142,8 @@ class valtable_t {
 
             // otherwise, set the status of the i-th value to the specified
             // status
-            _table[i]._status = status;
-            return _table[i]._status;
+            _status.set (i, status);
+            return status;
         }
 
         // return the value associated to a particular index
@@ -156,6 +165,25 @@ class valtable_t {
             return get_value (i).get_value ();
         }
 
+        // return the raw values of all indices in the range [first, last] in
+        // a contiguous vector, e.g., the domain of a variable
+        std::vector<T> get_values (const size_t first, const size_t last) const {
+
+            // first, make sure the range requested is within the size of this
+            // table
+            if (first > last || last >= _table.size ()) {
+                throw std::out_of_range ("[valtable_t::get_values] out of bounds");
+            }
+
+            // and copy all raw values
+            std::vector<T> result;
+            result.reserve (1 + last - first);
+            for (auto i = first ; i <= last ; i++) {
+                result.push_back (_table[i]._value.get_value ());
+            }
+            return result;
+        }
+
         // return whether two tables of values are identical or not
         bool operator==(const valtable_t<T>& right) const {
 
@@ -167,7 +195,7 @@ class valtable_t {
             // verify now each entry independently
             for (auto i = 0 ; i < _table.size () ; i++) {
                 if (_table[i]._nbmutexes != right.get_nbmutexes (i) ||
-                    _table[i]._status != right.get_status (i) ||
+                    _status[i] != right.get_status (i) ||
                     _table[i]._value != right.get_value (i)) {
                     return false;
                 }
@@ -188,7 +216,8 @@ class valtable_t {
         // insert a new value into this table. New values are enabled by default
         // and have no active mutex
         valtable_t& operator+= (const value_t<T>& value) {
-            _table.push_back (_entry_t<T> {value, true, 0});
+            _table.push_back (_entry_t<T> {value, 0});
+            _status.resize (_table.size (), true);
             return *this;
         }
 
@@ -197,7 +226,8 @@ class valtable_t {
         // takes into the table. New values are enabled by default and have no
         // active mutex
         size_t insert (const value_t<T>& value) {
-            _table.push_back (_entry_t<T> {value, true, 0});
+            _table.push_back (_entry_t<T> {value, 0});
+            _status.resize (_table.size (), true);
             return _table.size() - 1;
         }
 
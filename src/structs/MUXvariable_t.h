@@ -39,11 +39,11 @@ class variable_t {
         {}
 
         // default copy and move constructors
-        variable_t (variable_t&) = default;
+        variable_t (const variable_t&) = default;
         variable_t (variable_t&&) = default;
 
         // default copy and move assignments
-        variable_t& operator=(variable_t&) = default;
+        variable_t& operator=(const variable_t&) = default;
         variable_t& operator=(variable_t&&) = default;
 
         // accessors
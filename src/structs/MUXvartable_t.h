@@ -46,11 +46,11 @@ class vartable_t {
             _entry_t () = delete;
 
             // default copy and move constructors
-            _entry_t (_entry_t&) = default;
+            _entry_t (const _entry_t&) = default;
             _entry_t (_entry_t&&) = default;
 
             // default copy and move assignments
-            _entry_t& operator=(_entry_t&) = default;
+            _entry_t& operator=(const _entry_t&) = default;
             _entry_t& operator=(_entry_t&&) = default;
 
             // Explicit constructor - entries are built providing the variable,
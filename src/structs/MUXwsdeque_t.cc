@@ -0,0 +1,19 @@
+// -*- coding: utf-8 -*-
+// MUXwsdeque_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 24-08-2021 10:13:02.906117452 (1629792782)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Implementation of a lock-free work-stealing deque (Chase-Lev). Note that the
+// deque is a template because it can store any trivially copyable type T
+
+#include "MUXwsdeque_t.h"
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
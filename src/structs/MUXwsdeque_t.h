@@ -0,0 +1,193 @@
+// -*- coding: utf-8 -*-
+// MUXwsdeque_t.h
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 24-08-2021 10:12:44.581903127 (1629792764)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Implementation of a lock-free work-stealing deque (Chase-Lev) where the owner
+// pushes and takes items at the bottom while other threads steal them from the
+// top
+
+#ifndef _MUXWSDEQUE_T_H_
+#define _MUXWSDEQUE_T_H_
+
+#include<atomic>
+#include<cstdint>
+#include<memory>
+#include<stdexcept>
+#include<type_traits>
+#include<vector>
+
+// Class definition
+//
+// Definition of a work-stealing deque. Only the thread owning the deque can
+// push and take items, which are taken in LIFO order, whereas any other thread
+// can steal them concurrently in FIFO order. Items are stored in a circular
+// buffer which is doubled when full. Buffers replaced by a larger one are kept
+// until the deque is destroyed, because a thief might still be reading from
+// them. Note that the deque is a template because it can store any trivially
+// copyable type T, e.g., pointers
+template<class T>
+class wsdeque_t {
+
+    static_assert (std::is_trivially_copyable<T>::value,
+                   "[wsdeque_t] Items must be trivially copyable");
+
+    private:
+
+        // INVARIANT: a buffer consists of a number of slots which is a power
+        // of two, so that positions are mapped to slots with a mask
+        struct _buffer_t {
+            int64_t _mask;
+            std::unique_ptr<std::atomic<T>[]> _slots;
+
+            explicit _buffer_t (const int64_t capacity) :
+                _mask { capacity - 1 },
+                _slots { std::unique_ptr<std::atomic<T>[]> (new std::atomic<T>[capacity]) }
+            {}
+
+            T get (const int64_t i) const {
+                return _slots[i & _mask].load (std::memory_order_relaxed);
+            }
+            void put (const int64_t i, const T item) {
+                _slots[i & _mask].store (item, std::memory_order_relaxed);
+            }
+        };
+
+        // INVARIANT: items are stored in the positions [_top, _bottom) of the
+        // current buffer. The owner moves the bottom, and thieves move the top
+        // with a compare-and-swap. All buffers ever used are owned by the
+        // deque
+        std::atomic<int64_t> _top;
+        std::atomic<int64_t> _bottom;
+        std::atomic<_buffer_t*> _buffer;
+        std::vector<std::unique_ptr<_buffer_t>> _buffers;
+
+        // replace the current buffer with another one with twice its capacity
+        // containing the items in the positions [top, bottom)
+        _buffer_t* _grow (_buffer_t* buffer, const int64_t top, const int64_t bottom) {
+            _buffers.push_back (std::unique_ptr<_buffer_t> (new _buffer_t (2*(buffer->_mask + 1))));
+            _buffer_t* result = _buffers.back ().get ();
+            for (auto i = top ; i < bottom ; i++) {
+                result->put (i, buffer->get (i));
+            }
+            _buffer.store (result, std::memory_order_release);
+            return result;
+        }
+
+    public:
+
+        // Explicit constructor - given the initial capacity of the deque,
+        // which is rounded up to a power of two
+        explicit wsdeque_t (const size_t capacity=64) :
+            _top { 0 },
+            _bottom { 0 },
+            _buffer { nullptr },
+            _buffers { std::vector<std::unique_ptr<_buffer_t>>() }
+        {
+            int64_t size = 1;
+            while (size_t (size) < capacity) {
+                size *= 2;
+            }
+            _buffers.push_back (std::unique_ptr<_buffer_t> (new _buffer_t (size)));
+            _buffer.store (_buffers.back ().get (), std::memory_order_relaxed);
+        }
+
+        // Deques can be neither copied nor moved because other threads refer
+        // to them
+        wsdeque_t (const wsdeque_t&) = delete;
+        wsdeque_t& operator=(const wsdeque_t&) = delete;
+
+        // modifiers
+
+        // push a new item at the bottom of the deque. Only the owner of the
+        // deque can push items
+        void push (const T item) {
+            int64_t bottom = _bottom.load (std::memory_order_relaxed);
+            int64_t top = _top.load (std::memory_order_acquire);
+            _buffer_t* buffer = _buffer.load (std::memory_order_relaxed);
+            if (bottom - top > buffer->_mask) {
+                buffer = _grow (buffer, top, bottom);
+            }
+            buffer->put (bottom, item);
+            std::atomic_thread_fence (std::memory_order_release);
+            _bottom.store (bottom + 1, std::memory_order_relaxed);
+        }
+
+        // take the item at the bottom of the deque and return true, or return
+        // false if the deque is empty. Only the owner of the deque can take
+        // items
+        bool take (T& item) {
+            int64_t bottom = _bottom.load (std::memory_order_relaxed) - 1;
+            _buffer_t* buffer = _buffer.load (std::memory_order_relaxed);
+            _bottom.store (bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+            int64_t top = _top.load (std::memory_order_relaxed);
+
+            // if the deque was empty, restore the bottom
+            if (top > bottom) {
+                _bottom.store (bottom + 1, std::memory_order_relaxed);
+                return false;
+            }
+
+            // otherwise, take the last item. If it is the only one, race with
+            // thieves for it
+            item = buffer->get (bottom);
+            if (top == bottom) {
+                bool success = _top.compare_exchange_strong (top, top + 1,
+                                                             std::memory_order_seq_cst,
+                                                             std::memory_order_relaxed);
+                _bottom.store (bottom + 1, std::memory_order_relaxed);
+                return success;
+            }
+            return true;
+        }
+
+        // steal the item at the top of the deque and return true, or return
+        // false if the deque is empty or another thread took it first. Any
+        // thread can steal items
+        bool steal (T& item) {
+            int64_t top = _top.load (std::memory_order_acquire);
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+            int64_t bottom = _bottom.load (std::memory_order_acquire);
+            if (top >= bottom) {
+                return false;
+            }
+            _buffer_t* buffer = _buffer.load (std::memory_order_acquire);
+            item = buffer->get (top);
+            return _top.compare_exchange_strong (top, top + 1,
+                                                 std::memory_order_seq_cst,
+                                                 std::memory_order_relaxed);
+        }
+
+        // capacity
+
+        // return the number of items in the deque. When other threads are
+        // accessing it, this is only an estimate
+        size_t size () const {
+            int64_t bottom = _bottom.load (std::memory_order_relaxed);
+            int64_t top = _top.load (std::memory_order_relaxed);
+            return bottom > top ? size_t (bottom - top) : 0;
+        }
+
+        // return true if the deque is empty
+        bool empty () const {
+            return !size ();
+        }
+
+        // return the number of items the deque can store before growing
+        size_t capacity () const {
+            return size_t (_buffer.load (std::memory_order_relaxed)->_mask + 1);
+        }
+};
+
+#endif // _MUXWSDEQUE_T_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
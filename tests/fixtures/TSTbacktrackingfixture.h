@@ -0,0 +1,264 @@
+// -*- coding: utf-8 -*-
+// TSTbacktrackingfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 17-08-2021 11:20:14.700812335 (1629192014)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX backtracking
+
+#ifndef _TSTBACKTRACKINGFIXTURE_H_
+#define _TSTBACKTRACKINGFIXTURE_H_
+
+#include<cstdlib>
+#include<ctime>
+#include<set>
+#include<stdexcept>
+#include<string>
+#include<utility>
+#include<vector>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/solver/MUXbacktracking.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX backtracking
+class BacktrackingFixture : public ::testing::Test {
+
+    protected:
+
+        void SetUp () override {
+
+            // just initialize the random seed to make sure that every iteration
+            // is performed over different random data
+            srand (time (nullptr));
+        }
+
+        // populate the given manager with the n-queens problem: one variable
+        // per row whose value is the column of its queen
+        void queens (manager<int>& m, int n) {
+
+            // add one variable per row with all columns in its domain
+            for (int i = 0 ; i < n ; i++) {
+                variable_t variable {"Q" + to_string (i)};
+                vector<value_t<int>> domain;
+                for (int j = 0 ; j < n ; j++) {
+                    domain.push_back (value_t<int>{j});
+                }
+                m.add_variable (variable, domain);
+            }
+
+            // no two queens can be in the same column or diagonal
+            for (int i = 0 ; i < n ; i++) {
+                for (int j = i + 1 ; j < n ; j++) {
+                    m.add_constraint ([i, j] (int col1, int col2) {
+                        return col1 != col2 && abs (col1 - col2) != j - i;
+                    }, variable_t{"Q" + to_string (i)}, variable_t{"Q" + to_string (j)});
+                }
+            }
+        }
+
+        // populate the given manager with the pigeonhole problem: p pigeons
+        // have to be placed in h holes, no two in the same hole
+        void pigeons (manager<int>& m, int p, int h) {
+
+            // add one variable per pigeon with all holes in its domain
+            for (int i = 0 ; i < p ; i++) {
+                variable_t variable {"P" + to_string (i)};
+                vector<value_t<int>> domain;
+                for (int j = 0 ; j < h ; j++) {
+                    domain.push_back (value_t<int>{j});
+                }
+                m.add_variable (variable, domain);
+            }
+
+            // and no two pigeons can be placed in the same hole
+            for (int i = 0 ; i < p ; i++) {
+                for (int j = i + 1 ; j < p ; j++) {
+                    m.add_constraint ([] (int hole1, int hole2) {
+                        return hole1 != hole2;
+                    }, variable_t{"P" + to_string (i)}, variable_t{"P" + to_string (j)});
+                }
+            }
+        }
+
+        // populate the given manager with a random CSP task with n variables,
+        // each with a random number of values in [1, d], where every pair of
+        // values of different variables is mutex with probability 1/t
+        void randCSP (manager<int>& m, int n, int d, int t) {
+
+            // add all variables. The values of every variable are unique so
+            // that mutexes can be randomly selected in advance
+            for (int i = 0 ; i < n ; i++) {
+                variable_t variable {"X" + to_string (i)};
+                vector<value_t<int>> domain;
+                int size = 1 + rand () % d;
+                for (int j = 0 ; j < size ; j++) {
+                    domain.push_back (value_t<int>{i*d + j});
+                }
+                m.add_variable (variable, domain);
+            }
+
+            // randomly select the mutexes between all pairs of variables
+            set<pair<int, int>> mutexes;
+            for (int i = 0 ; i < n*d ; i++) {
+                for (int j = i + 1 ; j < n*d ; j++) {
+                    if (rand () % t == 0) {
+                        mutexes.insert ({i, j});
+                    }
+                }
+            }
+            for (int i = 0 ; i < n ; i++) {
+                for (int j = i + 1 ; j < n ; j++) {
+                    m.add_constraint ([&mutexes] (int val1, int val2) {
+                        return mutexes.find ({val1, val2}) == mutexes.end ();
+                    }, variable_t{"X" + to_string (i)}, variable_t{"X" + to_string (j)});
+                }
+            }
+        }
+
+        // return true if the given assignment of values to all variables of
+        // the manager is a solution
+        bool isSolution (const manager<int>& m, const vector<size_t>& solution) {
+
+            // all variables have to be assigned values in their domain
+            const vartable_t& vartable = m.get_vartable ();
+            if (solution.size () != vartable.size ()) {
+                return false;
+            }
+            for (size_t i = 0 ; i < vartable.size () ; i++) {
+                if (solution[i] < vartable.get_first (i) ||
+                    solution[i] > vartable.get_last (i)) {
+                    return false;
+                }
+            }
+
+            // and no pair of them can be mutex
+            for (size_t i = 0 ; i < solution.size () ; i++) {
+                for (size_t j = i + 1 ; j < solution.size () ; j++) {
+                    if (m.get_mutextable ()->find (solution[i], solution[j])) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        // return true if the CSP task of the manager has at least one solution.
+        // It performs a brute-force search so that it should be used only with
+        // tiny tasks
+        bool bruteForce (const manager<int>& m) {
+
+            // enumerate all assignments as a counter where every digit ranges
+            // over the domain of one variable
+            const vartable_t& vartable = m.get_vartable ();
+            vector<size_t> assignment;
+            for (size_t i = 0 ; i < vartable.size () ; i++) {
+                assignment.push_back (vartable.get_first (i));
+            }
+            while (true) {
+                if (isSolution (m, assignment)) {
+                    return true;
+                }
+                size_t i = 0;
+                while (i < assignment.size () && assignment[i] == vartable.get_last (i)) {
+                    assignment[i] = vartable.get_first (i);
+                    i++;
+                }
+                if (i == assignment.size ()) {
+                    return false;
+                }
+                assignment[i]++;
+            }
+        }
+
+        // solve the given manager with the given variable and value orderings
+        // and propagation, and verify that its satisfiability is the expected
+        // one
+        template<class VarOrder, class ValOrder = valorder_lex_t>
+        void checkOrdering (manager<int>& m, const propagation_t propagation, const bool expected) {
+            backtracking<int, VarOrder, ValOrder> search (m);
+            search.set_propagation (propagation);
+            status_t status = search.solve ();
+            ASSERT_EQ (status == status_t::SATISFIABLE, expected);
+            if (status == status_t::SATISFIABLE) {
+                ASSERT_TRUE (isSolution (m, search.get_solution ()));
+            }
+            checkRestored (m);
+        }
+
+        // verify that the manager has been fully restored after a search
+        void checkRestored (const manager<int>& m) {
+            const vartable_t& vartable = m.get_vartable ();
+            const valtable_t<int>& valtable = m.get_valtable ();
+            for (size_t i = 0 ; i < vartable.size () ; i++) {
+                ASSERT_EQ (vartable.get_value (i), string::npos);
+                ASSERT_EQ (vartable.get_nbvalues (i),
+                           1 + vartable.get_last (i) - vartable.get_first (i));
+            }
+            for (size_t j = 0 ; j < valtable.size () ; j++) {
+                ASSERT_TRUE (valtable.get_status (j));
+                ASSERT_EQ (valtable.get_nbmutexes (j), m.get_mutextable ()->degree (j));
+            }
+        }
+};
+
+// Class definition
+//
+// Variable ordering which selects variables in lexicographic order, but raises
+// an exception once two variables have been assigned. It is used to verify
+// that parallel searches rethrow the exceptions raised by their workers
+class varorder_throw_t : public varorder_lex_t {
+
+    private:
+
+        // INVARIANT: the number of variables currently assigned
+        size_t _nbassigned;
+
+    public:
+
+        // Default constructor
+        varorder_throw_t () :
+            varorder_lex_t (),
+            _nbassigned { 0 }
+        {}
+
+        // initialize the strategy with all variables unassigned
+        void init (const vartable_t& vartable, const mutextable_t& mutextable) {
+            varorder_lex_t::init (vartable, mutextable);
+            _nbassigned = 0;
+        }
+
+        // remove/insert a variable from/into the set of unassigned variables
+        void remove (const size_t var) {
+            varorder_lex_t::remove (var);
+            _nbassigned++;
+        }
+        void insert (const size_t var) {
+            varorder_lex_t::insert (var);
+            _nbassigned--;
+        }
+
+        // return the first unassigned variable, unless two variables have been
+        // already assigned
+        size_t select () const {
+            if (_nbassigned >= 2) {
+                throw std::runtime_error ("[varorder_throw_t::select] Too many variables assigned");
+            }
+            return varorder_lex_t::select ();
+        }
+};
+
+#endif // _TSTBACKTRACKINGFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
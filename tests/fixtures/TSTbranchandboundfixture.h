@@ -0,0 +1,99 @@
+// -*- coding: utf-8 -*-
+// TSTbranchandboundfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <sáb 28-08-2021 12:31:09.552817046 (1630146669)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX depth-first branch and bound
+
+#ifndef _TSTBRANCHANDBOUNDFIXTURE_H_
+#define _TSTBRANCHANDBOUNDFIXTURE_H_
+
+#include<limits>
+#include<map>
+#include<string>
+#include<utility>
+#include<vector>
+
+#include "TSTworkstealfixture.h"
+#include "../../src/solver/MUXbranchandbound.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX depth-first branch and bound.
+// CSP tasks are generated and verified as in the tests of parallel searches
+// with work stealing
+class BranchAndBoundFixture : public WorkstealFixture {
+
+    protected:
+
+        // populate the given manager with a random CSP task as randCSP does,
+        // and additionally post soft constraints between all pairs of
+        // variables where every pair of values has a random cost in [1, c]
+        // with probability 1/t
+        void randWCSP (manager<int>& m, int n, int d, int t, int c) {
+
+            // first, create the hard constraints. Note that the values of
+            // different variables are different
+            randCSP (m, n, d, t);
+
+            // randomly select the costs between all pairs of values
+            map<pair<int, int>, int> costs;
+            for (int i = 0 ; i < n*d ; i++) {
+                for (int j = i + 1 ; j < n*d ; j++) {
+                    if (rand () % t == 0) {
+                        costs[{i, j}] = 1 + rand () % c;
+                    }
+                }
+            }
+            for (int i = 0 ; i < n ; i++) {
+                for (int j = i + 1 ; j < n ; j++) {
+                    m.add_soft_constraint ([&costs] (int val1, int val2) {
+                        auto it = costs.find ({val1, val2});
+                        return (it == costs.end ()) ? 0 : it->second;
+                    }, variable_t{"X" + to_string (i)}, variable_t{"X" + to_string (j)});
+                }
+            }
+        }
+
+        // return the cost of the cheapest solution of the CSP task of the
+        // manager, or the maximum size_t if there is none. It performs a
+        // brute-force search so that it should be used only with tiny tasks
+        size_t bruteCost (manager<int>& m) {
+
+            // enumerate all assignments as a counter where every digit ranges
+            // over the domain of one variable
+            m.freeze ();
+            const vartable_t& vartable = m.get_vartable ();
+            vector<size_t> assignment;
+            for (size_t i = 0 ; i < vartable.size () ; i++) {
+                assignment.push_back (vartable.get_first (i));
+            }
+            size_t result = numeric_limits<size_t>::max ();
+            while (true) {
+                if (isSolution (m, assignment)) {
+                    result = min (result, m.cost (assignment));
+                }
+                size_t i = 0;
+                while (i < assignment.size () && assignment[i] == vartable.get_last (i)) {
+                    assignment[i] = vartable.get_first (i);
+                    i++;
+                }
+                if (i == assignment.size ()) {
+                    return result;
+                }
+                assignment[i]++;
+            }
+        }
+};
+
+#endif // _TSTBRANCHANDBOUNDFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
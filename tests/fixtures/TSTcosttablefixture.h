@@ -0,0 +1,45 @@
+// -*- coding: utf-8 -*-
+// TSTcosttablefixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <sáb 28-08-2021 12:05:44.310263811 (1630145144)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX tables of costs
+
+#ifndef _TSTCOSTTABLEFIXTURE_H_
+#define _TSTCOSTTABLEFIXTURE_H_
+
+#include<cstdlib>
+#include<ctime>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/structs/MUXcosttable_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX tables of costs
+class CosttableFixture : public ::testing::Test {
+
+    protected:
+
+        void SetUp () override {
+
+            // just initialize the random seed to make sure that every iteration
+            // is performed over different random data
+            srand (time (nullptr));
+        }
+};
+
+#endif // _TSTCOSTTABLEFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
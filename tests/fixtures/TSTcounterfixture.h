@@ -0,0 +1,60 @@
+// -*- coding: utf-8 -*-
+// TSTcounterfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <jue 26-08-2021 11:40:18.092315670 (1629970818)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX counters of solutions
+
+#ifndef _TSTCOUNTERFIXTURE_H_
+#define _TSTCOUNTERFIXTURE_H_
+
+#include<string>
+#include<vector>
+
+#include "TSTworkstealfixture.h"
+#include "../../src/solver/MUXcounter.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX counters of solutions. CSP tasks
+// are generated and verified as in the tests of parallel searches with work
+// stealing
+class CounterFixture : public WorkstealFixture {
+
+    protected:
+
+        // populate the given manager with a chain of n variables with d values
+        // each, where every variable has to take a value different from the
+        // next one
+        void chain (manager<int>& m, int n, int d) {
+
+            // add all variables
+            for (int i = 0 ; i < n ; i++) {
+                variable_t variable {"C" + to_string (i)};
+                vector<value_t<int>> domain;
+                for (int j = 0 ; j < d ; j++) {
+                    domain.push_back (value_t<int>{j});
+                }
+                m.add_variable (variable, domain);
+            }
+
+            // and the constraints between consecutive variables
+            for (int i = 0 ; i + 1 < n ; i++) {
+                m.add_constraint ([] (int value1, int value2) {
+                    return value1 != value2;
+                }, variable_t{"C" + to_string (i)}, variable_t{"C" + to_string (i+1)});
+            }
+        }
+};
+
+#endif // _TSTCOUNTERFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,80 @@
+// -*- coding: utf-8 -*-
+// TSTenumeratorfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <vie 27-08-2021 10:05:33.417296518 (1630051533)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX enumerators of solutions
+
+#ifndef _TSTENUMERATORFIXTURE_H_
+#define _TSTENUMERATORFIXTURE_H_
+
+#include<set>
+#include<vector>
+
+#include "TSTworkstealfixture.h"
+#include "../../src/solver/MUXenumerator.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX enumerators of solutions. CSP
+// tasks are generated and verified as in the tests of parallel searches with
+// work stealing
+class EnumeratorFixture : public WorkstealFixture {
+
+    protected:
+
+        // return the set of different assignments of the given variables which
+        // can be extended to a solution of the CSP task of the manager. It
+        // performs a brute-force search so that it should be used only with
+        // tiny tasks
+        set<vector<size_t>> bruteProjection (const manager<int>& m, const vector<size_t>& projection) {
+
+            // enumerate all assignments as a counter where every digit ranges
+            // over the domain of one variable
+            const vartable_t& vartable = m.get_vartable ();
+            vector<size_t> assignment;
+            for (size_t i = 0 ; i < vartable.size () ; i++) {
+                assignment.push_back (vartable.get_first (i));
+            }
+            set<vector<size_t>> result;
+            while (true) {
+                if (isSolution (m, assignment)) {
+                    vector<size_t> projected;
+                    for (auto var : projection) {
+                        projected.push_back (assignment[var]);
+                    }
+                    result.insert (projected);
+                }
+                size_t i = 0;
+                while (i < assignment.size () && assignment[i] == vartable.get_last (i)) {
+                    assignment[i] = vartable.get_first (i);
+                    i++;
+                }
+                if (i == assignment.size ()) {
+                    return result;
+                }
+                assignment[i]++;
+            }
+        }
+
+        // return the assignment stored in the given table of variables
+        vector<size_t> getAssignment (const vartable_t& vartable) {
+            vector<size_t> result;
+            for (size_t i = 0 ; i < vartable.size () ; i++) {
+                result.push_back (vartable.get_value (i));
+            }
+            return result;
+        }
+};
+
+#endif // _TSTENUMERATORFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,32 @@
+// -*- coding: utf-8 -*-
+// TSTepsfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <mié 25-08-2021 11:02:56.471180229 (1629882176)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX embarrassingly parallel searches
+
+#ifndef _TSTEPSFIXTURE_H_
+#define _TSTEPSFIXTURE_H_
+
+#include "TSTworkstealfixture.h"
+#include "../../src/solver/MUXeps.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX embarrassingly parallel
+// searches. CSP tasks are generated and verified as in the tests of parallel
+// searches with work stealing
+class EpsFixture : public WorkstealFixture {
+};
+
+#endif // _TSTEPSFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,60 @@
+// -*- coding: utf-8 -*-
+// TSTheapfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <jue 19-08-2021 10:41:07.530283195 (1629362467)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX indexed heaps
+
+#ifndef _TSTHEAPFIXTURE_H_
+#define _TSTHEAPFIXTURE_H_
+
+#include<cstdlib>
+#include<ctime>
+#include<string>
+#include<vector>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/structs/MUXheap_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX indexed heaps
+class HeapFixture : public ::testing::Test {
+
+    protected:
+
+        void SetUp () override {
+
+            // just initialize the random seed to make sure that every iteration
+            // is performed over different random data
+            srand (time (nullptr));
+        }
+
+        // return the item with the smallest key among those marked as inserted
+        // breaking ties in favour of the smallest item, or string::npos if
+        // there is none. It is computed by brute force
+        size_t bruteTop (const std::vector<bool>& inserted, const std::vector<double>& keys) {
+            size_t result = std::string::npos;
+            for (size_t i = 0 ; i < inserted.size () ; i++) {
+                if (inserted[i] && (result == std::string::npos || keys[i] < keys[result])) {
+                    result = i;
+                }
+            }
+            return result;
+        }
+};
+
+#endif // _TSTHEAPFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,49 @@
+// -*- coding: utf-8 -*-
+// TSTlocalsearchfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 30-08-2021 10:32:18.402716593 (1630312338)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX local searches
+
+#ifndef _TSTLOCALSEARCHFIXTURE_H_
+#define _TSTLOCALSEARCHFIXTURE_H_
+
+#include<vector>
+
+#include "TSTbacktrackingfixture.h"
+#include "../../src/solver/MUXlocalsearch.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX local searches. CSP tasks are
+// generated and verified as in the tests of backtracking
+class LocalsearchFixture : public BacktrackingFixture {
+
+    protected:
+
+        // return the number of mutexes violated by the given assignment of
+        // values to all variables of the manager
+        size_t violations (const manager<int>& m, const vector<size_t>& assignment) {
+            size_t result = 0;
+            for (size_t i = 0 ; i < assignment.size () ; i++) {
+                for (size_t j = i + 1 ; j < assignment.size () ; j++) {
+                    if (m.get_mutextable ()->find (assignment[i], assignment[j])) {
+                        result++;
+                    }
+                }
+            }
+            return result;
+        }
+};
+
+#endif // _TSTLOCALSEARCHFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,45 @@
+// -*- coding: utf-8 -*-
+// TSTmutextablefixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 16-08-2021 10:12:41.583370916 (1629101561)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX tables of mutexes
+
+#ifndef _TSTMUTEXTABLEFIXTURE_H_
+#define _TSTMUTEXTABLEFIXTURE_H_
+
+#include<cstdlib>
+#include<ctime>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/structs/MUXmutextable_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX tables of mutexes
+class MutextableFixture : public ::testing::Test {
+
+    protected:
+
+        void SetUp () override {
+
+            // just initialize the random seed to make sure that every iteration
+            // is performed over different random data
+            srand (time (nullptr));
+        }
+};
+
+#endif // _TSTMUTEXTABLEFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,74 @@
+// -*- coding: utf-8 -*-
+// TSTnogoodstorefixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <sáb 21-08-2021 11:02:48.145270331 (1629536568)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX stores of nogoods
+
+#ifndef _TSTNOGOODSTOREFIXTURE_H_
+#define _TSTNOGOODSTOREFIXTURE_H_
+
+#include<algorithm>
+#include<cstdlib>
+#include<ctime>
+#include<random>
+#include<set>
+#include<vector>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/solver/MUXnogoodstore_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX stores of nogoods
+class NogoodstoreFixture : public ::testing::Test {
+
+    protected:
+
+        void SetUp () override {
+
+            // just initialize the random seed to make sure that every iteration
+            // is performed over different random data
+            srand (time (nullptr));
+        }
+
+        // return a random nogood with at most the given number of distinct
+        // literals in the range [0, nbvalues)
+        std::vector<size_t> randNogood (const size_t nbvalues, const size_t size) {
+            std::set<size_t> literals;
+            size_t n = 1 + rand () % size;
+            while (literals.size () < n) {
+                literals.insert (rand () % nbvalues);
+            }
+            std::vector<size_t> result (literals.begin (), literals.end ());
+            std::shuffle (result.begin (), result.end (), std::mt19937 (rand ()));
+            return result;
+        }
+
+        // return the number of literals of the given nogood which are not
+        // true
+        size_t nbfalse (const multivector_t::row_t& nogood, const std::vector<bool>& istrue) {
+            size_t result = 0;
+            for (auto literal : nogood) {
+                if (!istrue[literal]) {
+                    result++;
+                }
+            }
+            return result;
+        }
+};
+
+#endif // _TSTNOGOODSTOREFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,31 @@
+// -*- coding: utf-8 -*-
+// TSTportfoliofixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 23-08-2021 10:12:40.873014551 (1629706360)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX portfolios
+
+#ifndef _TSTPORTFOLIOFIXTURE_H_
+#define _TSTPORTFOLIOFIXTURE_H_
+
+#include "TSTbacktrackingfixture.h"
+#include "../../src/solver/MUXportfolio.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX portfolios. CSP tasks are
+// generated and verified as in the tests of backtracking
+class PortfolioFixture : public BacktrackingFixture {
+};
+
+#endif // _TSTPORTFOLIOFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,62 @@
+// -*- coding: utf-8 -*-
+// TSTpredicatesfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 31-08-2021 11:15:02.647180391 (1630401302)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX built-in predicates
+
+#ifndef _TSTPREDICATESFIXTURE_H_
+#define _TSTPREDICATESFIXTURE_H_
+
+#include<cstdint>
+#include<cstdlib>
+#include<ctime>
+#include<limits>
+#include<vector>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/solver/MUXpredicates.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX built-in predicates
+class PredicatesFixture : public ::testing::Test {
+
+    protected:
+
+        void SetUp () override {
+
+            // just initialize the random seed to make sure that every iteration
+            // is performed over different random data
+            srand (time (nullptr));
+        }
+
+        // verify that the batch evaluation of the given predicate over one
+        // value and the given values agrees with its evaluation over every
+        // pair of values
+        template<class T, class Predicate>
+        void checkBatch (const Predicate& predicate, const T& value, const std::vector<T>& values) {
+
+            // fill the mask with garbage to make sure every word is written
+            std::vector<uint64_t> mask ((values.size () + 63)/64, 0x5555555555555555);
+            predicate (value, values.data (), values.size (), mask.data ());
+            for (size_t j = 0 ; j < values.size () ; j++) {
+                ASSERT_EQ (bool ((mask[j/64] >> (j%64)) & 1), predicate (value, values[j]));
+            }
+        }
+};
+
+#endif // _TSTPREDICATESFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,77 @@
+// -*- coding: utf-8 -*-
+// TSTtrailfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <mié 18-08-2021 11:34:50.290318412 (1629279290)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX trails
+
+#ifndef _TSTTRAILFIXTURE_H_
+#define _TSTTRAILFIXTURE_H_
+
+#include<cstdlib>
+#include<ctime>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/solver/MUXtrail_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX trails
+class TrailFixture : public ::testing::Test {
+
+    protected:
+
+        void SetUp () override {
+
+            // just initialize the random seed to make sure that every iteration
+            // is performed over different random data
+            srand (time (nullptr));
+        }
+};
+
+// Class definition
+//
+// Trails undo changes by invoking the service undo of a manager. The following
+// class simply records the previous values given to it
+class undotable_t {
+
+    private:
+
+        // INVARIANT: an undo table stores a vector of values for every opcode
+        std::vector<std::vector<size_t>> _values;
+
+    public:
+
+        // Explicit constructor - given the number of values for every opcode
+        explicit undotable_t (size_t n) :
+            _values { std::vector<std::vector<size_t>>(4, std::vector<size_t>(n, 0)) }
+        {}
+
+        // accessors
+        size_t get (const opcode_t opcode, const size_t i) const {
+            return _values[size_t (opcode)][i];
+        }
+
+        // modifiers
+        void set (const opcode_t opcode, const size_t i, const size_t value) {
+            _values[size_t (opcode)][i] = value;
+        }
+        void undo (const opcode_t opcode, const size_t i, const size_t prev) {
+            set (opcode, i, prev);
+        }
+};
+
+#endif // _TSTTRAILFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
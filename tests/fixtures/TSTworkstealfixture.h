@@ -0,0 +1,65 @@
+// -*- coding: utf-8 -*-
+// TSTworkstealfixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 24-08-2021 12:48:15.630127874 (1629802095)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX parallel searches with work stealing
+
+#ifndef _TSTWORKSTEALFIXTURE_H_
+#define _TSTWORKSTEALFIXTURE_H_
+
+#include<vector>
+
+#include "TSTbacktrackingfixture.h"
+#include "../../src/solver/MUXworksteal.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX parallel searches with work
+// stealing. CSP tasks are generated and verified as in the tests of
+// backtracking
+class WorkstealFixture : public BacktrackingFixture {
+
+    protected:
+
+        // return the number of solutions of the CSP task of the manager. It
+        // performs a brute-force search so that it should be used only with
+        // tiny tasks
+        size_t bruteCount (const manager<int>& m) {
+
+            // enumerate all assignments as a counter where every digit ranges
+            // over the domain of one variable
+            const vartable_t& vartable = m.get_vartable ();
+            vector<size_t> assignment;
+            for (size_t i = 0 ; i < vartable.size () ; i++) {
+                assignment.push_back (vartable.get_first (i));
+            }
+            size_t result = 0;
+            while (true) {
+                if (isSolution (m, assignment)) {
+                    result++;
+                }
+                size_t i = 0;
+                while (i < assignment.size () && assignment[i] == vartable.get_last (i)) {
+                    assignment[i] = vartable.get_first (i);
+                    i++;
+                }
+                if (i == assignment.size ()) {
+                    return result;
+                }
+                assignment[i]++;
+            }
+        }
+};
+
+#endif // _TSTWORKSTEALFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,45 @@
+// -*- coding: utf-8 -*-
+// TSTwsdequefixture.h
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 24-08-2021 12:20:31.774092316 (1629800431)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests OF CSPMUX work-stealing deques
+
+#ifndef _TSTWSDEQUEFIXTURE_H_
+#define _TSTWSDEQUEFIXTURE_H_
+
+#include<cstdlib>
+#include<ctime>
+
+#include "gtest/gtest.h"
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../../src/structs/MUXwsdeque_t.h"
+
+// Class definition
+//
+// Defines a Google test fixture for testing MUX work-stealing deques
+class WSDequeFixture : public ::testing::Test {
+
+    protected:
+
+        void SetUp () override {
+
+            // just initialize the random seed to make sure that every iteration
+            // is performed over different random data
+            srand (time (nullptr));
+        }
+};
+
+#endif // _TSTWSDEQUEFIXTURE_H_
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
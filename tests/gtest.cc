@@ -21,9 +21,7 @@ int main(int argc, char **argv)
     // testing::GTEST_FLAG(filter) = "ManagerFixture.Restore*";
 
     // Exclude specific tests
-    //
-    // Bitmaps and multibitmaps are not used anymore
-    testing::GTEST_FLAG(filter) = "-BitmapFixture.*:MultibitmapFixture.*";
+    // testing::GTEST_FLAG(filter) = "-BitmapFixture.*:MultibitmapFixture.*";
 
     // and run the selection of tests
     return RUN_ALL_TESTS();
@@ -0,0 +1,606 @@
+// -*- coding: utf-8 -*-
+// TSTbacktracking.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 17-08-2021 11:24:52.170316508 (1629192292)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests of CSPMUX backtracking
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../fixtures/TSTbacktrackingfixture.h"
+
+// Checks that a manager without variables is trivially satisfiable
+// ----------------------------------------------------------------------------
+TEST_F (BacktrackingFixture, EmptyBacktracking) {
+
+    manager<int> m;
+    backtracking<int> search (m);
+    ASSERT_EQ (search.get_status (), status_t::UNKNOWN);
+    ASSERT_EQ (search.solve (), status_t::SATISFIABLE);
+    ASSERT_EQ (search.get_solution ().size (), 0);
+    ASSERT_EQ (search.get_nbnodes (), 0);
+}
+
+// Checks that solutions to the n-queens problem are found when they exist
+// ----------------------------------------------------------------------------
+TEST_F (BacktrackingFixture, QueensBacktracking) {
+
+    for (auto n = 1 ; n <= 12 ; n++) {
+
+        // create the n-queens problem and solve it
+        manager<int> m;
+        queens (m, n);
+        backtracking<int> search (m);
+        status_t status = search.solve ();
+
+        // there are solutions for all sizes but 2 and 3
+        if (n == 2 || n == 3) {
+            ASSERT_EQ (status, status_t::UNSATISFIABLE);
+            ASSERT_EQ (search.get_solution ().size (), 0);
+        } else {
+            ASSERT_EQ (status, status_t::SATISFIABLE);
+            ASSERT_TRUE (isSolution (m, search.get_solution ()));
+        }
+
+        // in all cases the manager should be restored after the search
+        checkRestored (m);
+    }
+}
+
+// Checks that the pigeonhole problem is unsatisfiable when there are more
+// pigeons than holes
+// ----------------------------------------------------------------------------
+TEST_F (BacktrackingFixture, PigeonsBacktracking) {
+
+    for (auto h = 1 ; h <= 6 ; h++) {
+
+        // placing h pigeons in h holes is possible
+        manager<int> sat;
+        pigeons (sat, h, h);
+        backtracking<int> satsearch (sat);
+        ASSERT_EQ (satsearch.solve (), status_t::SATISFIABLE);
+        ASSERT_TRUE (isSolution (sat, satsearch.get_solution ()));
+        checkRestored (sat);
+
+        // but one more pigeon is impossible
+        manager<int> unsat;
+        pigeons (unsat, h+1, h);
+        backtracking<int> unsatsearch (unsat);
+        ASSERT_EQ (unsatsearch.solve (), status_t::UNSATISFIABLE);
+        ASSERT_GT (unsatsearch.get_nbbacktracks (), 0);
+        checkRestored (unsat);
+    }
+}
+
+// Checks that backtracking decides correctly the satisfiability of random CSP
+// tasks
+// ----------------------------------------------------------------------------
+TEST_F (BacktrackingFixture, RandomBacktracking) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a random CSP task small enough to be verified by brute-force
+        manager<int> m;
+        randCSP (m, 2 + rand () % 5, 4, 2 + rand () % 4);
+        backtracking<int> search (m);
+        status_t status = search.solve ();
+
+        // and verify the outcome of the search
+        ASSERT_EQ (status == status_t::SATISFIABLE, bruteForce (m));
+        if (status == status_t::SATISFIABLE) {
+            ASSERT_TRUE (isSolution (m, search.get_solution ()));
+        }
+        checkRestored (m);
+    }
+}
+
+// Checks that searches are interrupted when exhausting their budgets
+// ----------------------------------------------------------------------------
+TEST_F (BacktrackingFixture, LimitsBacktracking) {
+
+    for (auto i = 0 ; i < NB_TESTS/1000 ; i++) {
+
+        // create an unsatisfiable task which requires a large number of nodes
+        manager<int> m;
+        pigeons (m, 9, 8);
+
+        // limit the number of nodes
+        size_t limit = 1 + rand () % 1000;
+        backtracking<int> search (m);
+        search.set_node_limit (limit);
+        ASSERT_EQ (search.solve (), status_t::NODE_LIMIT);
+        ASSERT_EQ (search.get_nbnodes (), limit);
+        ASSERT_EQ (search.get_solution ().size (), 0);
+        checkRestored (m);
+
+        // and also the time
+        search.set_node_limit (numeric_limits<size_t>::max ());
+        search.set_time_limit (0.0);
+        ASSERT_EQ (search.solve (), status_t::TIME_LIMIT);
+        checkRestored (m);
+    }
+}
+
+// Checks that forward checking decides the same as plain backtracking with
+// fewer nodes
+// ----------------------------------------------------------------------------
+TEST_F (BacktrackingFixture, ForwardCheckingBacktracking) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a random CSP task and solve it with both propagations
+        manager<int> m;
+        randCSP (m, 2 + rand () % 8, 6, 2 + rand () % 4);
+        backtracking<int> bt (m);
+        backtracking<int> fc (m);
+        fc.set_propagation (propagation_t::FORWARD_CHECKING);
+        ASSERT_EQ (fc.get_propagation (), propagation_t::FORWARD_CHECKING);
+        status_t btstatus = bt.solve ();
+        status_t fcstatus = fc.solve ();
+
+        // both have to agree and forward checking can not expand more nodes
+        // because it uses the same ordering
+        ASSERT_EQ (btstatus, fcstatus);
+        ASSERT_LE (fc.get_nbnodes (), bt.get_nbnodes ());
+        if (fcstatus == status_t::SATISFIABLE) {
+            ASSERT_TRUE (isSolution (m, fc.get_solution ()));
+        }
+        checkRestored (m);
+    }
+
+    // forward checking also solves the n-queens and proves the pigeonhole
+    // problem to be unsatisfiable
+    for (auto n = 4 ; n <= 16 ; n++) {
+        manager<int> m;
+        queens (m, n);
+        backtracking<int> fc (m);
+        fc.set_propagation (propagation_t::FORWARD_CHECKING);
+        ASSERT_EQ (fc.solve (), status_t::SATISFIABLE);
+        ASSERT_TRUE (isSolution (m, fc.get_solution ()));
+        checkRestored (m);
+    }
+    for (auto h = 1 ; h <= 6 ; h++) {
+        manager<int> m;
+        pigeons (m, h+1, h);
+        backtracking<int> fc (m);
+        fc.set_propagation (propagation_t::FORWARD_CHECKING);
+        ASSERT_EQ (fc.solve (), status_t::UNSATISFIABLE);
+        checkRestored (m);
+    }
+}
+
+// Checks that maintaining arc consistency decides the same as forward checking
+// with fewer nodes
+// ----------------------------------------------------------------------------
+TEST_F (BacktrackingFixture, ArcConsistencyBacktracking) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a random CSP task and solve it with both propagations. Make
+        // sure that some constraints are stored as bit matrices
+        manager<int> m;
+        m.set_density (rand () % 2 ? 0.0 : 1.1);
+        randCSP (m, 2 + rand () % 8, 6, 2 + rand () % 4);
+        backtracking<int> fc (m);
+        backtracking<int> mac (m);
+        fc.set_propagation (propagation_t::FORWARD_CHECKING);
+        mac.set_propagation (propagation_t::MAINTAINING_ARC_CONSISTENCY);
+        status_t fcstatus = fc.solve ();
+        status_t macstatus = mac.solve ();
+
+        // both have to agree and maintaining arc consistency can not expand
+        // more nodes because it uses the same ordering
+        ASSERT_EQ (fcstatus, macstatus);
+        ASSERT_LE (mac.get_nbnodes (), fc.get_nbnodes ());
+        if (macstatus == status_t::SATISFIABLE) {
+            ASSERT_TRUE (isSolution (m, mac.get_solution ()));
+        }
+        checkRestored (m);
+    }
+
+    // maintaining arc consistency also solves the n-queens and proves the
+    // pigeonhole problem to be unsatisfiable
+    for (auto n = 4 ; n <= 20 ; n++) {
+        manager<int> m;
+        queens (m, n);
+        backtracking<int> mac (m);
+        mac.set_propagation (propagation_t::MAINTAINING_ARC_CONSISTENCY);
+        ASSERT_EQ (mac.solve (), status_t::SATISFIABLE);
+        ASSERT_TRUE (isSolution (m, mac.get_solution ()));
+        checkRestored (m);
+    }
+    for (auto h = 1 ; h <= 6 ; h++) {
+        manager<int> m;
+        pigeons (m, h+1, h);
+        backtracking<int> mac (m);
+        mac.set_propagation (propagation_t::MAINTAINING_ARC_CONSISTENCY);
+        ASSERT_EQ (mac.solve (), status_t::UNSATISFIABLE);
+        checkRestored (m);
+    }
+}
+
+// Checks that all variable orderings decide correctly the satisfiability of
+// random CSP tasks with all propagations
+// ----------------------------------------------------------------------------
+TEST_F (BacktrackingFixture, VarOrderBacktracking) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a random CSP task small enough to be solved by brute force.
+        // Make sure that some constraints are stored as bit matrices
+        manager<int> m;
+        m.set_density (rand () % 2 ? 0.0 : 1.1);
+        randCSP (m, 2 + rand () % 5, 4, 2 + rand () % 4);
+        m.freeze ();
+        bool expected = bruteForce (m);
+
+        // and solve it with all orderings and propagations
+        for (auto propagation : {propagation_t::BACKTRACKING,
+                                 propagation_t::FORWARD_CHECKING,
+                                 propagation_t::MAINTAINING_ARC_CONSISTENCY}) {
+            checkOrdering<varorder_lex_t> (m, propagation, expected);
+            checkOrdering<varorder_dom_t> (m, propagation, expected);
+            checkOrdering<varorder_domddeg_t> (m, propagation, expected);
+            checkOrdering<varorder_domwdeg_t> (m, propagation, expected);
+        }
+    }
+
+    // all orderings also solve the n-queens and prove the pigeonhole problem
+    // to be unsatisfiable
+    for (auto n = 4 ; n <= 20 ; n++) {
+        manager<int> m;
+        queens (m, n);
+        checkOrdering<varorder_dom_t> (m, propagation_t::FORWARD_CHECKING, true);
+        checkOrdering<varorder_domddeg_t> (m, propagation_t::FORWARD_CHECKING, true);
+        checkOrdering<varorder_domwdeg_t> (m, propagation_t::MAINTAINING_ARC_CONSISTENCY, true);
+    }
+    for (auto h = 1 ; h <= 6 ; h++) {
+        manager<int> m;
+        pigeons (m, h+1, h);
+        checkOrdering<varorder_dom_t> (m, propagation_t::FORWARD_CHECKING, false);
+        checkOrdering<varorder_domddeg_t> (m, propagation_t::FORWARD_CHECKING, false);
+        checkOrdering<varorder_domwdeg_t> (m, propagation_t::MAINTAINING_ARC_CONSISTENCY, false);
+    }
+
+    // dom/wdeg increments the weight of the blocks causing wipe-outs
+    manager<int> m;
+    pigeons (m, 5, 4);
+    backtracking<int, varorder_domwdeg_t> search (m);
+    search.set_propagation (propagation_t::FORWARD_CHECKING);
+    ASSERT_EQ (search.solve (), status_t::UNSATISFIABLE);
+    size_t weight = 0;
+    for (size_t b = 0 ; b < m.get_mutextable ()->nbblocks () ; b++) {
+        ASSERT_GE (search.get_varorder ().get_weight (b), 1);
+        weight += search.get_varorder ().get_weight (b);
+    }
+    ASSERT_GT (weight, m.get_mutextable ()->nbblocks ());
+}
+
+// Checks that all value orderings decide correctly the satisfiability of random
+// CSP tasks with all propagations
+// ----------------------------------------------------------------------------
+TEST_F (BacktrackingFixture, ValOrderBacktracking) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a random CSP task small enough to be solved by brute force.
+        // Make sure that some constraints are stored as bit matrices
+        manager<int> m;
+        m.set_density (rand () % 2 ? 0.0 : 1.1);
+        randCSP (m, 2 + rand () % 5, 4, 2 + rand () % 4);
+        m.freeze ();
+        bool expected = bruteForce (m);
+
+        // and solve it with all value orderings and propagations
+        for (auto propagation : {propagation_t::BACKTRACKING,
+                                 propagation_t::FORWARD_CHECKING,
+                                 propagation_t::MAINTAINING_ARC_CONSISTENCY}) {
+            checkOrdering<varorder_lex_t, valorder_lex_t> (m, propagation, expected);
+            checkOrdering<varorder_lex_t, valorder_minmutexes_t> (m, propagation, expected);
+            checkOrdering<varorder_lex_t, valorder_maxsupport_t> (m, propagation, expected);
+            checkOrdering<varorder_lex_t, valorder_random_t> (m, propagation, expected);
+            checkOrdering<varorder_domwdeg_t, valorder_minmutexes_t> (m, propagation, expected);
+        }
+    }
+
+    // random orderings are fully determined by their seed
+    for (auto i = 0 ; i < NB_TESTS/1000 ; i++) {
+        manager<int> m;
+        queens (m, 8 + rand () % 8);
+        uint64_t seed = rand ();
+        backtracking<int, varorder_lex_t, valorder_random_t> search1 (m);
+        backtracking<int, varorder_lex_t, valorder_random_t> search2 (m);
+        search1.get_valorder ().set_seed (seed);
+        search2.get_valorder ().set_seed (seed);
+        ASSERT_EQ (search1.get_valorder ().get_seed (), seed);
+        ASSERT_EQ (search1.solve (), status_t::SATISFIABLE);
+        ASSERT_EQ (search2.solve (), status_t::SATISFIABLE);
+        ASSERT_EQ (search1.get_solution (), search2.get_solution ());
+        ASSERT_EQ (search1.get_nbnodes (), search2.get_nbnodes ());
+        ASSERT_TRUE (isSolution (m, search1.get_solution ()));
+        checkRestored (m);
+    }
+
+    // the pigeonhole problem is unsatisfiable with all value orderings
+    for (auto h = 1 ; h <= 6 ; h++) {
+        manager<int> m;
+        pigeons (m, h+1, h);
+        checkOrdering<varorder_dom_t, valorder_minmutexes_t> (m, propagation_t::FORWARD_CHECKING, false);
+        checkOrdering<varorder_dom_t, valorder_maxsupport_t> (m, propagation_t::FORWARD_CHECKING, false);
+        checkOrdering<varorder_dom_t, valorder_random_t> (m, propagation_t::MAINTAINING_ARC_CONSISTENCY, false);
+    }
+}
+
+// Checks that the number of enabled mutexes of every enabled value with
+// unassigned variables is maintained incrementally with all propagations
+// ----------------------------------------------------------------------------
+TEST_F (BacktrackingFixture, MaxSupportBacktracking) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a random CSP task where some constraints are stored as bit
+        // matrices
+        manager<int> m;
+        m.set_density (rand () % 2 ? 0.0 : 1.1);
+        randCSP (m, 2 + rand () % 5, 4, 2 + rand () % 4);
+        for (auto propagation : {propagation_t::BACKTRACKING,
+                                 propagation_t::FORWARD_CHECKING,
+                                 propagation_t::MAINTAINING_ARC_CONSISTENCY}) {
+            backtracking<int, varorder_lex_t, valorder_maxsupport_t> search (m);
+            search.set_propagation (propagation);
+            if (!search.open ()) {
+                search.close ();
+                continue;
+            }
+
+            // perform random assignments and undo some of them, verifying
+            // the counters of all enabled values after every change
+            const vartable_t& vartable = m.get_vartable ();
+            const valtable_t<int>& valtable = m.get_valtable ();
+            const shared_ptr<mutextable_t>& mutextable = m.get_mutextable ();
+            for (auto j = 0 ; j < 20 ; j++) {
+                size_t var = search.select ();
+                if (var == string::npos || (search.depth () && rand () % 3 == 0)) {
+                    if (search.depth ()) {
+                        search.pop ();
+                    }
+                } else {
+                    auto candidates = search.candidates (var);
+                    if (!candidates.empty ()) {
+                        search.push (candidates[rand () % candidates.size ()]);
+                    }
+                }
+                for (size_t idx1 = 0 ; idx1 < valtable.size () ; idx1++) {
+                    size_t nbfree = 0;
+                    for (size_t idx2 = 0 ; idx2 < valtable.size () ; idx2++) {
+                        nbfree += valtable.get_status (idx2) && mutextable->find (idx1, idx2) &&
+                            vartable.get_value (mutextable->get_var (idx2)) == string::npos;
+                    }
+                    if (valtable.get_status (idx1)) {
+                        ASSERT_EQ (search.get_valorder ().get_nbfree (idx1), nbfree);
+                    }
+                }
+            }
+            search.close ();
+            checkRestored (m);
+        }
+    }
+}
+
+// Checks that conflict-directed backjumping decides the same as chronological
+// backtracking with fewer nodes
+// ----------------------------------------------------------------------------
+TEST_F (BacktrackingFixture, BackjumpingBacktracking) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a random CSP task and solve it with and without backjumping
+        // with all propagations
+        manager<int> m;
+        m.set_density (rand () % 2 ? 0.0 : 1.1);
+        randCSP (m, 2 + rand () % 8, 6, 2 + rand () % 4);
+        for (auto propagation : {propagation_t::BACKTRACKING,
+                                 propagation_t::FORWARD_CHECKING,
+                                 propagation_t::MAINTAINING_ARC_CONSISTENCY}) {
+            backtracking<int> bt (m);
+            backtracking<int> cbj (m);
+            bt.set_propagation (propagation);
+            cbj.set_propagation (propagation);
+            cbj.set_backjumping (true);
+            ASSERT_TRUE (cbj.get_backjumping ());
+            status_t btstatus = bt.solve ();
+            status_t cbjstatus = cbj.solve ();
+
+            // both have to agree and backjumping can not expand more nodes
+            // because it uses the same static ordering
+            ASSERT_EQ (btstatus, cbjstatus);
+            ASSERT_LE (cbj.get_nbnodes (), bt.get_nbnodes ());
+            if (cbjstatus == status_t::SATISFIABLE) {
+                ASSERT_TRUE (isSolution (m, cbj.get_solution ()));
+            }
+            checkRestored (m);
+        }
+    }
+
+    // backjumping also works with dynamic orderings
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+        manager<int> m;
+        randCSP (m, 2 + rand () % 5, 4, 2 + rand () % 4);
+        m.freeze ();
+        bool expected = bruteForce (m);
+        backtracking<int, varorder_domwdeg_t, valorder_minmutexes_t> cbj (m);
+        cbj.set_propagation (propagation_t::FORWARD_CHECKING);
+        cbj.set_backjumping (true);
+        ASSERT_EQ (cbj.solve () == status_t::SATISFIABLE, expected);
+        if (expected) {
+            ASSERT_TRUE (isSolution (m, cbj.get_solution ()));
+        }
+        checkRestored (m);
+    }
+
+    // and it proves the pigeonhole problem to be unsatisfiable
+    for (auto h = 1 ; h <= 6 ; h++) {
+        manager<int> m;
+        pigeons (m, h+1, h);
+        backtracking<int> cbj (m);
+        cbj.set_backjumping (true);
+        ASSERT_EQ (cbj.solve (), status_t::UNSATISFIABLE);
+        checkRestored (m);
+    }
+}
+
+// Checks that nogood learning decides the same as chronological backtracking
+// ----------------------------------------------------------------------------
+TEST_F (BacktrackingFixture, LearningBacktracking) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a random CSP task and solve it with and without learning with
+        // all propagations, and also with backjumping. Make the store small
+        // so that it is frequently reduced
+        manager<int> m;
+        m.set_density (rand () % 2 ? 0.0 : 1.1);
+        randCSP (m, 2 + rand () % 8, 6, 2 + rand () % 4);
+        for (auto propagation : {propagation_t::BACKTRACKING,
+                                 propagation_t::FORWARD_CHECKING,
+                                 propagation_t::MAINTAINING_ARC_CONSISTENCY}) {
+            for (auto backjumping : {false, true}) {
+                backtracking<int> bt (m);
+                backtracking<int> learning (m);
+                bt.set_propagation (propagation);
+                learning.set_propagation (propagation);
+                learning.set_backjumping (backjumping);
+                learning.set_learning (true);
+                learning.set_max_nogoods (1 + rand () % 10);
+                ASSERT_TRUE (learning.get_learning ());
+                status_t btstatus = bt.solve ();
+                status_t lstatus = learning.solve ();
+
+                // both have to agree
+                ASSERT_EQ (btstatus, lstatus);
+                ASSERT_LE (learning.get_nogoods ().size (), learning.get_max_nogoods ());
+                if (lstatus == status_t::SATISFIABLE) {
+                    ASSERT_TRUE (isSolution (m, learning.get_solution ()));
+                }
+                checkRestored (m);
+            }
+        }
+    }
+
+    // learning also works with dynamic orderings
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+        manager<int> m;
+        randCSP (m, 2 + rand () % 5, 4, 2 + rand () % 4);
+        m.freeze ();
+        bool expected = bruteForce (m);
+        backtracking<int, varorder_domwdeg_t, valorder_random_t> learning (m);
+        learning.get_valorder ().set_seed (rand ());
+        learning.set_propagation (propagation_t::FORWARD_CHECKING);
+        learning.set_backjumping (true);
+        learning.set_learning (true);
+        ASSERT_EQ (learning.solve () == status_t::SATISFIABLE, expected);
+        if (expected) {
+            ASSERT_TRUE (isSolution (m, learning.get_solution ()));
+        }
+        checkRestored (m);
+    }
+
+    // and it proves the pigeonhole problem to be unsatisfiable learning
+    // nogoods on the way
+    for (auto h = 2 ; h <= 6 ; h++) {
+        manager<int> m;
+        pigeons (m, h+1, h);
+        backtracking<int> learning (m);
+        learning.set_propagation (propagation_t::FORWARD_CHECKING);
+        learning.set_learning (true);
+        ASSERT_EQ (learning.solve (), status_t::UNSATISFIABLE);
+        ASSERT_GT (learning.get_nogoods ().size (), 0);
+        checkRestored (m);
+    }
+}
+
+// Checks that restarts decide the same as chronological backtracking with all
+// policies and propagations
+// ----------------------------------------------------------------------------
+TEST_F (BacktrackingFixture, RestartBacktracking) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a random CSP task and solve it with and without restarts.
+        // Cutoffs are kept small so that restarts are frequent
+        manager<int> m;
+        m.set_density (rand () % 2 ? 0.0 : 1.1);
+        randCSP (m, 2 + rand () % 8, 6, 2 + rand () % 4);
+        for (auto propagation : {propagation_t::BACKTRACKING,
+                                 propagation_t::FORWARD_CHECKING,
+                                 propagation_t::MAINTAINING_ARC_CONSISTENCY}) {
+            for (auto restart : {restart_t::FIXED, restart_t::LUBY, restart_t::GEOMETRIC}) {
+                backtracking<int> bt (m);
+                backtracking<int, varorder_domwdeg_t, valorder_random_t> restarts (m);
+                bt.set_propagation (propagation);
+                restarts.set_propagation (propagation);
+                restarts.set_restart (restart, 1 + rand () % 3, 1.5);
+                restarts.set_learning (rand () % 2);
+                restarts.set_backjumping (rand () % 2);
+                restarts.get_valorder ().set_seed (rand ());
+                ASSERT_EQ (restarts.get_restart (), restart);
+                status_t btstatus = bt.solve ();
+                status_t rstatus = restarts.solve ();
+
+                // both have to agree
+                ASSERT_EQ (btstatus, rstatus);
+                ASSERT_LE (restarts.get_nbrestarts (), restarts.get_nbfailures ());
+                if (rstatus == status_t::SATISFIABLE) {
+                    ASSERT_TRUE (isSolution (m, restarts.get_solution ()));
+                }
+                checkRestored (m);
+            }
+        }
+    }
+
+    // the pigeonhole problem is proven unsatisfiable even restarting after
+    // every failure
+    for (auto h = 2 ; h <= 5 ; h++) {
+        manager<int> m;
+        pigeons (m, h+1, h);
+        backtracking<int> restarts (m);
+        restarts.set_propagation (propagation_t::FORWARD_CHECKING);
+        restarts.set_restart (restart_t::FIXED, 1);
+        ASSERT_EQ (restarts.solve (), status_t::UNSATISFIABLE);
+        ASSERT_GT (restarts.get_nbrestarts (), 0);
+        checkRestored (m);
+    }
+
+    // the nogoods recorded at restarts never exceed the maximum size of the
+    // store, even if no nogood is learnt
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+        manager<int> m;
+        size_t h = 3 + rand () % 3;
+        pigeons (m, h+1, h);
+        backtracking<int, varorder_lex_t, valorder_random_t> restarts (m);
+        restarts.set_propagation (propagation_t::FORWARD_CHECKING);
+        restarts.set_restart (restart_t::LUBY, 1);
+        restarts.set_max_nogoods (1 + rand () % 10);
+        restarts.get_valorder ().set_seed (rand ());
+        ASSERT_EQ (restarts.solve (), status_t::UNSATISFIABLE);
+        ASSERT_GT (restarts.get_nbrestarts (), 0);
+        ASSERT_LE (restarts.get_nogoods ().size (), restarts.get_max_nogoods ());
+        checkRestored (m);
+    }
+
+    // cutoffs have to be positive
+    manager<int> m;
+    backtracking<int> search (m);
+    ASSERT_THROW (search.set_restart (restart_t::LUBY, 0), invalid_argument);
+    ASSERT_THROW (search.set_restart (restart_t::GEOMETRIC, 1, 0.5), invalid_argument);
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,125 @@
+// -*- coding: utf-8 -*-
+// TSTbranchandbound.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <sáb 28-08-2021 12:32:40.071935218 (1630146760)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests of CSPMUX depth-first branch and bound
+
+#include "../TSThelpers.h"
+#include "../fixtures/TSTbranchandboundfixture.h"
+
+// Checks that branch and bound is correctly created, and that tasks without
+// soft constraints are solved at no cost
+// ----------------------------------------------------------------------------
+TEST_F (BranchAndBoundFixture, EmptyBranchAndBound) {
+
+    // a task without variables has exactly one solution at no cost
+    manager<int> m1;
+    branchandbound<int> search1 (m1);
+    ASSERT_EQ (search1.get_status (), status_t::UNKNOWN);
+    ASSERT_EQ (search1.get_upper_bound (), numeric_limits<size_t>::max ());
+    ASSERT_EQ (search1.solve (), status_t::SATISFIABLE);
+    ASSERT_EQ (search1.get_cost (), 0);
+    ASSERT_TRUE (search1.get_solution ().empty ());
+
+    // and tasks with only hard constraints are solved as by backtracking
+    for (size_t n = 1 ; n <= 8 ; n++) {
+        manager<int> m2;
+        queens (m2, n);
+        branchandbound<int> search2 (m2);
+        search2.set_propagation (propagation_t (rand () % 3));
+        status_t status = search2.solve ();
+        ASSERT_EQ (status, (n == 2 || n == 3) ? status_t::UNSATISFIABLE : status_t::SATISFIABLE);
+        if (status == status_t::SATISFIABLE) {
+            ASSERT_EQ (search2.get_cost (), 0);
+            ASSERT_EQ (search2.get_nbsolutions (), 1);
+            ASSERT_TRUE (isSolution (m2, search2.get_solution ()));
+        } else {
+            ASSERT_EQ (search2.get_cost (), numeric_limits<size_t>::max ());
+        }
+        checkRestored (m2);
+    }
+}
+
+// Checks that the cheapest solution of random CSP tasks with soft constraints
+// is found with any propagation
+// ----------------------------------------------------------------------------
+TEST_F (BranchAndBoundFixture, RandomBranchAndBound) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create a random CSP task small enough to be solved by brute force
+        manager<int> m;
+        m.set_density (rand () % 2 ? 0.0 : 1.1);
+        randWCSP (m, 2 + rand () % 5, 4, 2 + rand () % 6, 1 + rand () % 10);
+        size_t expected = bruteCost (m);
+
+        // and solve it with a random propagation
+        branchandbound<int> search (m);
+        search.set_propagation (propagation_t (rand () % 3));
+        status_t status = search.solve ();
+        ASSERT_EQ (search.get_cost (), expected);
+        if (expected == numeric_limits<size_t>::max ()) {
+            ASSERT_EQ (status, status_t::UNSATISFIABLE);
+        } else {
+            ASSERT_EQ (status, status_t::SATISFIABLE);
+            ASSERT_TRUE (isSolution (m, search.get_solution ()));
+            ASSERT_EQ (m.cost (search.get_solution ()), expected);
+            ASSERT_GE (search.get_nbsolutions (), 1);
+        }
+        checkRestored (m);
+    }
+}
+
+// Checks that solutions have to be strictly cheaper than the upper bound and
+// that searches are interrupted when time is exhausted
+// ----------------------------------------------------------------------------
+TEST_F (BranchAndBoundFixture, UpperBoundBranchAndBound) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create a random CSP task, and skip it unless it has at least one
+        // solution
+        manager<int> m;
+        randWCSP (m, 2 + rand () % 5, 4, 3 + rand () % 6, 1 + rand () % 10);
+        size_t expected = bruteCost (m);
+        if (expected == numeric_limits<size_t>::max ()) {
+            continue;
+        }
+
+        // no solution is found with the optimal cost as upper bound
+        branchandbound<int> search (m);
+        search.set_propagation (propagation_t (rand () % 3));
+        search.set_upper_bound (expected);
+        ASSERT_EQ (search.solve (), status_t::UNSATISFIABLE);
+        ASSERT_EQ (search.get_nbsolutions (), 0);
+
+        // while the optimal solution is the only one found right above it
+        search.set_upper_bound (expected + 1);
+        ASSERT_EQ (search.solve (), status_t::SATISFIABLE);
+        ASSERT_EQ (search.get_cost (), expected);
+        ASSERT_EQ (search.get_nbsolutions (), 1);
+        checkRestored (m);
+    }
+
+    // a large task is interrupted right away with no time
+    manager<int> m;
+    queens (m, 30);
+    m.add_soft_constraint ([] (int val1, int val2) {
+        return val1 + val2;
+    }, variable_t{"Q0"}, variable_t{"Q1"});
+    branchandbound<int> search (m);
+    search.set_time_limit (0.0);
+    ASSERT_EQ (search.solve (), status_t::TIME_LIMIT);
+    checkRestored (m);
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,143 @@
+// -*- coding: utf-8 -*-
+// TSTcounter.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <jue 26-08-2021 11:41:27.685219004 (1629970887)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests of CSPMUX counters of solutions
+
+#include "../TSThelpers.h"
+#include "../fixtures/TSTcounterfixture.h"
+
+// Checks that counters are correctly created, that tasks without variables have
+// exactly one solution and that counts are correctly printed
+// ----------------------------------------------------------------------------
+TEST_F (CounterFixture, EmptyCounter) {
+
+    manager<int> m;
+    counter<int> c (m);
+    ASSERT_EQ (c.get_status (), status_t::UNKNOWN);
+    ASSERT_TRUE (c.get_decomposition ());
+    ASSERT_GT (c.get_max_cache (), 0);
+    ASSERT_EQ (c.count (), status_t::SATISFIABLE);
+    ASSERT_TRUE (c.get_nbsolutions () == 1);
+
+    // counts beyond 64 bits are printed exactly
+    ASSERT_EQ (counter<int>::to_string (0), "0");
+    ASSERT_EQ (counter<int>::to_string (1234567890), "1234567890");
+    counter<int>::count_t count = 1;
+    for (auto i = 0 ; i < 38 ; i++) {
+        count *= 10;
+    }
+    ASSERT_EQ (counter<int>::to_string (count), "1" + string (38, '0'));
+}
+
+// Checks that the number of solutions of the n-queens problem is correctly
+// computed with and without decomposition and caching, and any propagation
+// ----------------------------------------------------------------------------
+TEST_F (CounterFixture, QueensCounter) {
+
+    // number of solutions of the n-queens problem with n in [1, 8]
+    vector<size_t> expected {1, 0, 0, 2, 10, 4, 40, 92};
+    for (size_t n = 1 ; n <= expected.size () ; n++) {
+        manager<int> m;
+        queens (m, n);
+        for (auto propagation : {propagation_t::BACKTRACKING,
+                                 propagation_t::FORWARD_CHECKING,
+                                 propagation_t::MAINTAINING_ARC_CONSISTENCY}) {
+            counter<int> c (m);
+            c.set_propagation (propagation);
+            c.set_decomposition (rand () % 2);
+            c.set_max_cache (rand () % 2 ? 0 : 1 + rand () % 100);
+            ASSERT_EQ (c.count (), expected[n-1] ? status_t::SATISFIABLE : status_t::UNSATISFIABLE);
+            ASSERT_TRUE (c.get_nbsolutions () == expected[n-1]);
+            checkRestored (m);
+        }
+    }
+}
+
+// Checks that the number of solutions of random CSP tasks is correctly
+// computed
+// ----------------------------------------------------------------------------
+TEST_F (CounterFixture, RandomCounter) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create a random CSP task small enough to be solved by brute force.
+        // Mutexes are sparse so that there are several components
+        manager<int> m;
+        m.set_density (rand () % 2 ? 0.0 : 1.1);
+        randCSP (m, 2 + rand () % 6, 4, 2 + rand () % 10);
+        size_t expected = bruteCount (m);
+
+        // and count them with random settings
+        counter<int> c (m);
+        c.set_propagation (propagation_t (rand () % 3));
+        c.set_decomposition (rand () % 2);
+        c.set_max_cache (rand () % 2 ? 0 : 1 + rand () % 100);
+        ASSERT_EQ (c.count () == status_t::SATISFIABLE, expected > 0);
+        ASSERT_TRUE (c.get_nbsolutions () == expected);
+        checkRestored (m);
+    }
+}
+
+// Checks that counts beyond 64 bits are exactly computed thanks to the
+// decomposition into components and caching
+// ----------------------------------------------------------------------------
+TEST_F (CounterFixture, LargeCounter) {
+
+    // 38 independent variables with 10 values each have 10^38 solutions,
+    // which are counted as the product of 38 components
+    manager<int> m1;
+    for (int i = 0 ; i < 38 ; i++) {
+        variable_t variable {"X" + to_string (i)};
+        vector<value_t<int>> domain;
+        for (int j = 0 ; j < 10 ; j++) {
+            domain.push_back (value_t<int>{j});
+        }
+        m1.add_variable (variable, domain);
+    }
+    counter<int> c1 (m1);
+    ASSERT_EQ (c1.count (), status_t::SATISFIABLE);
+    ASSERT_EQ (counter<int>::to_string (c1.get_nbsolutions ()), "1" + string (38, '0'));
+    ASSERT_EQ (c1.get_nbsplits (), 1);
+    checkRestored (m1);
+
+    // a chain of 100 variables with 3 values each has 3*2^99 solutions, which
+    // are counted in linear time thanks to caching
+    for (auto propagation : {propagation_t::BACKTRACKING,
+                             propagation_t::FORWARD_CHECKING,
+                             propagation_t::MAINTAINING_ARC_CONSISTENCY}) {
+        manager<int> m2;
+        chain (m2, 100, 3);
+        counter<int> c2 (m2);
+        c2.set_propagation (propagation);
+        ASSERT_EQ (c2.count (), status_t::SATISFIABLE);
+        counter<int>::count_t expected = 3;
+        for (auto i = 0 ; i < 99 ; i++) {
+            expected *= 2;
+        }
+        ASSERT_TRUE (c2.get_nbsolutions () == expected);
+        ASSERT_GT (c2.get_nbhits (), 0);
+        ASSERT_LT (c2.get_nbnodes (), 1000);
+        checkRestored (m2);
+    }
+
+    // while with a tiny time limit and no caching, the count is interrupted
+    manager<int> m3;
+    chain (m3, 100, 3);
+    counter<int> c3 (m3);
+    c3.set_max_cache (0);
+    c3.set_time_limit (0.0);
+    ASSERT_EQ (c3.count (), status_t::TIME_LIMIT);
+    checkRestored (m3);
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,160 @@
+// -*- coding: utf-8 -*-
+// TSTenumerator.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <vie 27-08-2021 10:06:48.902513677 (1630051608)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests of CSPMUX enumerators of solutions
+
+#include "../TSThelpers.h"
+#include "../fixtures/TSTenumeratorfixture.h"
+
+// Checks that tasks without variables have exactly one solution and that wrong
+// projections are rejected
+// ----------------------------------------------------------------------------
+TEST_F (EnumeratorFixture, EmptyEnumerator) {
+
+    manager<int> m;
+    ASSERT_EQ (m.for_each_solution ([] (const vartable_t& vartable) {
+        return true;
+    }), 1);
+    enumerator<int> e = m.solutions ();
+    ASSERT_FALSE (e.done ());
+    ASSERT_TRUE (e.next ());
+    ASSERT_FALSE (e.next ());
+    ASSERT_TRUE (e.done ());
+    ASSERT_EQ (e.get_nbsolutions (), 1);
+    ASSERT_THROW (m.solutions (vector<size_t> {0}), invalid_argument);
+}
+
+// Checks that all solutions of the n-queens problem are enumerated exactly once
+// both with callbacks and iterators
+// ----------------------------------------------------------------------------
+TEST_F (EnumeratorFixture, QueensEnumerator) {
+
+    // number of solutions of the n-queens problem with n in [1, 8]
+    vector<size_t> expected {1, 0, 0, 2, 10, 4, 40, 92};
+    for (size_t n = 1 ; n <= expected.size () ; n++) {
+        manager<int> m;
+        queens (m, n);
+
+        // enumerate them with a callback
+        set<vector<size_t>> solutions;
+        ASSERT_EQ (m.for_each_solution ([&] (const vartable_t& vartable) {
+            solutions.insert (getAssignment (vartable));
+            return true;
+        }), expected[n-1]);
+        ASSERT_EQ (solutions.size (), expected[n-1]);
+        for (auto& solution : solutions) {
+            ASSERT_TRUE (isSolution (m, solution));
+        }
+        checkRestored (m);
+
+        // and with an iterator
+        size_t nbsolutions = 0;
+        for (const vartable_t& vartable : m.solutions ()) {
+            ASSERT_TRUE (solutions.find (getAssignment (vartable)) != solutions.end ());
+            nbsolutions++;
+        }
+        ASSERT_EQ (nbsolutions, expected[n-1]);
+        checkRestored (m);
+    }
+}
+
+// Checks that all solutions of random CSP tasks are enumerated, that the
+// enumeration can be stopped at any time, and that projections enumerate every
+// assignment of the projected variables exactly once
+// ----------------------------------------------------------------------------
+TEST_F (EnumeratorFixture, RandomEnumerator) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create a random CSP task small enough to be solved by brute force
+        manager<int> m;
+        m.set_density (rand () % 2 ? 0.0 : 1.1);
+        randCSP (m, 2 + rand () % 5, 4, 2 + rand () % 4);
+        size_t expected = bruteCount (m);
+
+        // enumerate all solutions
+        ASSERT_EQ (m.for_each_solution ([&] (const vartable_t& vartable) {
+            return isSolution (m, getAssignment (vartable));
+        }), expected);
+        checkRestored (m);
+
+        // enumerate them with the propagation and orderings of a search
+        // configured beforehand
+        {
+            enumerator<int, varorder_domwdeg_t, valorder_random_t> e (m, vector<size_t>(),
+                                                                      numeric_limits<size_t>::max ());
+            e.get_search ().set_propagation (propagation_t (rand () % 3));
+            e.get_search ().get_valorder ().set_seed (rand ());
+            set<vector<size_t>> solutions;
+            while (e.next ()) {
+                ASSERT_TRUE (isSolution (m, getAssignment (e.get_vartable ())));
+                solutions.insert (getAssignment (e.get_vartable ()));
+            }
+            ASSERT_EQ (e.get_nbsolutions (), expected);
+            ASSERT_EQ (solutions.size (), expected);
+        }
+        checkRestored (m);
+
+        // enumerate a maximum number of solutions
+        size_t max_solutions = rand () % (1 + expected);
+        ASSERT_EQ (m.for_each_solution ([] (const vartable_t& vartable) {
+            return true;
+        }, vector<size_t>(), max_solutions), max_solutions);
+        checkRestored (m);
+
+        // stop the enumeration after a random number of solutions, both with
+        // a callback and abandoning an enumerator
+        size_t stop = 1 + rand () % (1 + expected);
+        size_t nbsolutions = 0;
+        m.for_each_solution ([&] (const vartable_t& vartable) {
+            return ++nbsolutions < stop;
+        });
+        ASSERT_EQ (nbsolutions, min (stop, expected));
+        checkRestored (m);
+        {
+            enumerator<int> e = m.solutions ();
+            for (size_t j = 0 ; j < stop && e.next () ; j++) {
+                ASSERT_TRUE (isSolution (m, getAssignment (e.get_vartable ())));
+            }
+        }
+        checkRestored (m);
+
+        // and project the solutions onto a random non-empty subset of
+        // variables
+        vector<size_t> projection;
+        for (size_t j = 0 ; j < m.get_vartable ().size () ; j++) {
+            if (rand () % 2) {
+                projection.push_back (j);
+            }
+        }
+        if (projection.empty ()) {
+            projection.push_back (0);
+        }
+        set<vector<size_t>> projected = bruteProjection (m, projection);
+        set<vector<size_t>> enumerated;
+        size_t nbprojected = m.for_each_solution ([&] (const vartable_t& vartable) {
+            EXPECT_TRUE (isSolution (m, getAssignment (vartable)));
+            vector<size_t> assignment;
+            for (auto var : projection) {
+                assignment.push_back (vartable.get_value (var));
+            }
+            enumerated.insert (assignment);
+            return true;
+        }, projection);
+        ASSERT_EQ (nbprojected, projected.size ());
+        ASSERT_EQ (enumerated, projected);
+        checkRestored (m);
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
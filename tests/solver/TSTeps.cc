@@ -0,0 +1,216 @@
+// -*- coding: utf-8 -*-
+// TSTeps.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <mié 25-08-2021 11:03:40.552908163 (1629882220)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests of CSPMUX embarrassingly parallel searches
+
+#include "../TSThelpers.h"
+#include "../fixtures/TSTepsfixture.h"
+
+// Checks that embarrassingly parallel searches are correctly created and that
+// tasks without variables have exactly one solution
+// ----------------------------------------------------------------------------
+TEST_F (EpsFixture, EmptyEps) {
+
+    manager<int> m;
+    eps<int> search (m);
+    ASSERT_GE (search.get_nbworkers (), 1);
+    ASSERT_GE (search.get_ratio (), 1);
+    ASSERT_EQ (search.get_status (), status_t::UNKNOWN);
+    ASSERT_THROW (search.set_nbworkers (0), invalid_argument);
+    ASSERT_THROW (search.set_ratio (0), invalid_argument);
+    search.set_nbworkers (4);
+    ASSERT_EQ (search.count (), status_t::SATISFIABLE);
+    ASSERT_EQ (search.get_nbsolutions (), 1);
+    ASSERT_EQ (search.get_subproblems ().size (), 1);
+    ASSERT_EQ (search.get_depth (), 0);
+    ASSERT_EQ (search.solve (), status_t::SATISFIABLE);
+    ASSERT_TRUE (search.get_solution ().empty ());
+}
+
+// Checks that the number of solutions of the n-queens problem is correctly
+// computed with any number of workers, subproblems and propagation
+// ----------------------------------------------------------------------------
+TEST_F (EpsFixture, QueensEps) {
+
+    // number of solutions of the n-queens problem with n in [1, 8]
+    vector<size_t> expected {1, 0, 0, 2, 10, 4, 40, 92};
+    for (size_t n = 1 ; n <= expected.size () ; n++) {
+        manager<int> m;
+        queens (m, n);
+        for (auto propagation : {propagation_t::BACKTRACKING,
+                                 propagation_t::FORWARD_CHECKING,
+                                 propagation_t::MAINTAINING_ARC_CONSISTENCY}) {
+            eps<int, varorder_domwdeg_t> search (m);
+            search.set_nbworkers (1 + rand () % 8);
+            search.set_ratio (1 + rand () % 50);
+            search.set_propagation (propagation);
+            ASSERT_EQ (search.count (), expected[n-1] ? status_t::SATISFIABLE : status_t::UNSATISFIABLE);
+            ASSERT_EQ (search.get_nbsolutions (), expected[n-1]);
+            ASSERT_TRUE (search.get_solution ().empty ());
+            checkRestored (m);
+        }
+    }
+}
+
+// Checks that embarrassingly parallel searches find a solution of random CSP
+// tasks if and only if there is one, that they count all of them, and that the
+// solution found is the same found by sequential search regardless of the
+// number of workers
+// ----------------------------------------------------------------------------
+TEST_F (EpsFixture, RandomEps) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a random CSP task small enough to be solved by brute force
+        manager<int> m;
+        m.set_density (rand () % 2 ? 0.0 : 1.1);
+        randCSP (m, 2 + rand () % 5, 4, 2 + rand () % 4);
+        size_t expected = bruteCount (m);
+        propagation_t propagation = propagation_t (rand () % 3);
+        backtracking<int> sequential (m);
+        sequential.set_propagation (propagation);
+        sequential.solve ();
+
+        // and solve it with a random number of workers and subproblems
+        eps<int> search (m);
+        search.set_nbworkers (1 + rand () % 8);
+        search.set_ratio (1 + rand () % 10);
+        search.set_propagation (propagation);
+        ASSERT_EQ (search.solve () == status_t::SATISFIABLE, expected > 0);
+        ASSERT_EQ (search.get_solution (), sequential.get_solution ());
+        if (expected) {
+            ASSERT_TRUE (isSolution (m, search.get_solution ()));
+        }
+        checkRestored (m);
+        ASSERT_EQ (search.count () == status_t::SATISFIABLE, expected > 0);
+        ASSERT_EQ (search.get_nbsolutions (), expected);
+        for (auto& subproblem : search.get_subproblems ()) {
+            ASSERT_LE (subproblem.size (), search.get_depth ());
+        }
+        checkRestored (m);
+    }
+}
+
+// Checks that unsatisfiable tasks are proven so after decomposing them into
+// enough subproblems
+// ----------------------------------------------------------------------------
+TEST_F (EpsFixture, PigeonsEps) {
+
+    for (auto h = 2 ; h <= 7 ; h++) {
+        manager<int> m;
+        pigeons (m, h+1, h);
+        eps<int> search (m);
+        search.set_nbworkers (4);
+        search.set_ratio (10);
+        search.set_propagation (propagation_t::FORWARD_CHECKING);
+        ASSERT_EQ (search.count (), status_t::UNSATISFIABLE);
+        ASSERT_EQ (search.get_nbsolutions (), 0);
+
+        // either enough subproblems were generated or all of them were
+        // refuted while decomposing the task
+        ASSERT_TRUE (search.get_subproblems ().size () >= 40 ||
+                     search.get_subproblems ().empty ());
+        checkRestored (m);
+    }
+
+    // while with a tiny time limit, the search is interrupted
+    manager<int> m;
+    pigeons (m, 12, 11);
+    eps<int> search (m);
+    search.set_nbworkers (2);
+    search.set_time_limit (0.0);
+    ASSERT_EQ (search.count (), status_t::TIME_LIMIT);
+    checkRestored (m);
+}
+
+// Checks that, when looking for the first solution only, workers give up the
+// subproblems after the first satisfiable one found, no matter how hard they are
+// ----------------------------------------------------------------------------
+TEST_F (EpsFixture, FirstSolutionEps) {
+
+    // the first variable splits the task into two subproblems. Next, 13
+    // pigeons have to be placed in 13 holes in the first subproblem, while
+    // the last hole is forbidden in the second one, so that it takes very long
+    // to prove it unsatisfiable. Finally, other ten variables take different
+    // values, the last one being forced to take the first value, so that the
+    // first subproblem also takes a while and the second one is started
+    // meanwhile
+    manager<int> m;
+    variable_t split {"A"};
+    vector<value_t<int>> domain {value_t<int>{0}, value_t<int>{1}};
+    m.add_variable (split, domain);
+    for (int i = 0 ; i < 13 ; i++) {
+        variable_t variable {"P" + to_string (i)};
+        vector<value_t<int>> holes;
+        for (int j = 0 ; j < 13 ; j++) {
+            holes.push_back (value_t<int>{j});
+        }
+        m.add_variable (variable, holes);
+    }
+    for (int i = 0 ; i < 10 ; i++) {
+        variable_t variable {"Q" + to_string (i)};
+        vector<value_t<int>> values;
+        for (int j = 0 ; j < ((i < 9) ? 10 : 1) ; j++) {
+            values.push_back (value_t<int>{j});
+        }
+        m.add_variable (variable, values);
+    }
+    auto neq = [] (int value1, int value2) {
+        return value1 != value2;
+    };
+    for (int i = 0 ; i < 13 ; i++) {
+        m.add_constraint ([] (int value, int hole) {
+            return !value || hole != 12;
+        }, split, variable_t{"P" + to_string (i)});
+        for (int j = i + 1 ; j < 13 ; j++) {
+            m.add_constraint (neq, variable_t{"P" + to_string (i)}, variable_t{"P" + to_string (j)});
+        }
+    }
+    for (int i = 0 ; i < 10 ; i++) {
+        for (int j = i + 1 ; j < 10 ; j++) {
+            m.add_constraint (neq, variable_t{"Q" + to_string (i)}, variable_t{"Q" + to_string (j)});
+        }
+    }
+
+    // the search stops right after the first subproblem is solved
+    eps<int> search (m);
+    search.set_nbworkers (2);
+    search.set_ratio (1);
+    search.set_time_limit (30.0);
+    ASSERT_EQ (search.solve (), status_t::SATISFIABLE);
+    ASSERT_EQ (search.get_subproblems ().size (), 2);
+    ASSERT_EQ (search.get_solution ()[0], 0);
+    ASSERT_LT (search.get_elapsed (), 5.0);
+    checkRestored (m);
+}
+
+// Checks that exceptions raised by any worker are rethrown once all of them
+// have been stopped
+// ----------------------------------------------------------------------------
+TEST_F (EpsFixture, ExceptionEps) {
+
+    // subproblems assign only one variable, so that exceptions are raised by
+    // the workers and not while decomposing the task
+    for (auto nbworkers = 1 ; nbworkers <= 4 ; nbworkers++) {
+        manager<int> m;
+        pigeons (m, 13, 12);
+        eps<int, varorder_throw_t> search (m);
+        search.set_nbworkers (nbworkers);
+        search.set_ratio (2);
+        ASSERT_THROW (search.count (), runtime_error);
+        ASSERT_EQ (search.get_depth (), 1);
+        checkRestored (m);
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,106 @@
+// -*- coding: utf-8 -*-
+// TSTlocalsearch.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 30-08-2021 10:33:05.918273640 (1630312385)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests of CSPMUX local searches
+
+#include "../TSThelpers.h"
+#include "../fixtures/TSTlocalsearchfixture.h"
+
+// Checks that local searches are correctly created and that tasks without
+// variables are immediately solved
+// ----------------------------------------------------------------------------
+TEST_F (LocalsearchFixture, EmptyLocalsearch) {
+
+    manager<int> m;
+    localsearch<int> search (m);
+    ASSERT_EQ (search.get_status (), status_t::UNKNOWN);
+    ASSERT_GT (search.get_tenure (), 0);
+    ASSERT_GT (search.get_restart (), 0);
+    ASSERT_THROW (search.set_walk (-0.1), invalid_argument);
+    ASSERT_THROW (search.set_walk (1.1), invalid_argument);
+    ASSERT_EQ (search.solve (), status_t::SATISFIABLE);
+    ASSERT_TRUE (search.get_solution ().empty ());
+    ASSERT_EQ (search.get_nbviolations (), 0);
+    ASSERT_EQ (search.get_nbflips (), 0);
+}
+
+// Checks that the n-queens problem is solved with any tenure and random walk
+// ----------------------------------------------------------------------------
+TEST_F (LocalsearchFixture, QueensLocalsearch) {
+
+    for (auto n : {1, 4, 8, 20, 50}) {
+        manager<int> m;
+        queens (m, n);
+        localsearch<int> search (m);
+        search.set_seed (rand ());
+        search.set_tenure (rand () % 10);
+        search.set_walk ((rand () % 10) / 100.0);
+        ASSERT_EQ (search.solve (), status_t::SATISFIABLE);
+        ASSERT_TRUE (isSolution (m, search.get_solution ()));
+        ASSERT_EQ (search.get_nbviolations (), 0);
+        checkRestored (m);
+    }
+}
+
+// Checks that random CSP tasks with solutions are solved, that unsatisfiable
+// ones exhaust the budget of flips, and that the number of violations of the
+// best assignment is always correctly computed
+// ----------------------------------------------------------------------------
+TEST_F (LocalsearchFixture, RandomLocalsearch) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create a random CSP task small enough to be solved by brute force
+        manager<int> m;
+        randCSP (m, 2 + rand () % 6, 4, 2 + rand () % 10);
+        bool expected = bruteForce (m);
+
+        // and run a local search with random settings
+        localsearch<int> search (m);
+        search.set_seed (rand ());
+        search.set_tenure (rand () % 5);
+        search.set_walk ((rand () % 20) / 100.0);
+        search.set_restart (100 + rand () % 100);
+        search.set_flip_limit (100'000);
+        status_t status = search.solve ();
+        ASSERT_EQ (status, expected ? status_t::SATISFIABLE : status_t::NODE_LIMIT);
+        ASSERT_EQ (search.get_nbviolations (), violations (m, search.get_solution ()));
+        if (expected) {
+            ASSERT_TRUE (isSolution (m, search.get_solution ()));
+        } else {
+            ASSERT_GT (search.get_nbviolations (), 0);
+            ASSERT_EQ (search.get_nbflips (), 100'000);
+            ASSERT_GT (search.get_nbrestarts (), 0);
+        }
+        checkRestored (m);
+    }
+}
+
+// Checks that searches are interrupted when time is exhausted
+// ----------------------------------------------------------------------------
+TEST_F (LocalsearchFixture, TimeLimitLocalsearch) {
+
+    // the pigeonhole problem with more pigeons than holes has no solution,
+    // and the best assignment violates at least one mutex
+    manager<int> m;
+    pigeons (m, 12, 11);
+    localsearch<int> search (m);
+    search.set_time_limit (0.1);
+    ASSERT_EQ (search.solve (), status_t::TIME_LIMIT);
+    ASSERT_GT (search.get_nbflips (), 0);
+    ASSERT_EQ (search.get_nbviolations (), violations (m, search.get_solution ()));
+    ASSERT_GT (search.get_nbviolations (), 0);
+    checkRestored (m);
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
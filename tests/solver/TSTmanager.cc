@@ -38,7 +38,7 @@ map<int, function<bool (const time_t, const time_t)>> tfuncs = {
 {5, [] (const time_t val1, const time_t val2)->bool { return difftime (val2, val1) <  0.0;}},
 };
 
-// Checks the creation of a manager creates empty tables and multivector
+// Checks the creation of a manager creates empty tables and no table of mutexes
 // ----------------------------------------------------------------------------
 TEST_F (ManagerFixture, EmptyManager) {
 
@@ -51,8 +51,8 @@ TEST_F (ManagerFixture, EmptyManager) {
         ASSERT_EQ (m.get_vartable ().size (), 0);
         ASSERT_EQ (m.get_valtable ().size (), 0);
 
-        // finally, make sure also that the multivector is empty
-        ASSERT_EQ (m.get_multivector(), nullptr);
+        // finally, make sure also that the table of mutexes is empty
+        ASSERT_EQ (m.get_mutextable(), nullptr);
     }
 }
 
@@ -108,8 +108,8 @@ TEST_F (ManagerFixture, AddVariablesManager) {
             ASSERT_EQ (vartable.get_value (j), string::npos);
         }
 
-        // Before leaving this case, ensure that the multivector is still null
-        ASSERT_EQ (m.get_multivector(), nullptr);
+        // Before leaving this case, ensure that the table of mutexes is still null
+        ASSERT_EQ (m.get_mutextable(), nullptr);
     }
 }
 
@@ -338,9 +338,9 @@ TEST_F (ManagerFixture, NbEnabledMutexesManager) {
         // the selected variables we'll have an arbitrary number of them). Make
         // sure the number of enabled mutexes is strictly equal to the number of
         // mutexes stored in each value
-        const unique_ptr<multivector_t>& multivector = m.get_multivector ();
+        const shared_ptr<mutextable_t>& mutextable = m.get_mutextable ();
         for (size_t j = 0 ; j < valtable.size () ; j++) {
-            ASSERT_EQ ((*multivector)[j].size (), valtable.get_nbmutexes (j));
+            ASSERT_EQ (mutextable->degree (j), valtable.get_nbmutexes (j));
         }
     }
 }
@@ -458,8 +458,8 @@ TEST_F (ManagerFixture, InvokeConstraintIntManager) {
         }, variable_t{names[variables[0]]}, variable_t{names[variables[1]]});
 
         // before making the important assertion, ensure also that after posting
-        // constraints, the multivector is not null anymore
-        ASSERT_NE (m.get_multivector(), nullptr);
+        // constraints, the table of mutexes is not null anymore
+        ASSERT_NE (m.get_mutextable(), nullptr);
 
         // and that posting additional constraints automatically raises an
         // exception
@@ -512,7 +512,7 @@ TEST_F (ManagerFixture, MutexIntManager) {
         // have been properly recognized
         const valtable_t<int>& valtable = m.get_valtable ();
         const vartable_t& vartable = m.get_vartable ();
-        const unique_ptr<multivector_t>& multivector = m.get_multivector();
+        const shared_ptr<mutextable_t>& mutextable = m.get_mutextable();
 
         // get the index to the first and last value in the domain of each
         // variable
@@ -541,18 +541,17 @@ TEST_F (ManagerFixture, MutexIntManager) {
                 // verify that those cases where the quotient was randomly
                 // selected to be 6 generate no mutexes
                 if (quotient==6) {
-                    ASSERT_EQ ((*multivector)[idx1].size (), 0);
+                    ASSERT_EQ (mutextable->degree (idx1), 0);
                 } else {
 
-                    // multivectors store mutexes explicitly and thus, if idx2
-                    // is not a mutex of idx1 it is just not present in its
-                    // vector of mutexes
-                    ASSERT_TRUE ( ( multivector->find (idx1, idx2) && (num1 + num2) % quotient == 0 ) ||
-                                  (!multivector->find (idx1, idx2) && (num1 + num2) % quotient != 0));
+                    // if idx2 is not a mutex of idx1 it is just not found in
+                    // the table of mutexes
+                    ASSERT_TRUE ( ( mutextable->find (idx1, idx2) && (num1 + num2) % quotient == 0 ) ||
+                                  (!mutextable->find (idx1, idx2) && (num1 + num2) % quotient != 0));
 
                     // Mutexes are reflective, thus verify the opposite as well
-                    ASSERT_TRUE ( ( multivector->find (idx2, idx1) && (num1 + num2) % quotient == 0 ) ||
-                                  (!multivector->find (idx2, idx1) && (num1 + num2) % quotient != 0));
+                    ASSERT_TRUE ( ( mutextable->find (idx2, idx1) && (num1 + num2) % quotient == 0 ) ||
+                                  (!mutextable->find (idx2, idx1) && (num1 + num2) % quotient != 0));
                 }
             }
         }
@@ -672,8 +671,8 @@ TEST_F (ManagerFixture, InvokeConstraintStringManager) {
         }, variable_t{names[variables[0]]}, variable_t{names[variables[1]]});
 
         // before making the important assertion, ensure also that after posting
-        // constraints, the multivector is not null anymore
-        ASSERT_NE (m.get_multivector(), nullptr);
+        // constraints, the table of mutexes is not null anymore
+        ASSERT_NE (m.get_mutextable(), nullptr);
 
         // and that posting additional constraints automatically raises an
         // exception
@@ -721,7 +720,7 @@ TEST_F (ManagerFixture, MutexStringManager) {
         // have been properly recognized
         const valtable_t<string>& valtable = m.get_valtable ();
         const vartable_t& vartable = m.get_vartable ();
-        const unique_ptr<multivector_t>& multivector = m.get_multivector();
+        const shared_ptr<mutextable_t>& mutextable = m.get_mutextable();
 
         // get the index to the first and last value in the domain of each
         // variable
@@ -749,13 +748,13 @@ TEST_F (ManagerFixture, MutexStringManager) {
 
                 // and verify that only those cases where either argument
                 // contains the letter randomly selected is recognized as a
-                // mutex. Note that multivectors store mutexes explicitly
-                ASSERT_TRUE ( (multivector->find (idx1, idx2) && (str1.find (chr) || str2.find (chr))) ||
-                              (!multivector->find (idx1, idx2) && !str1.find (chr) && !str2.find (chr) ));
+                // mutex
+                ASSERT_TRUE ( (mutextable->find (idx1, idx2) && (str1.find (chr) || str2.find (chr))) ||
+                              (!mutextable->find (idx1, idx2) && !str1.find (chr) && !str2.find (chr) ));
 
                 // Mutexes are reflective, thus verify the opposite as well
-                ASSERT_TRUE ( (multivector->find (idx2, idx1) && (str1.find (chr) || str2.find (chr))) ||
-                              (!multivector->find (idx2, idx1) && !str1.find (chr) && !str2.find (chr) ));
+                ASSERT_TRUE ( (mutextable->find (idx2, idx1) && (str1.find (chr) || str2.find (chr))) ||
+                              (!mutextable->find (idx2, idx1) && !str1.find (chr) && !str2.find (chr) ));
             }
         }
     }
@@ -874,8 +873,8 @@ TEST_F (ManagerFixture, InvokeConstraintTimeManager) {
         }, variable_t{names[variables[0]]}, variable_t{names[variables[1]]});
 
         // before making the important assertion, ensure also that after posting
-        // constraints, the multivector is not null anymore
-        ASSERT_NE (m.get_multivector(), nullptr);
+        // constraints, the table of mutexes is not null anymore
+        ASSERT_NE (m.get_mutextable(), nullptr);
 
         // and that posting additional constraints automatically raises an
         // exception
@@ -926,7 +925,7 @@ TEST_F (ManagerFixture, MutexTimeManager) {
         // have been properly recognized
         const valtable_t<time_t>& valtable = m.get_valtable ();
         const vartable_t& vartable = m.get_vartable ();
-        const unique_ptr<multivector_t>& multivector = m.get_multivector();
+        const shared_ptr<mutextable_t>& mutextable = m.get_mutextable();
 
         // get the index to the first and last value in the domain of each
         // variable
@@ -953,16 +952,79 @@ TEST_F (ManagerFixture, MutexTimeManager) {
                 time_t num2 = valtable[idx2];
 
                 // verify now that all mutexes have been properly stored
-                ASSERT_TRUE ( ( multivector->find (idx1, idx2) && !tfuncs[op] (num1, num2)) ||
-                              (!multivector->find (idx1, idx2) &&  tfuncs[op] (num1, num2)) );
+                ASSERT_TRUE ( ( mutextable->find (idx1, idx2) && !tfuncs[op] (num1, num2)) ||
+                              (!mutextable->find (idx1, idx2) &&  tfuncs[op] (num1, num2)) );
 
-                ASSERT_TRUE ( ( multivector->find (idx2, idx1) && !tfuncs[op] (num1, num2)) ||
-                              (!multivector->find (idx2, idx1) &&  tfuncs[op] (num1, num2)) );
+                ASSERT_TRUE ( ( mutextable->find (idx2, idx1) && !tfuncs[op] (num1, num2)) ||
+                              (!mutextable->find (idx2, idx1) &&  tfuncs[op] (num1, num2)) );
             }
         }
     }
 }
 
+// Checks that freezing a manager removes duplicate mutexes, updates the number
+// of mutexes of every value accordingly and forbids posting new constraints
+// ----------------------------------------------------------------------------
+TEST_F (ManagerFixture, FreezeIntManager) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create an empty table of CSP variables, i.e., with no values at all
+        manager<int> m;
+
+        // randomly pick up information for all variables to insert. The number
+        // of variables to insert is randomly selected and it is guaranteed, at
+        // least two are recorded
+        vector<string> names;
+        vector<vector<value_t<int>>> values;
+        int nbvars = 2 + rand () % NB_VARIABLES;
+        randVarIntVals (nbvars, names, values);
+
+        // and add all these variables to the manager
+        addVariables<int>(m, names, values);
+
+        // randomly choose two different variables and post the same constraint
+        // twice with different orderings so that all mutexes are duplicated
+        auto variables = randVectorInt (2, nbvars, true);
+        auto func = [] (int val1, int val2) {
+            return (val1 + val2) % 3 != 0;
+        };
+        m.add_constraint(func, variable_t{names[variables[0]]}, variable_t{names[variables[1]]});
+        m.add_constraint(func, variable_t{names[variables[1]]}, variable_t{names[variables[0]]});
+        ASSERT_FALSE (m.frozen ());
+
+        // freeze the manager and verify that every value has precisely the
+        // number of mutexes given by the cross product
+        m.freeze ();
+        ASSERT_TRUE (m.frozen ());
+        const valtable_t<int>& valtable = m.get_valtable ();
+        const vartable_t& vartable = m.get_vartable ();
+        const shared_ptr<mutextable_t>& mutextable = m.get_mutextable();
+        for (auto k = 0 ; k < 2 ; k++) {
+            for (auto idx1 = vartable.get_first (variables[k]);
+                 idx1 <= vartable.get_last (variables[k]);
+                 idx1++) {
+
+                // count the number of values of the other variable which are
+                // mutex with this one
+                size_t nbmutexes = 0;
+                for (auto idx2 = vartable.get_first (variables[1-k]);
+                     idx2 <= vartable.get_last (variables[1-k]);
+                     idx2++) {
+                    nbmutexes += !func (valtable[idx1], valtable[idx2]);
+                }
+                ASSERT_EQ (mutextable->degree (idx1), nbmutexes);
+                ASSERT_EQ (valtable.get_nbmutexes (idx1), nbmutexes);
+            }
+        }
+
+        // finally, posting new constraints is not allowed anymore
+        ASSERT_THROW (m.add_constraint(func, variable_t{names[variables[0]]},
+                                       variable_t{names[variables[1]]}),
+                      runtime_error);
+    }
+}
+
 manager<int> mVarNbValues;
 void handler_var_nbvalues (size_t index, size_t val1, size_t val2) {
     mVarNbValues.set_var_nbvalues (index, val1, val2);
@@ -1109,7 +1171,7 @@ TEST_F (ManagerFixture, RestoreValueStatusManager) {
     mStatus.add_constraint([] (int val1, int val2)->bool {
         return val1 < val2;
     }, variable_t{names[variables[0]]}, variable_t{names[variables[1]]});
-    ASSERT_NE (mStatus.get_multivector (), nullptr);
+    ASSERT_NE (mStatus.get_mutextable (), nullptr);
 
     // now, performe the tests
     for (auto j = 0 ; j < NB_TESTS ; j++) {
@@ -1118,7 +1180,7 @@ TEST_F (ManagerFixture, RestoreValueStatusManager) {
         sstack_t stack;
 
         // randomly choose one value to update and the new status
-        size_t value = rand () % mStatus.get_multivector ()->size ();
+        size_t value = rand () % mStatus.get_mutextable ()->size ();
         size_t last = rand () % 2;
 
         // make a backup copy of the current status of the selected value, which
@@ -1180,7 +1242,7 @@ TEST_F (ManagerFixture, RestoreValueNbMutexesManager) {
     mValNbMutexes.add_constraint([] (int val1, int val2)->bool {
         return val1 < val2;
     }, variable_t{names[variables[0]]}, variable_t{names[variables[1]]});
-    ASSERT_NE (mValNbMutexes.get_multivector (), nullptr);
+    ASSERT_NE (mValNbMutexes.get_mutextable (), nullptr);
 
     // now, performe the tests
     for (auto j = 0 ; j < NB_TESTS ; j++) {
@@ -1263,7 +1325,7 @@ TEST_F (ManagerFixture, RestoreFullAssignmentIntManager) {
     // get aliases to the inner data structures of the manager
     const valtable_t<int>& valtable = mFullAssignment.get_valtable ();
     const vartable_t& vartable = mFullAssignment.get_vartable ();
-    const unique_ptr<multivector_t>& multivector = mFullAssignment.get_multivector();
+    const shared_ptr<mutextable_t>& mutextable = mFullAssignment.get_mutextable();
 
     // now, performe the tests
     for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
@@ -1321,11 +1383,10 @@ TEST_F (ManagerFixture, RestoreFullAssignmentIntManager) {
         // mutex with each one that has been disabled
         for (auto j = vartable.get_first (variable); j <= vartable.get_last (variable) ; j++) {
             if (j != last) {
-                for (auto k = 0 ; k < (*multivector)[j].size () ; k++) {
+                mutextable->for_each (j, [&] (size_t validx) {
 
-                    // get the index of the value to modify and its current
-                    // number of enabled mutexes
-                    auto validx = (*multivector)[j][k];
+                    // get the current number of enabled mutexes of the value
+                    // to modify
                     auto nbmutexes = valtable.get_nbmutexes (validx);
 
                     // add another action to the frame to restore the number of
@@ -1336,7 +1397,7 @@ TEST_F (ManagerFixture, RestoreFullAssignmentIntManager) {
                     // decrement the number of mutexes of this specific value
                     mFullAssignment.set_val_nbmutexes (validx, nbmutexes-1, nbmutexes);
                     ASSERT_EQ (valtable.get_nbmutexes (validx), nbmutexes-1);
-                }
+                });
             }
         }
 
@@ -1345,7 +1406,7 @@ TEST_F (ManagerFixture, RestoreFullAssignmentIntManager) {
 
         // disable all values that are mutex with the value randomly selected
         // for this variable
-        for (auto jmutex : (*multivector)[last]) {
+        mutextable->for_each (last, [&] (size_t jmutex) {
 
             // get the current status of this entry
             auto status = valtable.get_status (jmutex);
@@ -1357,7 +1418,7 @@ TEST_F (ManagerFixture, RestoreFullAssignmentIntManager) {
             // disable this value in the valtable
             mFullAssignment.set_val_status (jmutex, false, status);
             ASSERT_FALSE (valtable.get_status (jmutex));
-        }
+        });
 
         // NBVALUES[MUTEX (VALUE)]--
         // --------------------------------------------------------------------
@@ -1365,7 +1426,7 @@ TEST_F (ManagerFixture, RestoreFullAssignmentIntManager) {
         // each mutex with val disabled as a consequence of the assignment
         // var<-val automatically reduces the number of feasibles values of the
         // variable it belongs to
-        for (auto jmutex : (*multivector)[last]) {
+        mutextable->for_each (last, [&] (size_t jmutex) {
 
             // get the variable this value belongs to, and the current number of
             // feasible values in its domain
@@ -1384,7 +1445,7 @@ TEST_F (ManagerFixture, RestoreFullAssignmentIntManager) {
                 mFullAssignment.set_var_nbvalues (jvar, jdomain-1, jdomain);
                 ASSERT_EQ (vartable.get_nbvalues (jvar), jdomain-1);
             }
-        }
+        });
 
         // Push all changes to the stack and restore the previous state
         stack += frame;
@@ -1407,10 +1468,9 @@ TEST_F (ManagerFixture, RestoreFullAssignmentIntManager) {
         // CHECK NBMUTEXES--
         // --------------------------------------------------------------------
         for (auto j = vartable.get_first (variable); j <= vartable.get_last (variable) ; j++) {
-            for (auto k = 0 ; k < (*multivector)[j].size () ; k++) {
-                auto validx = (*multivector)[j][k];
-                ASSERT_EQ (valtable.get_nbmutexes (validx), (*multivector)[validx].size ());
-            }
+            mutextable->for_each (j, [&] (size_t validx) {
+                ASSERT_EQ (valtable.get_nbmutexes (validx), mutextable->degree (validx));
+            });
         }
 
         // CHECK STATUS[DOMAIN\{VALUE}]<-FALSE
@@ -1431,6 +1491,521 @@ TEST_F (ManagerFixture, RestoreFullAssignmentIntManager) {
 }
 
 
+// Check that changes recorded in a trail are undone by the manager
+// ----------------------------------------------------------------------------
+TEST_F (ManagerFixture, UndoTrailManager) {
+
+    // randomly pick up information for all variables to insert
+    vector<string> names;
+    vector<vector<value_t<int>>> values;
+    int nbvars = 2 + rand () % NB_VARIABLES;
+    randVarIntVals (nbvars, names, values);
+
+    // add all these variables to the manager and post a constraint over two
+    // variables randomly selected
+    manager<int> m;
+    addVariables<int>(m, names, values);
+    auto variables = randVectorInt (2, nbvars, true);
+    m.add_constraint([] (int val1, int val2)->bool {
+        return val1 < val2;
+    }, variable_t{names[variables[0]]}, variable_t{names[variables[1]]});
+    m.freeze ();
+    const valtable_t<int>& valtable = m.get_valtable ();
+    const vartable_t& vartable = m.get_vartable ();
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // randomly choose one variable and one value
+        size_t var = rand () % vartable.size ();
+        size_t val = rand () % valtable.size ();
+        size_t nbvalues = vartable.get_nbvalues (var);
+        size_t nbmutexes = valtable.get_nbmutexes (val);
+
+        // modify them recording all changes in a trail
+        trail_t trail;
+        trail.open_frame ();
+        trail.push (opcode_t::VAR_VALUE, var, string::npos);
+        m.set_var_value (var, vartable.get_first (var), string::npos);
+        trail.push (opcode_t::VAR_NBVALUES, var, nbvalues);
+        m.set_var_nbvalues (var, nbvalues-1, nbvalues);
+        trail.push (opcode_t::VAL_STATUS, val, true);
+        m.set_val_status (val, false, true);
+        trail.push (opcode_t::VAL_NBMUTEXES, val, nbmutexes);
+        m.set_val_nbmutexes (val, nbmutexes+1, nbmutexes);
+
+        // and verify that unwinding the trail restores the manager
+        trail.unwind (m);
+        ASSERT_EQ (vartable.get_value (var), string::npos);
+        ASSERT_EQ (vartable.get_nbvalues (var), nbvalues);
+        ASSERT_TRUE (valtable.get_status (val));
+        ASSERT_EQ (valtable.get_nbmutexes (val), nbmutexes);
+    }
+}
+
+// Check that soft constraints are stored in the table of costs and never as
+// mutexes
+// ----------------------------------------------------------------------------
+TEST_F (ManagerFixture, SoftConstraintManager) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // randomly pick up information for all variables to insert
+        vector<string> names;
+        vector<vector<value_t<int>>> values;
+        int nbvars = 2 + rand () % 100;
+        randVarIntVals (nbvars, names, values);
+
+        // add all these variables to the manager and post a soft constraint
+        // over two variables randomly selected
+        manager<int> m;
+        addVariables<int>(m, names, values);
+        auto variables = randVectorInt (2, nbvars, true);
+        m.add_soft_constraint([] (int val1, int val2)->int {
+            return (val1 < val2) ? 0 : 1 + (val1 - val2) % 3;
+        }, variable_t{names[variables[0]]}, variable_t{names[variables[1]]});
+        ASSERT_NE (m.get_costtable (), nullptr);
+        variable_t soft {"soft"};
+        vector<value_t<int>> domain {value_t<int>{0}};
+        ASSERT_THROW (m.add_variable (soft, domain), runtime_error);
+        m.freeze ();
+        ASSERT_TRUE (m.get_costtable ()->frozen ());
+
+        // no mutexes were created, and every pair of values of both variables
+        // has the cost given by the constraint
+        const vartable_t& vartable = m.get_vartable ();
+        const valtable_t<int>& valtable = m.get_valtable ();
+        ASSERT_EQ (m.get_mutextable ()->nbblocks (), 0);
+        for (auto j = vartable.get_first (variables[0]) ; j <= vartable.get_last (variables[0]) ; j++) {
+            ASSERT_EQ (valtable.get_nbmutexes (j), 0);
+            for (auto k = vartable.get_first (variables[1]) ; k <= vartable.get_last (variables[1]) ; k++) {
+                int val1 = valtable[j], val2 = valtable[k];
+                size_t cost = (val1 < val2) ? 0 : 1 + (val1 - val2) % 3;
+                ASSERT_EQ (m.get_costtable ()->get (j, k), cost);
+                ASSERT_EQ (m.get_costtable ()->get (k, j), cost);
+            }
+        }
+
+        // and the cost of a full assignment is the cost of both values
+        vector<size_t> assignment;
+        for (size_t j = 0 ; j < vartable.size () ; j++) {
+            assignment.push_back (vartable.get_first (j));
+        }
+        ASSERT_EQ (m.cost (assignment),
+                   m.get_costtable ()->get (assignment[variables[0]], assignment[variables[1]]));
+    }
+
+    // negative costs are rejected, as soft constraints over the same variable
+    manager<int> m;
+    variable_t x {"X"}, y {"Y"};
+    vector<value_t<int>> domain {value_t<int>{0}, value_t<int>{1}};
+    m.add_variable (x, domain);
+    m.add_variable (y, domain);
+    ASSERT_THROW (m.add_soft_constraint ([] (int val1, int val2)->int {
+        return val1 - val2;
+    }, x, y), invalid_argument);
+    ASSERT_THROW (m.add_soft_constraint ([] (int, int)->int {
+        return 1;
+    }, x, x), invalid_argument);
+
+    // and a constraint with any negative cost does not store any other
+    ASSERT_EQ (m.get_costtable (), nullptr);
+    m.add_soft_constraint ([] (int val1, int val2)->int {
+        return val1 + val2;
+    }, x, y);
+    ASSERT_THROW (m.add_soft_constraint ([] (int val1, int val2)->int {
+        return (val1 && val2) ? -1 : 5;
+    }, x, y), invalid_argument);
+    for (size_t j = 0 ; j < 4 ; j++) {
+        ASSERT_EQ ((*m.get_costtable ())[j].size (), (j % 2) ? 2 : 1);
+    }
+    m.freeze ();
+    ASSERT_EQ (m.get_costtable ()->get (0, 2), 0);
+    ASSERT_EQ (m.get_costtable ()->get (0, 3), 1);
+    ASSERT_EQ (m.get_costtable ()->get (1, 3), 2);
+
+    // functions returning any other type than bool posted with add_constraint
+    // are hard constraints, where only pairs with a null result are mutexes
+    manager<int> hard;
+    hard.add_variable (x, domain);
+    hard.add_variable (y, domain);
+    hard.add_constraint ([] (int val1, int val2)->int {
+        return val1 - val2;
+    }, x, y);
+    ASSERT_EQ (hard.get_costtable (), nullptr);
+    hard.freeze ();
+    ASSERT_EQ (hard.get_mutextable ()->nbblocks (), 1);
+    for (size_t j = 0 ; j < 4 ; j++) {
+        ASSERT_EQ (hard.get_valtable ().get_nbmutexes (j), 1);
+    }
+}
+
+// Check that constraints posted in parallel produce exactly the same mutexes
+// than those posted serially
+// ----------------------------------------------------------------------------
+TEST_F (ManagerFixture, ParallelPostingManager) {
+
+    for (auto i = 0 ; i < NB_TESTS/1000 ; i++) {
+
+        // create two managers with the same variables, whose domains are
+        // large enough to be posted in parallel
+        manager<int> serial, parallel;
+        ASSERT_EQ (serial.get_nbthreads (), 1);
+        ASSERT_THROW (parallel.set_nbthreads (0), invalid_argument);
+        parallel.set_nbthreads (2 + rand () % 7);
+        size_t nbvars = 2 + rand () % 3;
+        for (size_t j = 0 ; j < nbvars ; j++) {
+            variable_t variable {"X" + to_string (j)};
+            vector<value_t<int>> domain;
+            int size = 256 + rand () % 256;
+            for (int k = 0 ; k < size ; k++) {
+                domain.push_back (value_t<int>{k});
+            }
+            serial.add_variable (variable, domain);
+            parallel.add_variable (variable, domain);
+        }
+
+        // post the same random constraints in both managers
+        for (size_t j = 0 ; j < nbvars ; j++) {
+            for (size_t k = j + 1 ; k < nbvars ; k++) {
+                int delta = rand () % 10;
+                int modulo = 2 + rand () % 40;
+                auto func = [delta, modulo] (int val1, int val2) {
+                    return abs (val1 - val2) != delta && (val1 + val2) % modulo;
+                };
+                serial.add_constraint (func, variable_t{"X" + to_string (j)}, variable_t{"X" + to_string (k)});
+                parallel.add_constraint (func, variable_t{"X" + to_string (j)}, variable_t{"X" + to_string (k)});
+            }
+        }
+
+        // before freezing, the number of mutexes of every value is the same
+        const valtable_t<int>& valtable1 = serial.get_valtable ();
+        const valtable_t<int>& valtable2 = parallel.get_valtable ();
+        for (size_t j = 0 ; j < valtable1.size () ; j++) {
+            ASSERT_EQ (valtable1.get_nbmutexes (j), valtable2.get_nbmutexes (j));
+        }
+
+        // and so are all mutexes after freezing both managers
+        serial.freeze ();
+        parallel.freeze ();
+        const mutextable_t& mutextable1 = *serial.get_mutextable ();
+        const mutextable_t& mutextable2 = *parallel.get_mutextable ();
+        ASSERT_EQ (mutextable1.nbblocks (), mutextable2.nbblocks ());
+        for (size_t j = 0 ; j < valtable1.size () ; j++) {
+            ASSERT_EQ (mutextable1.degree (j), mutextable2.degree (j));
+            ASSERT_EQ (valtable1.get_nbmutexes (j), valtable2.get_nbmutexes (j));
+            vector<size_t> mutexes1, mutexes2;
+            mutextable1.for_each (j, [&mutexes1] (size_t k) { mutexes1.push_back (k); });
+            mutextable2.for_each (j, [&mutexes2] (size_t k) { mutexes2.push_back (k); });
+            ASSERT_EQ (mutexes1, mutexes2);
+        }
+    }
+
+    // exceptions raised by the function in any thread are rethrown
+    manager<int> m;
+    m.set_nbthreads (4);
+    variable_t x {"X"}, y {"Y"};
+    vector<value_t<int>> domain;
+    for (int k = 0 ; k < 512 ; k++) {
+        domain.push_back (value_t<int>{k});
+    }
+    m.add_variable (x, domain);
+    m.add_variable (y, domain);
+    ASSERT_THROW (m.add_constraint ([] (int val1, int val2)->bool {
+        if (val1 == 500) {
+            throw domain_error ("wrong value");
+        }
+        return val1 != val2;
+    }, x, y), domain_error);
+}
+
+// Check that constraints posted in bulk produce exactly the same mutexes than
+// those posted one at a time
+// ----------------------------------------------------------------------------
+TEST_F (ManagerFixture, BulkPostingManager) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create three managers with the same variables
+        manager<int> single, bulk, mixed;
+        bulk.set_nbthreads (1 + rand () % 8);
+        mixed.set_nbthreads (1 + rand () % 8);
+        size_t nbvars = 2 + rand () % 20;
+        for (size_t j = 0 ; j < nbvars ; j++) {
+            variable_t variable {"X" + to_string (j)};
+            vector<value_t<int>> domain;
+            int size = 1 + rand () % 30;
+            for (int k = 0 ; k < size ; k++) {
+                domain.push_back (value_t<int>{k});
+            }
+            single.add_variable (variable, domain);
+            bulk.add_variable (variable, domain);
+            mixed.add_variable (variable, domain);
+        }
+
+        // randomly choose pairs of variables, possibly repeated, and post the
+        // same constraint over all of them with all managers, and another
+        // different constraint for every pair in the last one
+        vector<pair<size_t, size_t>> pairs;
+        vector<pair<function<bool(int, int)>, pair<size_t, size_t>>> constraints;
+        for (auto j = 0 ; j < 50 ; j++) {
+            auto vars = randVectorInt (2, nbvars, true);
+            pairs.push_back ({vars[0], vars[1]});
+            int delta = rand () % 5;
+            constraints.push_back ({[delta] (int val1, int val2) {
+                return abs (val1 - val2) != delta;
+            }, {vars[0], vars[1]}});
+        }
+        auto func = [] (int val1, int val2) {
+            return (val1 + val2) % 3 != 0;
+        };
+        for (auto& vars : pairs) {
+            single.add_constraint (func, variable_t{"X" + to_string (vars.first)},
+                                   variable_t{"X" + to_string (vars.second)});
+        }
+        for (auto& constraint : constraints) {
+            single.add_constraint (constraint.first, variable_t{"X" + to_string (constraint.second.first)},
+                                   variable_t{"X" + to_string (constraint.second.second)});
+        }
+        bulk.add_constraints (func, pairs);
+        bulk.add_constraints (constraints);
+        mixed.add_constraints (func, pairs);
+        for (auto& constraint : constraints) {
+            mixed.add_constraint (constraint.first, variable_t{"X" + to_string (constraint.second.first)},
+                                  variable_t{"X" + to_string (constraint.second.second)});
+        }
+
+        // all managers have the same number of mutexes of every value both
+        // before and after freezing them, and the same mutexes
+        for (auto frozen : {false, true}) {
+            if (frozen) {
+                single.freeze ();
+                bulk.freeze ();
+                mixed.freeze ();
+            }
+            for (size_t j = 0 ; j < single.get_valtable ().size () ; j++) {
+                ASSERT_EQ (single.get_valtable ().get_nbmutexes (j), bulk.get_valtable ().get_nbmutexes (j));
+                ASSERT_EQ (single.get_valtable ().get_nbmutexes (j), mixed.get_valtable ().get_nbmutexes (j));
+            }
+        }
+        ASSERT_EQ (single.get_mutextable ()->nbblocks (), bulk.get_mutextable ()->nbblocks ());
+        ASSERT_EQ (single.get_mutextable ()->get_multivector (), bulk.get_mutextable ()->get_multivector ());
+        ASSERT_EQ (single.get_mutextable ()->get_multivector (), mixed.get_mutextable ()->get_multivector ());
+        for (size_t j = 0 ; j < single.get_valtable ().size () ; j++) {
+            vector<size_t> mutexes1, mutexes2;
+            single.get_mutextable ()->for_each (j, [&mutexes1] (size_t k) { mutexes1.push_back (k); });
+            bulk.get_mutextable ()->for_each (j, [&mutexes2] (size_t k) { mutexes2.push_back (k); });
+            ASSERT_EQ (mutexes1, mutexes2);
+        }
+    }
+
+    // wrong pairs of variables are rejected, and so are constraints posted
+    // after freezing the manager
+    manager<int> m;
+    variable_t x {"X"}, y {"Y"};
+    vector<value_t<int>> domain {value_t<int>{0}, value_t<int>{1}};
+    m.add_variable (x, domain);
+    m.add_variable (y, domain);
+    auto func = [] (int val1, int val2) {
+        return val1 != val2;
+    };
+    ASSERT_THROW (m.add_constraints (func, {{0, 2}}), invalid_argument);
+    ASSERT_THROW (m.add_constraints (func, {{1, 1}}), invalid_argument);
+    m.add_constraints (func, {{0, 1}});
+    ASSERT_EQ (m.get_valtable ().get_nbmutexes (0), 1);
+    m.freeze ();
+    ASSERT_THROW (m.add_constraints (func, {{0, 1}}), runtime_error);
+}
+
+// Check that soft constraints posted in bulk produce exactly the same costs
+// than those posted one at a time
+// ----------------------------------------------------------------------------
+TEST_F (ManagerFixture, SoftBulkPostingManager) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create two managers with the same variables
+        manager<int> single, bulk;
+        bulk.set_nbthreads (1 + rand () % 8);
+        size_t nbvars = 2 + rand () % 20;
+        for (size_t j = 0 ; j < nbvars ; j++) {
+            variable_t variable {"X" + to_string (j)};
+            vector<value_t<int>> domain;
+            int size = 1 + rand () % 30;
+            for (int k = 0 ; k < size ; k++) {
+                domain.push_back (value_t<int>{k});
+            }
+            single.add_variable (variable, domain);
+            bulk.add_variable (variable, domain);
+        }
+
+        // randomly choose pairs of variables, possibly repeated, and post the
+        // same soft constraint over all of them and another different one for
+        // every pair
+        vector<pair<size_t, size_t>> pairs;
+        vector<pair<function<int(int, int)>, pair<size_t, size_t>>> constraints;
+        for (auto j = 0 ; j < 50 ; j++) {
+            auto vars = randVectorInt (2, nbvars, true);
+            pairs.push_back ({vars[0], vars[1]});
+            int delta = 1 + rand () % 5;
+            constraints.push_back ({[delta] (int val1, int val2) {
+                return (val1 + val2) % delta;
+            }, {vars[0], vars[1]}});
+        }
+        auto func = [] (int val1, int val2) {
+            return (val1 < val2) ? 0 : 1 + (val1 - val2) % 3;
+        };
+        for (auto& vars : pairs) {
+            single.add_soft_constraint (func, variable_t{"X" + to_string (vars.first)},
+                                        variable_t{"X" + to_string (vars.second)});
+        }
+        for (auto& constraint : constraints) {
+            single.add_soft_constraint (constraint.first, variable_t{"X" + to_string (constraint.second.first)},
+                                        variable_t{"X" + to_string (constraint.second.second)});
+        }
+        bulk.add_soft_constraints (func, pairs);
+        bulk.add_soft_constraints (constraints);
+
+        // both managers have the same entries of every value before freezing
+        // them, and the same costs after it, and no mutexes at all
+        for (size_t j = 0 ; j < single.get_valtable ().size () ; j++) {
+            ASSERT_EQ ((*single.get_costtable ())[j].size (), (*bulk.get_costtable ())[j].size ());
+        }
+        single.freeze ();
+        bulk.freeze ();
+        ASSERT_EQ (bulk.get_mutextable ()->nbblocks (), 0);
+        for (size_t j = 0 ; j < single.get_valtable ().size () ; j++) {
+            for (size_t k = 0 ; k < single.get_valtable ().size () ; k++) {
+                ASSERT_EQ (single.get_costtable ()->get (j, k), bulk.get_costtable ()->get (j, k));
+            }
+        }
+    }
+
+    // wrong pairs of variables are rejected, and so are constraints posted
+    // after freezing the manager
+    manager<int> m;
+    variable_t x {"X"}, y {"Y"};
+    vector<value_t<int>> domain {value_t<int>{0}, value_t<int>{1}};
+    m.add_variable (x, domain);
+    m.add_variable (y, domain);
+    auto func = [] (int val1, int val2) {
+        return val1 + val2;
+    };
+    ASSERT_THROW (m.add_soft_constraints (func, {{0, 2}}), invalid_argument);
+    ASSERT_THROW (m.add_soft_constraints (func, {{1, 1}}), invalid_argument);
+
+    // and no cost is stored if any is negative
+    m.set_nbthreads (2);
+    vector<pair<function<int(int, int)>, pair<size_t, size_t>>> constraints;
+    constraints.push_back ({func, {0, 1}});
+    constraints.push_back ({[] (int val1, int val2) { return val1 - val2; }, {0, 1}});
+    ASSERT_THROW (m.add_soft_constraints (constraints), invalid_argument);
+    ASSERT_EQ (m.get_costtable (), nullptr);
+    m.add_soft_constraints (func, {{0, 1}});
+    ASSERT_EQ (m.get_costtable ()->get (0, 3), 1);
+    m.freeze ();
+    ASSERT_THROW (m.add_soft_constraints (func, {{0, 1}}), runtime_error);
+}
+
+// Check that constraints evaluated in batches produce exactly the same mutexes
+// than those evaluated one pair of values at a time, and that domains are
+// correctly exported
+// ----------------------------------------------------------------------------
+TEST_F (ManagerFixture, BatchPostingManager) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create two managers with the same variables whose domains are
+        // randomly shuffled
+        manager<int> scalar, batch;
+        batch.set_nbthreads (1 + rand () % 4);
+        size_t nbvars = 2 + rand () % 10;
+        for (size_t j = 0 ; j < nbvars ; j++) {
+            variable_t variable {"X" + to_string (j)};
+            vector<value_t<int>> domain;
+            vector<int> values = randVectorInt (1 + rand () % 150, 200, true);
+            for (auto value : values) {
+                domain.push_back (value_t<int>{value - 100});
+            }
+            scalar.add_variable (variable, domain);
+            batch.add_variable (variable, domain);
+
+            // the domain is exported in the same order
+            ASSERT_EQ (batch.get_domain (j).size (), values.size ());
+            for (size_t k = 0 ; k < values.size () ; k++) {
+                ASSERT_EQ (batch.get_domain (j)[k], values[k] - 100);
+            }
+        }
+        ASSERT_THROW (batch.get_domain (nbvars), out_of_range);
+
+        // post the same random constraints with built-in predicates in the
+        // second manager, either one at a time or in bulk
+        vector<pair<size_t, size_t>> pairs;
+        for (size_t j = 0 ; j < nbvars ; j++) {
+            for (size_t k = j + 1 ; k < nbvars ; k++) {
+                int c = rand () % 50;
+                variable_t var1 {"X" + to_string (j)}, var2 {"X" + to_string (k)};
+                switch (rand () % 3) {
+                case 0:
+                    scalar.add_constraint ([] (int val1, int val2) {
+                        return val1 != val2;
+                    }, var1, var2);
+                    batch.add_constraint (predicate_neq_t<int> (), var1, var2);
+                    break;
+                case 1:
+                    scalar.add_constraint ([c] (int val1, int val2) {
+                        return abs (val1 - val2) != c;
+                    }, var1, var2);
+                    batch.add_constraint (predicate_absdiff_neq_t<int> (c), var1, var2);
+                    break;
+                default:
+                    scalar.add_constraint ([c] (int val1, int val2) {
+                        return val1 + val2 <= c;
+                    }, var1, var2);
+                    batch.add_constraint (predicate_sum_leq_t<int> (c), var1, var2);
+                }
+                scalar.add_constraint ([] (int val1, int val2) {
+                    return (val1 - val2) % 7 != 0;
+                }, var1, var2);
+                pairs.push_back ({j, k});
+            }
+        }
+
+        // batch handlers written by users are supported as well
+        batch.add_constraints ([] (int val1, const int* values, size_t n, uint64_t* mask) {
+            for (size_t j = 0 ; j < n ; j++) {
+                if ((val1 - values[j]) % 7 != 0) {
+                    mask[j/64] |= uint64_t (1) << (j%64);
+                } else {
+                    mask[j/64] &= ~(uint64_t (1) << (j%64));
+                }
+            }
+        }, pairs);
+
+        // both managers have precisely the same mutexes
+        for (auto frozen : {false, true}) {
+            if (frozen) {
+                scalar.freeze ();
+                batch.freeze ();
+            }
+            for (size_t j = 0 ; j < scalar.get_valtable ().size () ; j++) {
+                ASSERT_EQ (scalar.get_valtable ().get_nbmutexes (j), batch.get_valtable ().get_nbmutexes (j));
+            }
+        }
+        ASSERT_EQ (scalar.get_mutextable ()->get_multivector (), batch.get_mutextable ()->get_multivector ());
+        for (size_t j = 0 ; j < scalar.get_valtable ().size () ; j++) {
+            vector<size_t> mutexes1, mutexes2;
+            scalar.get_mutextable ()->for_each (j, [&mutexes1] (size_t k) { mutexes1.push_back (k); });
+            batch.get_mutextable ()->for_each (j, [&mutexes2] (size_t k) { mutexes2.push_back (k); });
+
+            // blocks might be created in a different order, and so their
+            // mutexes are traversed
+            sort (mutexes1.begin (), mutexes1.end ());
+            sort (mutexes2.begin (), mutexes2.end ());
+            ASSERT_EQ (mutexes1, mutexes2);
+        }
+    }
+}
+
 // Local Variables:
 // mode:cpp
 // fill-column:80
@@ -0,0 +1,172 @@
+// -*- coding: utf-8 -*-
+// TSTnogoodstore_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <sáb 21-08-2021 11:04:10.728415903 (1629536650)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests for testing MUX stores of nogoods
+
+#include<algorithm>
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+#include "../TSThelpers.h"
+#include "../fixtures/TSTnogoodstorefixture.h"
+
+// Checks that nogoods are correctly added to the store and watched
+// ----------------------------------------------------------------------------
+TEST_F (NogoodstoreFixture, AddNogoodstore) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create an empty store and verify that neither empty nogoods nor
+        // literals out of bounds can be added
+        nogoodstore_t store (NB_VALUES);
+        ASSERT_EQ (store.size (), 0);
+        ASSERT_EQ (store.nbliterals (), 0);
+        ASSERT_THROW (store.add (std::vector<size_t>()), std::invalid_argument);
+        ASSERT_THROW (store.add (std::vector<size_t>{NB_VALUES}), std::out_of_range);
+
+        // add random nogoods and verify their contents
+        std::vector<std::vector<size_t>> nogoods;
+        size_t nbliterals = 0;
+        for (auto j = 0 ; j < 1 + rand () % 100 ; j++) {
+            nogoods.push_back (randNogood (NB_VALUES, 10));
+            ASSERT_EQ (store.add (nogoods.back ()), size_t (j));
+            nbliterals += nogoods.back ().size ();
+        }
+        ASSERT_EQ (store.size (), nogoods.size ());
+        ASSERT_EQ (store.nbliterals (), nbliterals);
+        for (size_t j = 0 ; j < nogoods.size () ; j++) {
+            ASSERT_EQ (std::vector<size_t> (store[j].begin (), store[j].end ()), nogoods[j]);
+
+            // the first two literals watch the nogood
+            for (size_t l = 0 ; l < std::min (size_t (2), nogoods[j].size ()) ; l++) {
+                const std::vector<uint32_t>& watches = store.get_watches (nogoods[j][l]);
+                ASSERT_NE (std::find (watches.begin (), watches.end (), j), watches.end ());
+            }
+        }
+    }
+}
+
+// Checks that propagating true literals reports exactly the nogoods which
+// become unit or violated
+// ----------------------------------------------------------------------------
+TEST_F (NogoodstoreFixture, PropagateNogoodstore) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create a store with random nogoods
+        nogoodstore_t store (NB_VALUES);
+        for (auto j = 0 ; j < 1 + rand () % 100 ; j++) {
+            store.add (randNogood (NB_VALUES, 6));
+        }
+
+        // make literals true one at a time in random order
+        std::vector<size_t> literals;
+        for (size_t j = 0 ; j < NB_VALUES ; j++) {
+            literals.push_back (j);
+        }
+        std::shuffle (literals.begin (), literals.end (), std::mt19937 (rand ()));
+        std::vector<bool> istrue (NB_VALUES, false);
+        for (auto literal : literals) {
+            istrue[literal] = true;
+
+            // every nogood reported has to contain the literal and has either
+            // a single literal which is not true, or none
+            std::vector<bool> reported (store.size (), false);
+            ASSERT_TRUE (store.propagate (literal,
+                                          [&] (size_t j) { return bool (istrue[j]); },
+                                          [&] (size_t j, size_t l) {
+                                              reported[j] = true;
+                                              if (l == std::string::npos) {
+                                                  return nbfalse (store[j], istrue) == 0;
+                                              }
+                                              return nbfalse (store[j], istrue) == 1 && !istrue[l];
+                                          }));
+
+            // and all nogoods containing the literal with at most one literal
+            // which is not true have to be reported
+            for (size_t j = 0 ; j < store.size () ; j++) {
+                multivector_t::row_t nogood = store[j];
+                if (std::find (nogood.begin (), nogood.end (), literal) != nogood.end () &&
+                    nbfalse (nogood, istrue) <= 1) {
+                    ASSERT_TRUE (reported[j]);
+                }
+
+                // the watched literals are not true unless the nogood is unit
+                // or violated
+                if (nbfalse (nogood, istrue) >= 2) {
+                    ASSERT_FALSE (istrue[nogood[0]]);
+                    ASSERT_FALSE (istrue[nogood[1]]);
+                }
+            }
+        }
+    }
+}
+
+// Checks that reducing a store keeps the locked nogoods and those with the
+// highest activity
+// ----------------------------------------------------------------------------
+TEST_F (NogoodstoreFixture, ReduceNogoodstore) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create a store with random nogoods and bump them randomly
+        nogoodstore_t store (NB_VALUES);
+        std::vector<std::vector<size_t>> nogoods;
+        for (auto j = 0 ; j < 1 + rand () % 100 ; j++) {
+            nogoods.push_back (randNogood (NB_VALUES, 10));
+            store.add (nogoods.back ());
+            store.decay ();
+        }
+        for (auto j = 0 ; j < rand () % 1000 ; j++) {
+            store.bump (rand () % store.size ());
+        }
+        std::vector<double> activity;
+        std::vector<bool> locked;
+        for (size_t j = 0 ; j < store.size () ; j++) {
+            activity.push_back (store.get_activity (j));
+            locked.push_back (rand () % 4 == 0);
+        }
+
+        // reduce it and verify that all nogoods kept are remapped correctly
+        size_t target = rand () % (1 + store.size ());
+        std::vector<size_t> remap = store.reduce (target, [&] (size_t j) { return bool (locked[j]); });
+        ASSERT_EQ (remap.size (), nogoods.size ());
+        size_t nbliterals = 0, nblocked = 0;
+        double kept = std::numeric_limits<double>::max ();
+        double removed = 0.0;
+        for (size_t j = 0 ; j < nogoods.size () ; j++) {
+            nblocked += locked[j];
+            if (remap[j] == std::string::npos) {
+                ASSERT_FALSE (locked[j]);
+                removed = std::max (removed, activity[j]);
+                continue;
+            }
+            if (!locked[j]) {
+                kept = std::min (kept, activity[j]);
+            }
+            ASSERT_EQ (std::vector<size_t> (store[remap[j]].begin (), store[remap[j]].end ()), nogoods[j]);
+            ASSERT_EQ (store.get_activity (remap[j]), activity[j]);
+            nbliterals += nogoods[j].size ();
+            for (size_t l = 0 ; l < std::min (size_t (2), nogoods[j].size ()) ; l++) {
+                const std::vector<uint32_t>& watches = store.get_watches (nogoods[j][l]);
+                ASSERT_NE (std::find (watches.begin (), watches.end (), remap[j]), watches.end ());
+            }
+        }
+        ASSERT_EQ (store.size (), std::max (target, nblocked));
+        ASSERT_EQ (store.nbliterals (), nbliterals);
+        ASSERT_LE (removed, kept);
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
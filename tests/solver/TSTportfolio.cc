@@ -0,0 +1,153 @@
+// -*- coding: utf-8 -*-
+// TSTportfolio.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 23-08-2021 10:13:55.602441893 (1629706435)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests of CSPMUX portfolios
+
+#include "../TSThelpers.h"
+#include "../fixtures/TSTportfoliofixture.h"
+
+// Checks that portfolios without configurations can not be solved
+// ----------------------------------------------------------------------------
+TEST_F (PortfolioFixture, EmptyPortfolio) {
+
+    manager<int> m;
+    portfolio<int> p (m);
+    ASSERT_EQ (p.size (), 0);
+    ASSERT_EQ (p.get_status (), status_t::UNKNOWN);
+    ASSERT_EQ (p.get_winner (), string::npos);
+    ASSERT_THROW (p.solve (), runtime_error);
+}
+
+// Checks that copies of a frozen manager share its table of mutexes and can be
+// modified independently
+// ----------------------------------------------------------------------------
+TEST_F (PortfolioFixture, CopyManagerPortfolio) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // copies of a manager which is not frozen copy its table of mutexes
+        manager<int> m;
+        randCSP (m, 2 + rand () % 8, 6, 2 + rand () % 4);
+        manager<int> copy1 (m);
+        ASSERT_NE (copy1.get_mutextable (), m.get_mutextable ());
+
+        // while copies of frozen managers share it
+        m.freeze ();
+        manager<int> copy2 (m);
+        ASSERT_EQ (copy2.get_mutextable (), m.get_mutextable ());
+        ASSERT_EQ (copy2.get_vartable (), m.get_vartable ());
+        ASSERT_EQ (copy2.get_valtable (), m.get_valtable ());
+
+        // searching over the copy does not modify the original manager
+        backtracking<int> search (copy2);
+        search.set_propagation (propagation_t::FORWARD_CHECKING);
+        search.set_node_limit (1 + rand () % 10);
+        search.solve ();
+        checkRestored (m);
+        checkRestored (copy2);
+    }
+}
+
+// Checks that portfolios decide correctly the satisfiability of random CSP
+// tasks
+// ----------------------------------------------------------------------------
+TEST_F (PortfolioFixture, RandomPortfolio) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a random CSP task small enough to be solved by brute force
+        manager<int> m;
+        m.set_density (rand () % 2 ? 0.0 : 1.1);
+        randCSP (m, 2 + rand () % 5, 4, 2 + rand () % 4);
+        m.freeze ();
+        bool expected = bruteForce (m);
+
+        // and solve it with a portfolio of random size
+        portfolio<int> p (m);
+        p.populate (1 + rand () % 8);
+        status_t status = p.solve ();
+        ASSERT_EQ (status == status_t::SATISFIABLE, expected);
+        ASSERT_EQ (status, p.get_status ());
+        ASSERT_LT (p.get_winner (), p.size ());
+        if (expected) {
+            ASSERT_TRUE (isSolution (m, p.get_solution ()));
+        }
+        checkRestored (m);
+    }
+}
+
+// Checks that all searches are interrupted once one of them solves the task
+// ----------------------------------------------------------------------------
+TEST_F (PortfolioFixture, InterruptPortfolio) {
+
+    // create a task with 13 pigeons and 12 holes where the first pigeon can
+    // also be placed in an additional hole, which is forced by a last variable
+    // with a single value. Plain backtracking with the lexicographic ordering
+    // tries to place all pigeons in 12 holes before, which takes very long,
+    // whereas forward checking with dom/wdeg selects the last variable first
+    // and solves it immediately
+    manager<int> m;
+    for (int i = 0 ; i < 13 ; i++) {
+        variable_t variable {"P" + to_string (i)};
+        vector<value_t<int>> domain;
+        for (int j = 0 ; j < (i ? 12 : 13) ; j++) {
+            domain.push_back (value_t<int>{j});
+        }
+        m.add_variable (variable, domain);
+    }
+    variable_t last {"Z"};
+    vector<value_t<int>> domain {value_t<int>{0}};
+    m.add_variable (last, domain);
+    for (int i = 0 ; i < 13 ; i++) {
+        for (int j = i + 1 ; j < 13 ; j++) {
+            m.add_constraint ([] (int hole1, int hole2) {
+                return hole1 != hole2;
+            }, variable_t{"P" + to_string (i)}, variable_t{"P" + to_string (j)});
+        }
+    }
+    m.add_constraint ([] (int hole, int value) {
+        return hole == 12;
+    }, variable_t{"P0"}, last);
+
+    // the first configuration solves it and interrupts the second one
+    portfolio<int> p (m);
+    p.add<varorder_domwdeg_t, valorder_lex_t> (propagation_t::FORWARD_CHECKING);
+    p.add<varorder_lex_t, valorder_lex_t> (propagation_t::BACKTRACKING);
+    p.set_time_limit (60.0);
+    ASSERT_EQ (p.solve (), status_t::SATISFIABLE);
+    ASSERT_EQ (p.get_winner (), 0);
+    ASSERT_TRUE (isSolution (m, p.get_solution ()));
+    ASSERT_LT (p.get_elapsed (), 30.0);
+    checkRestored (m);
+}
+
+// Checks that exceptions raised by any configuration are rethrown once all of
+// them have been stopped
+// ----------------------------------------------------------------------------
+TEST_F (PortfolioFixture, ExceptionPortfolio) {
+
+    // the first configuration would take very long to solve the task, but it
+    // is stopped as soon as the second one raises an exception
+    manager<int> m;
+    pigeons (m, 13, 12);
+    portfolio<int> p (m);
+    p.add<varorder_lex_t, valorder_lex_t> (propagation_t::BACKTRACKING);
+    p.add<varorder_throw_t, valorder_lex_t> (propagation_t::BACKTRACKING);
+    p.set_time_limit (60.0);
+    auto start = chrono::steady_clock::now ();
+    ASSERT_THROW (p.solve (), runtime_error);
+    ASSERT_LT (chrono::duration<double> (chrono::steady_clock::now () - start).count (), 30.0);
+    checkRestored (m);
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,127 @@
+// -*- coding: utf-8 -*-
+// TSTpredicates.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 31-08-2021 11:15:40.208416372 (1630401340)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests of CSPMUX built-in predicates
+
+#include "../TSThelpers.h"
+#include "../fixtures/TSTpredicatesfixture.h"
+
+// Checks that built-in predicates over pairs of values are correctly computed
+// ----------------------------------------------------------------------------
+TEST_F (PredicatesFixture, ScalarPredicates) {
+
+    for (auto i = 0 ; i < NB_TESTS ; i++) {
+
+        int value1 = rand () % NB_VALUES - NB_VALUES/2;
+        int value2 = rand () % NB_VALUES - NB_VALUES/2;
+        int k = rand () % NB_VALUES;
+        ASSERT_EQ (predicate_neq_t<int> () (value1, value2), value1 != value2);
+        ASSERT_EQ (predicate_absdiff_neq_t<int> (k) (value1, value2), abs (value1 - value2) != k);
+        ASSERT_EQ (predicate_sum_leq_t<int> (k) (value1, value2), value1 + value2 <= k);
+
+        // absolute differences are also correctly computed for unsigned types
+        unsigned int uvalue1 = rand () % NB_VALUES, uvalue2 = rand () % NB_VALUES;
+        ASSERT_EQ (predicate_absdiff_neq_t<unsigned int> (k) (uvalue1, uvalue2),
+                   abs (int (uvalue1) - int (uvalue2)) != k);
+    }
+}
+
+// Checks that batch evaluations of built-in predicates agree with their
+// evaluation over every pair of values for different arithmetic types and any
+// number of values
+// ----------------------------------------------------------------------------
+TEST_F (PredicatesFixture, BatchPredicates) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create random values with repetitions in a random number of values,
+        // which are not necessarily a multiple of the size of words or SIMD
+        // registers
+        size_t n = rand () % 300;
+        int k = rand () % 20;
+        std::vector<int32_t> ints;
+        std::vector<int64_t> longs;
+        std::vector<unsigned int> uints;
+        std::vector<double> doubles;
+        for (size_t j = 0 ; j < n ; j++) {
+            ints.push_back (rand () % 40 - 20);
+            longs.push_back (rand () % 40 - 20);
+            uints.push_back (rand () % 40);
+            doubles.push_back ((rand () % 80 - 40)/2.0);
+        }
+
+        // and verify all predicates
+        int32_t value = rand () % 40 - 20;
+        checkBatch (predicate_neq_t<int32_t> (), value, ints);
+        checkBatch (predicate_absdiff_neq_t<int32_t> (k), value, ints);
+        checkBatch (predicate_sum_leq_t<int32_t> (k), value, ints);
+        checkBatch (predicate_neq_t<int64_t> (), int64_t (value), longs);
+        checkBatch (predicate_absdiff_neq_t<int64_t> (k), int64_t (value), longs);
+        checkBatch (predicate_sum_leq_t<int64_t> (k), int64_t (value), longs);
+        checkBatch (predicate_neq_t<unsigned int> (), (unsigned int) (value + 20), uints);
+        checkBatch (predicate_absdiff_neq_t<unsigned int> (k), (unsigned int) (value + 20), uints);
+        checkBatch (predicate_sum_leq_t<unsigned int> (k), (unsigned int) (value + 20), uints);
+        checkBatch (predicate_neq_t<double> (), value/2.0, doubles);
+        checkBatch (predicate_absdiff_neq_t<double> (k/2.0), value/2.0, doubles);
+        checkBatch (predicate_sum_leq_t<double> (k/2.0), value/2.0, doubles);
+    }
+}
+
+// Checks that built-in predicates are exact over the whole range of integers,
+// both over pairs of values and in batches, where their differences and sums
+// do not fit in the type of the values
+// ----------------------------------------------------------------------------
+TEST_F (PredicatesFixture, OverflowPredicates) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create random values close to the bounds of 32-bit integers, and
+        // random differences and sums which may not be 32-bit integers either
+        const int32_t min32 = std::numeric_limits<int32_t>::min ();
+        const int32_t max32 = std::numeric_limits<int32_t>::max ();
+        size_t n = rand () % 300;
+        std::vector<int32_t> ints;
+        for (size_t j = 0 ; j < n ; j++) {
+            ints.push_back ((rand () % 2) ? min32 + rand () % 20 : max32 - rand () % 20);
+        }
+        int32_t value = (rand () % 2) ? min32 + rand () % 20 : max32 - rand () % 20;
+        int32_t k = (rand () % 2) ? max32 - rand () % 40 : rand () % 20 - 10;
+        int32_t c = (rand () % 2) ? min32 + rand () % 40 : max32 - rand () % 40;
+
+        // verify both predicates over pairs of values with 64-bit integers
+        for (auto value2 : ints) {
+            ASSERT_EQ (predicate_absdiff_neq_t<int32_t> (k) (value, value2),
+                       std::llabs (int64_t (value) - int64_t (value2)) != k);
+            ASSERT_EQ (predicate_sum_leq_t<int32_t> (c) (value, value2),
+                       int64_t (value) + int64_t (value2) <= c);
+        }
+
+        // and in batches, including the vector test if available
+        checkBatch (predicate_absdiff_neq_t<int32_t> (k), value, ints);
+        checkBatch (predicate_sum_leq_t<int32_t> (c), value, ints);
+    }
+
+    // differences and sums of 64-bit integers are computed without overflows
+    // as well, both signed and unsigned
+    const int64_t min64 = std::numeric_limits<int64_t>::min ();
+    const int64_t max64 = std::numeric_limits<int64_t>::max ();
+    const uint64_t umax64 = std::numeric_limits<uint64_t>::max ();
+    ASSERT_TRUE (predicate_absdiff_neq_t<int64_t> (1) (min64, max64));
+    ASSERT_FALSE (predicate_absdiff_neq_t<int64_t> (max64) (-1, max64 - 1));
+    ASSERT_FALSE (predicate_sum_leq_t<int64_t> (0) (max64, max64));
+    ASSERT_TRUE (predicate_sum_leq_t<int64_t> (0) (min64, min64));
+    ASSERT_FALSE (predicate_sum_leq_t<uint64_t> (10) (umax64, 20));
+    ASSERT_FALSE (predicate_absdiff_neq_t<uint64_t> (umax64) (0, umax64));
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -147,6 +147,83 @@ TEST_F (SstackFixture, UnwindSstack) {
 }
 
 
+// Checks that actions can be added straight to open frames
+// ----------------------------------------------------------------------------
+TEST_F (SstackFixture, OpenCloseSstack) {
+
+    for (auto i = 0 ; i < NB_TESTS ; i++) {
+
+        // first, create an empty stack. Actions can not be added without an
+        // open frame, and no frame can be closed
+        sstack_t stack;
+        ASSERT_THROW (stack += action_t ([] (size_t index, size_t val1, size_t val2) {}, 0, 0, 0),
+                      runtime_error);
+        ASSERT_THROW (stack.close_frame (), runtime_error);
+
+        // open a frame and add a random number of actions to it, each for
+        // adding two numbers
+        frame_t& frame = stack.open_frame ();
+        ASSERT_EQ (stack.size (), 1);
+        ASSERT_THROW (stack.open_frame (), runtime_error);
+        int nbactions = 1+rand () % NB_VALUES;
+        vector<int> ints = randVectorInt (2*nbactions, NB_VALUES);
+        for (auto j = 0 ; j < nbactions ; j++) {
+            stack += action_t {[] (size_t index, size_t val1, size_t val2) {
+                sum += (val1 + val2);
+            }, 0, size_t(ints[j*2]), size_t(ints[1+j*2])};
+        }
+        ASSERT_EQ (frame.size (), nbactions);
+
+        // close it, and verify no more actions can be added
+        stack.close_frame ();
+        ASSERT_THROW (stack += action_t ([] (size_t index, size_t val1, size_t val2) {}, 0, 0, 0),
+                      runtime_error);
+
+        // unwind it and verify the result is the expected one
+        sum = 0;
+        stack.unwind ();
+        ASSERT_EQ (stack.size (), 0);
+        ASSERT_EQ (sum, accumulate(ints.begin(), ints.end(), 0));
+    }
+}
+
+// Checks that frames unwound are reused
+// ----------------------------------------------------------------------------
+TEST_F (SstackFixture, ReuseSstack) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create an empty stack and push a random number of frames
+        sstack_t stack;
+        int nbframes = 1 + rand () % NB_VALUES;
+        for (auto j = 0 ; j < nbframes ; j++) {
+            stack.open_frame ();
+            stack += action_t {[] (size_t index, size_t val1, size_t val2) {}, 0, 0, 0};
+            stack.close_frame ();
+        }
+        ASSERT_EQ (stack.capacity (), nbframes);
+
+        // repeatedly unwind and push again a random number of frames, both
+        // directly and copying them. The capacity never grows
+        for (auto j = 0 ; j < NB_VALUES ; j++) {
+            int nbunwind = rand () % (1 + stack.size ());
+            for (auto k = 0 ; k < nbunwind ; k++) {
+                stack.unwind ();
+            }
+            while (stack.size () < nbframes) {
+                if (rand () % 2) {
+                    frame_t& frame = stack.open_frame ();
+                    ASSERT_EQ (frame.size (), 0);
+                    stack.close_frame ();
+                } else {
+                    stack += frame_t ();
+                }
+            }
+            ASSERT_EQ (stack.capacity (), nbframes);
+        }
+    }
+}
+
 // Local Variables:
 // mode:cpp
 // fill-column:80
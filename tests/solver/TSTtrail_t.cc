@@ -0,0 +1,91 @@
+// -*- coding: utf-8 -*-
+// TSTtrail_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <mié 18-08-2021 11:36:22.775406138 (1629279382)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests for testing MUX trails
+
+#include<vector>
+
+#include "../TSThelpers.h"
+#include "../fixtures/TSTtrailfixture.h"
+
+// Checks that unwinding an empty trail raises an exception
+// ----------------------------------------------------------------------------
+TEST_F (TrailFixture, EmptyTrail) {
+
+    trail_t trail;
+    undotable_t table (1);
+    ASSERT_EQ (trail.size (), 0);
+    ASSERT_EQ (trail.nbrecords (), 0);
+    ASSERT_THROW (trail.unwind (table), runtime_error);
+}
+
+// Checks that indices which do not fit in 32 bits are rejected
+// ----------------------------------------------------------------------------
+TEST_F (TrailFixture, OverflowTrail) {
+
+    trail_t trail;
+    trail.open_frame ();
+    ASSERT_THROW (trail.push (opcode_t::VAL_STATUS, size_t (1) << 32, 0), overflow_error);
+    ASSERT_EQ (trail.nbrecords (), 0);
+    trail.push (opcode_t::VAL_STATUS, numeric_limits<uint32_t>::max (), 0);
+    ASSERT_EQ (trail.nbrecords (), 1);
+}
+
+// Checks that frames are undone in reverse order restoring all previous values
+// ----------------------------------------------------------------------------
+TEST_F (TrailFixture, UnwindTrail) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create an empty trail and a table of values
+        trail_t trail;
+        undotable_t table (NB_VALUES);
+
+        // keep a copy of the table before opening every frame
+        std::vector<undotable_t> backups;
+        size_t nbrecords = 0;
+        int nbframes = 1 + rand () % NB_VALUES;
+        for (auto j = 0 ; j < nbframes ; j++) {
+
+            // open a new frame and randomly modify the table, recording every
+            // change. Note the same entry can be modified several times
+            backups.push_back (table);
+            trail.open_frame ();
+            int nbchanges = rand () % NB_VALUES;
+            for (auto k = 0 ; k < nbchanges ; k++) {
+                opcode_t opcode = opcode_t (rand () % 4);
+                size_t index = rand () % NB_VALUES;
+                trail.push (opcode, index, table.get (opcode, index));
+                table.set (opcode, index, rand ());
+            }
+            nbrecords += nbchanges;
+            ASSERT_EQ (trail.size (), 1 + j);
+            ASSERT_EQ (trail.nbrecords (), nbrecords);
+        }
+
+        // and now unwind all frames verifying the table is restored
+        for (auto j = nbframes - 1 ; j >= 0 ; j--) {
+            trail.unwind (table);
+            ASSERT_EQ (trail.size (), j);
+            for (auto k = 0 ; k < 4 ; k++) {
+                for (auto index = 0 ; index < NB_VALUES ; index++) {
+                    ASSERT_EQ (table.get (opcode_t (k), index),
+                               backups[j].get (opcode_t (k), index));
+                }
+            }
+        }
+        ASSERT_EQ (trail.nbrecords (), 0);
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
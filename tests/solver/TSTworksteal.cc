@@ -0,0 +1,152 @@
+// -*- coding: utf-8 -*-
+// TSTworksteal.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 24-08-2021 12:49:40.118736520 (1629802180)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests of CSPMUX parallel searches with work stealing
+
+#include "../TSThelpers.h"
+#include "../fixtures/TSTworkstealfixture.h"
+
+// Checks that parallel searches are correctly created and that tasks without
+// variables have exactly one solution
+// ----------------------------------------------------------------------------
+TEST_F (WorkstealFixture, EmptyWorksteal) {
+
+    manager<int> m;
+    worksteal<int> search (m);
+    ASSERT_GE (search.get_nbworkers (), 1);
+    ASSERT_EQ (search.get_status (), status_t::UNKNOWN);
+    ASSERT_THROW (search.set_nbworkers (0), invalid_argument);
+    search.set_nbworkers (4);
+    ASSERT_EQ (search.count (), status_t::SATISFIABLE);
+    ASSERT_EQ (search.get_nbsolutions (), 1);
+    ASSERT_EQ (search.solve (), status_t::SATISFIABLE);
+    ASSERT_TRUE (search.get_solution ().empty ());
+}
+
+// Checks that the number of solutions of the n-queens problem is correctly
+// computed with any number of workers and propagation
+// ----------------------------------------------------------------------------
+TEST_F (WorkstealFixture, QueensWorksteal) {
+
+    // number of solutions of the n-queens problem with n in [1, 8]
+    vector<size_t> expected {1, 0, 0, 2, 10, 4, 40, 92};
+    for (size_t n = 1 ; n <= expected.size () ; n++) {
+        manager<int> m;
+        queens (m, n);
+        for (auto propagation : {propagation_t::BACKTRACKING,
+                                 propagation_t::FORWARD_CHECKING,
+                                 propagation_t::MAINTAINING_ARC_CONSISTENCY}) {
+            worksteal<int, varorder_domwdeg_t> search (m);
+            search.set_nbworkers (1 + rand () % 8);
+            search.set_propagation (propagation);
+            ASSERT_EQ (search.count (), expected[n-1] ? status_t::SATISFIABLE : status_t::UNSATISFIABLE);
+            ASSERT_EQ (search.get_nbsolutions (), expected[n-1]);
+            ASSERT_TRUE (search.get_solution ().empty ());
+            checkRestored (m);
+        }
+    }
+}
+
+// Checks that parallel searches find a solution of random CSP tasks if and
+// only if there is one, and that they count all of them
+// ----------------------------------------------------------------------------
+TEST_F (WorkstealFixture, RandomWorksteal) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a random CSP task small enough to be solved by brute force
+        manager<int> m;
+        m.set_density (rand () % 2 ? 0.0 : 1.1);
+        randCSP (m, 2 + rand () % 5, 4, 2 + rand () % 4);
+        size_t expected = bruteCount (m);
+
+        // and solve it with a random number of workers and propagation
+        worksteal<int, varorder_dom_t, valorder_minmutexes_t> search (m);
+        search.set_nbworkers (1 + rand () % 8);
+        search.set_propagation (propagation_t (rand () % 3));
+        ASSERT_EQ (search.solve () == status_t::SATISFIABLE, expected > 0);
+        ASSERT_EQ (search.get_nbsolutions (), expected ? 1 : 0);
+        if (expected) {
+            ASSERT_TRUE (isSolution (m, search.get_solution ()));
+        }
+        checkRestored (m);
+        ASSERT_EQ (search.count () == status_t::SATISFIABLE, expected > 0);
+        ASSERT_EQ (search.get_nbsolutions (), expected);
+        checkRestored (m);
+    }
+}
+
+// Checks that unsatisfiable tasks are proven so by several workers, which steal
+// tasks from each other
+// ----------------------------------------------------------------------------
+TEST_F (WorkstealFixture, PigeonsWorksteal) {
+
+    for (auto h = 2 ; h <= 7 ; h++) {
+        manager<int> m;
+        pigeons (m, h+1, h);
+        worksteal<int> search (m);
+        search.set_nbworkers (4);
+        search.set_propagation (propagation_t::FORWARD_CHECKING);
+        ASSERT_EQ (search.count (), status_t::UNSATISFIABLE);
+        ASSERT_EQ (search.get_nbsolutions (), 0);
+        ASSERT_GT (search.get_nbnodes (), 0);
+        checkRestored (m);
+    }
+
+    // while with a tiny time limit, the search is interrupted
+    manager<int> m;
+    pigeons (m, 12, 11);
+    worksteal<int> search (m);
+    search.set_nbworkers (2);
+    search.set_time_limit (0.0);
+    ASSERT_EQ (search.count (), status_t::TIME_LIMIT);
+    checkRestored (m);
+}
+
+// Checks that exceptions raised by any worker are rethrown once all of them
+// have been stopped
+// ----------------------------------------------------------------------------
+TEST_F (WorkstealFixture, ExceptionWorksteal) {
+
+    for (auto nbworkers = 1 ; nbworkers <= 4 ; nbworkers++) {
+        manager<int> m;
+        pigeons (m, 13, 12);
+        worksteal<int, varorder_throw_t> search (m);
+        search.set_nbworkers (nbworkers);
+        ASSERT_THROW (search.count (), runtime_error);
+        checkRestored (m);
+    }
+}
+
+// Checks that very deep branches are released without exhausting the stack of
+// the workers
+// ----------------------------------------------------------------------------
+TEST_F (WorkstealFixture, DeepWorksteal) {
+
+    // create a task with many variables with only one value, so that its
+    // only solution is found at the end of a branch as deep as the number of
+    // variables
+    manager<int> m;
+    vector<value_t<int>> domain {value_t<int>{0}};
+    for (auto i = 0 ; i < 200000 ; i++) {
+        variable_t variable {"X" + to_string (i)};
+        m.add_variable (variable, domain);
+    }
+    worksteal<int> search (m);
+    search.set_nbworkers (2);
+    ASSERT_EQ (search.count (), status_t::SATISFIABLE);
+    ASSERT_EQ (search.get_nbsolutions (), 1);
+    checkRestored (m);
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
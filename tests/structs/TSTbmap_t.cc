@@ -10,6 +10,8 @@
 // Description
 // Unit tests of CSPMUX bitmaps
 
+#include<algorithm>
+
 #include "../TSThelpers.h"
 #include "../fixtures/TSTbmapfixture.h"
 
@@ -47,7 +49,7 @@ TEST_F (BitmapFixture, ExactSize) {
     }
 }
 
-// Verifies that bitmaps are created with the requested length when it is
+// Verifies that bitmaps are created with the requested length when it is not
 // divisible by 8
 // ----------------------------------------------------------------------------
 TEST_F (BitmapFixture, InexactSize) {
@@ -65,8 +67,9 @@ TEST_F (BitmapFixture, InexactSize) {
         // create a bitmap with the specified size
         bmap_t bmap (bsize);
 
-        // and now verify that it takes one additional byte
-        ASSERT_EQ (8*(bsize/8 + 1), bmap.size ());
+        // and now verify that it has precisely the number of bits requested,
+        // even if the last word is not full
+        ASSERT_EQ (bsize, bmap.size ());
     }
 }
 
@@ -149,6 +152,172 @@ TEST_F (BitmapFixture, PartialBitmap) {
         }
     }
 }
+// Check that bitmaps can be initialized with all bits set
+// ----------------------------------------------------------------------------
+TEST_F (BitmapFixture, InitializedBitmap) {
+
+    for (auto i = 0 ; i < NB_TESTS/1000 ; i++ ) {
+
+        // randomly generate the size of the bitmap and create it with all bits
+        // set
+        size_t bsize = rand () % MAX_LENGTH/1000;
+        bmap_t bmap(bsize, true);
+
+        // check all positions are set and that no other bit is accounted
+        for (auto j = 0 ; j < bmap.size (); j++) {
+            ASSERT_TRUE (bmap[j]);
+        }
+        ASSERT_EQ (bmap.count (), bsize);
+    }
+}
+
+// Check that the number of bits set is correctly computed
+// ----------------------------------------------------------------------------
+TEST_F (BitmapFixture, CountBitmap) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++ ) {
+
+        // randomly generate a bitmap and set a random selection of bits
+        size_t bsize = 1 + rand () % MAX_LENGTH/1000000;
+        bmap_t bmap(bsize);
+        auto setbits = randSetInt (bsize/10, bsize);
+        for (auto it : setbits) {
+            bmap.set (it, true);
+        }
+
+        // and verify the count is correct
+        ASSERT_EQ (bmap.count (), setbits.size ());
+        ASSERT_EQ (bmap.any (), !setbits.empty ());
+        ASSERT_EQ (bmap.none (), setbits.empty ());
+    }
+}
+
+// Check that iterating over bits with find_first/find_next returns precisely
+// the bits set in increasing order
+// ----------------------------------------------------------------------------
+TEST_F (BitmapFixture, FindBitmap) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++ ) {
+
+        // randomly generate a bitmap and set a random selection of bits
+        size_t bsize = 1 + rand () % MAX_LENGTH/1000000;
+        bmap_t bmap(bsize);
+        auto setbits = randSetInt (bsize/10, bsize);
+        for (auto it : setbits) {
+            bmap.set (it, true);
+        }
+
+        // traverse all bits set and verify they are retrieved in the same
+        // order they are stored in the set
+        auto it = setbits.begin ();
+        for (auto j = bmap.find_first () ; j != bmap_t::npos ; j = bmap.find_next (j), ++it) {
+            ASSERT_NE (it, setbits.end ());
+            ASSERT_EQ (j, *it);
+        }
+        ASSERT_EQ (it, setbits.end ());
+    }
+}
+
+// Check that ranges of bits can be set and cleared
+// ----------------------------------------------------------------------------
+TEST_F (BitmapFixture, RangeBitmap) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++ ) {
+
+        // randomly generate a bitmap and a range within it
+        size_t bsize = 1 + rand () % MAX_LENGTH/1000000;
+        size_t first = rand () % bsize;
+        size_t last = first + rand () % (bsize - first);
+
+        // set all bits in the range and verify only those are set
+        bmap_t bmap(bsize);
+        bmap.set_range (first, last);
+        for (auto j = 0 ; j < bmap.size (); j++) {
+            ASSERT_EQ (bmap[j], j >= first && j <= last);
+        }
+        ASSERT_EQ (bmap.count (), 1 + last - first);
+
+        // likewise, clear the same range over a full bitmap
+        bmap_t full(bsize, true);
+        full.clear_range (first, last);
+        for (auto j = 0 ; j < full.size (); j++) {
+            ASSERT_EQ (full[j], j < first || j > last);
+        }
+        ASSERT_EQ (full.count (), bsize - (1 + last - first));
+    }
+}
+
+// Check that bitwise operations are computed correctly
+// ----------------------------------------------------------------------------
+TEST_F (BitmapFixture, BitwiseBitmap) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++ ) {
+
+        // randomly generate two bitmaps of the same size
+        size_t bsize = 1 + rand () % MAX_LENGTH/1000000;
+        bmap_t left(bsize), right(bsize);
+        for (auto it : randSetInt (bsize/2, bsize)) {
+            left.set (it, true);
+        }
+        for (auto it : randSetInt (bsize/2, bsize)) {
+            right.set (it, true);
+        }
+
+        // compute all bitwise operations
+        bmap_t band = left & right;
+        bmap_t bor = left | right;
+        bmap_t bxor = left ^ right;
+        bmap_t bandnot (left);
+        bandnot.andnot (right);
+
+        // and verify them bit by bit
+        for (auto j = 0 ; j < bsize; j++) {
+            ASSERT_EQ (band[j], left[j] && right[j]);
+            ASSERT_EQ (bor[j], left[j] || right[j]);
+            ASSERT_EQ (bxor[j], left[j] != right[j]);
+            ASSERT_EQ (bandnot[j], left[j] && !right[j]);
+        }
+
+        // finally, verify that operating bitmaps of different sizes raises an
+        // exception
+        bmap_t other (bsize+1);
+        ASSERT_THROW (left &= other, invalid_argument);
+    }
+}
+
+
+// Checks that bitmaps can be resized preserving their contents
+// ----------------------------------------------------------------------------
+TEST_F (BitmapFixture, ResizeBitmap) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++ ) {
+
+        // randomly generate a bitmap and set a random selection of bits
+        size_t bsize = 1 + rand () % MAX_LENGTH/1000000;
+        bmap_t bmap(bsize);
+        auto setbits = randSetInt (bsize/10, bsize);
+        for (auto it : setbits) {
+            bmap.set (it, true);
+        }
+
+        // grow the bitmap with bits randomly initialized and verify that both
+        // the previous and the new bits are correct
+        size_t nsize = bsize + rand () % 1000;
+        bool value = rand () % 2;
+        bmap.resize (nsize, value);
+        ASSERT_EQ (bmap.size (), nsize);
+        ASSERT_EQ (bmap.count (), setbits.size () + (value ? nsize - bsize : 0));
+        for (auto j = 0 ; j < bsize ; j++) {
+            ASSERT_EQ (bmap[j], setbits.find (j) != setbits.end ());
+        }
+
+        // and shrink it back to verify no bit survives beyond its length
+        bmap.resize (bsize/2);
+        ASSERT_EQ (bmap.size (), bsize/2);
+        ASSERT_EQ (bmap.count (), size_t (std::count_if (setbits.begin (), setbits.end (),
+                                                 [&] (int j) { return j < bsize/2; })));
+    }
+}
 
 // Local Variables:
 // mode:cpp
@@ -0,0 +1,101 @@
+// -*- coding: utf-8 -*-
+// TSTcosttable_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <sáb 28-08-2021 12:06:21.847120539 (1630145181)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests of CSPMUX tables of costs
+
+#include<map>
+#include<utility>
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../fixtures/TSTcosttablefixture.h"
+
+// Checks that empty tables of costs are correctly created and that wrong pairs
+// are rejected
+// ----------------------------------------------------------------------------
+TEST_F (CosttableFixture, EmptyCosttable) {
+
+    for (auto i = 0 ; i < NB_TESTS ; i++) {
+
+        // create an empty table with a random number of values
+        size_t length = 2 + rand () % NB_VALUES;
+        costtable_t table (length);
+        ASSERT_EQ (table.size (), length);
+        ASSERT_FALSE (table.frozen ());
+
+        // no pair has any cost, neither before nor after freezing it
+        size_t value1 = rand () % length, value2 = rand () % length;
+        ASSERT_EQ (table.get (value1, value2), 0);
+        ASSERT_TRUE (table[value1].empty ());
+        table.freeze ();
+        ASSERT_TRUE (table.frozen ());
+        ASSERT_EQ (table.get (value1, value2), 0);
+        ASSERT_TRUE (table[value1].empty ());
+        ASSERT_THROW (table.get (length, value2), std::out_of_range);
+    }
+
+    // pairs of the same value or out of bounds are rejected, and no costs
+    // can be added once frozen
+    costtable_t table (10);
+    ASSERT_THROW (table.add (3, 3, 1), std::invalid_argument);
+    ASSERT_THROW (table.add (3, 10, 1), std::invalid_argument);
+    table.freeze ();
+    ASSERT_THROW (table.add (3, 4, 1), std::runtime_error);
+}
+
+// Checks that costs of repeated pairs are added up and that rows are sorted
+// and compacted once frozen
+// ----------------------------------------------------------------------------
+TEST_F (CosttableFixture, RandomCosttable) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // add random costs to random pairs, possibly repeated, and record the
+        // overall cost of every pair
+        size_t length = 2 + rand () % NB_VALUES;
+        costtable_t table (length);
+        std::map<std::pair<size_t, size_t>, size_t> costs;
+        for (size_t j = 0 ; j < 2*length ; j++) {
+            auto values = randVectorInt (2, length, true);
+            size_t cost = 1 + rand () % 10;
+            table.add (values[0], values[1], cost);
+            costs[{values[0], values[1]}] += cost;
+            costs[{values[1], values[0]}] += cost;
+        }
+
+        // costs are correctly retrieved both before and after freezing
+        for (auto frozen : {false, true}) {
+            if (frozen) {
+                table.freeze ();
+            }
+            for (auto& cost : costs) {
+                ASSERT_EQ (table.get (cost.first.first, cost.first.second), cost.second);
+            }
+        }
+
+        // and every row is sorted with only one entry per pair
+        size_t nbentries = 0;
+        for (size_t j = 0 ; j < length ; j++) {
+            size_t previous = length;
+            for (auto& entry : table[j]) {
+                ASSERT_TRUE (previous == length || previous < entry._value);
+                ASSERT_EQ (costs[std::make_pair (j, size_t (entry._value))], entry._cost);
+                previous = entry._value;
+            }
+            nbentries += table[j].size ();
+        }
+        ASSERT_EQ (nbentries, costs.size ());
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
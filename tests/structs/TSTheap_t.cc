@@ -0,0 +1,99 @@
+// -*- coding: utf-8 -*-
+// TSTheap_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <jue 19-08-2021 10:42:51.118904772 (1629362571)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests for testing MUX indexed heaps
+
+#include<stdexcept>
+#include<string>
+#include<vector>
+
+#include "../TSThelpers.h"
+#include "../fixtures/TSTheapfixture.h"
+
+// Checks that empty heaps are correctly created
+// ----------------------------------------------------------------------------
+TEST_F (HeapFixture, EmptyHeap) {
+
+    for (auto i = 0 ; i < NB_TESTS ; i++) {
+
+        // create an empty heap with a random number of items
+        size_t n = 1 + rand () % NB_VALUES;
+        heap_t heap (n);
+        ASSERT_EQ (heap.size (), 0);
+        ASSERT_TRUE (heap.empty ());
+        ASSERT_EQ (heap.top (), std::string::npos);
+        for (size_t j = 0 ; j < n ; j++) {
+            ASSERT_FALSE (heap.contains (j));
+        }
+
+        // items out of range or not in the heap can not be removed, and items
+        // can not be inserted twice
+        ASSERT_THROW (heap.insert (n, 0.0), std::invalid_argument);
+        ASSERT_THROW (heap.erase (0), std::invalid_argument);
+        heap.insert (0, 0.0);
+        ASSERT_THROW (heap.insert (0, 1.0), std::invalid_argument);
+    }
+}
+
+// Checks that the top of the heap is always the item with the smallest key
+// after random insertions, deletions and updates
+// ----------------------------------------------------------------------------
+TEST_F (HeapFixture, RandomHeap) {
+
+    for (auto i = 0 ; i < NB_TESTS/10 ; i++) {
+
+        // create an empty heap and keep track of its contents separately
+        size_t n = 1 + rand () % NB_VALUES;
+        heap_t heap (n);
+        std::vector<bool> inserted (n, false);
+        std::vector<double> keys (n, 0.0);
+        size_t size = 0;
+
+        // perform random operations. Keys are taken from a small range so that
+        // ties are frequent
+        for (auto j = 0 ; j < 10*NB_VALUES ; j++) {
+            size_t item = rand () % n;
+            double key = rand () % 10;
+            if (rand () % 3 == 0) {
+                heap.update (item, key);
+                keys[item] = key;
+            } else if (inserted[item]) {
+                heap.erase (item);
+                inserted[item] = false;
+                size--;
+            } else {
+                heap.insert (item, key);
+                keys[item] = key;
+                inserted[item] = true;
+                size++;
+            }
+
+            // and verify the heap
+            ASSERT_EQ (heap.size (), size);
+            ASSERT_EQ (heap.top (), bruteTop (inserted, keys));
+            ASSERT_EQ (heap.contains (item), inserted[item]);
+            ASSERT_EQ (heap.get_key (item), keys[item]);
+        }
+
+        // finally, all items are extracted in increasing order of their keys
+        double prev = -1.0;
+        while (!heap.empty ()) {
+            size_t item = heap.top ();
+            ASSERT_GE (heap.get_key (item), prev);
+            prev = heap.get_key (item);
+            heap.erase (item);
+        }
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -65,10 +65,6 @@ TEST_F (MultibitmapFixture, MultibitmapsNonEmptyBitmaps) {
 
         // and now check that each entry consists of bitmaps with the specified
         // length
-
-        // bitmaps have always a size which is divisible by 8, so compute in
-        // advance the expected size of this bitmap
-        bsize = 8*((bsize/8) + int(bsize%8!=0));
         for (auto j = 0 ; j < mbsize ; j++ ) {
             ASSERT_EQ (multibmap[j].size (), bsize);
         }
@@ -133,6 +129,130 @@ TEST_F (MultibitmapFixture, MultibitmapsWriteRead) {
     }
 }
 
+// Checks that all rows are stored in a single buffer aligned to a cache line
+// ----------------------------------------------------------------------------
+TEST_F (MultibitmapFixture, MultibitmapsContiguous) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a multibitmap with at least one row
+        size_t mbsize = 1 + random () % MAX_LENGTH/1000000;
+        size_t bsize = random () % MAX_LENGTH/1000000;
+        multibmap_t multibmap (mbsize, bsize);
+
+        // the first row is aligned to a cache line, and all rows are separated
+        // by the same stride which suffices to store all bits
+        ASSERT_EQ (reinterpret_cast<uintptr_t> (multibmap[0].data ()) % 64, 0);
+        ASSERT_GE (64*multibmap.stride (), bsize);
+        for (auto j = 1 ; j < mbsize ; j++ ) {
+            ASSERT_EQ (multibmap[j].data (), multibmap[j-1].data () + multibmap.stride ());
+        }
+
+        // rows spanning at least one cache line start all at the beginning of
+        // a cache line
+        if (multibmap.stride () >= 8) {
+            ASSERT_EQ (multibmap.stride () % 8, 0);
+        }
+    }
+}
+
+// Checks that multibitmaps can be initialized with all bits set
+// ----------------------------------------------------------------------------
+TEST_F (MultibitmapFixture, MultibitmapsFullBitmaps) {
+
+    for (auto i = 0 ; i < NB_TESTS/1000 ; i++) {
+
+        // create a multibitmap with all bits set
+        size_t mbsize = random () % MAX_LENGTH/1000000;
+        size_t bsize = random () % MAX_LENGTH/1000000;
+        multibmap_t multibmap (mbsize, bsize, true);
+
+        // and verify that all rows have precisely bsize bits set
+        for (auto j = 0 ; j < mbsize ; j++ ) {
+            ASSERT_EQ (multibmap[j].count (), bsize);
+        }
+    }
+}
+
+// Checks that whole-row operations are correctly computed
+// ----------------------------------------------------------------------------
+TEST_F (MultibitmapFixture, MultibitmapsRowOperations) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a multibitmap with four rows which are all randomly
+        // initialized with the same contents
+        size_t bsize = 1 + random () % MAX_LENGTH/1000000;
+        multibmap_t multibmap (4, bsize);
+        for (auto loc : randSetInt (bsize/2, bsize)) {
+            for (auto j = 0 ; j < 4 ; j++) {
+                multibmap.set (j, loc, true);
+            }
+        }
+
+        // keep a copy of the original row as a bitmap
+        bmap_t left (bsize);
+        for (auto j = 0 ; j < bsize ; j++) {
+            left.set (j, multibmap[0][j]);
+        }
+
+        // and randomly generate another bitmap
+        bmap_t right (bsize);
+        for (auto loc : randSetInt (bsize/2, bsize)) {
+            right.set (loc, true);
+        }
+
+        // apply a different operation to each row and verify the results
+        multibmap.and_row (0, right);
+        multibmap.or_row (1, right);
+        multibmap.xor_row (2, right);
+        multibmap.andnot_row (3, right);
+        for (auto j = 0 ; j < bsize ; j++) {
+            ASSERT_EQ (multibmap[0][j], left[j] && right[j]);
+            ASSERT_EQ (multibmap[1][j], left[j] || right[j]);
+            ASSERT_EQ (multibmap[2][j], left[j] != right[j]);
+            ASSERT_EQ (multibmap[3][j], left[j] && !right[j]);
+        }
+
+        // rows can be also used as operands
+        ASSERT_EQ (multibmap[0].intersects (multibmap[3]), false);
+        ASSERT_EQ (multibmap[0].count () + multibmap[3].count (), left.count ());
+
+        // finally, verify that operating rows of different sizes raises an
+        // exception
+        bmap_t other (bsize+1);
+        ASSERT_THROW (multibmap.and_row (0, other), invalid_argument);
+    }
+}
+
+// Checks that copies of multibitmaps are independent
+// ----------------------------------------------------------------------------
+TEST_F (MultibitmapFixture, MultibitmapsCopy) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a multibitmap with some random bits set
+        size_t mbsize = 1 + random () % MAX_LENGTH/10000000;
+        size_t bsize = 1 + random () % MAX_LENGTH/10000000;
+        multibmap_t multibmap (mbsize, bsize);
+        for (auto loc : randSetInt (mbsize*bsize/10, mbsize*bsize)) {
+            multibmap.set (loc/bsize, loc%bsize, true);
+        }
+
+        // copy it and modify the original one
+        multibmap_t copy (multibmap);
+        multibmap.fill_row (0, true);
+
+        // verify the copy was not modified
+        for (auto j = 1 ; j < mbsize ; j++ ) {
+            for (auto k = 0 ; k < bsize ; k++) {
+                ASSERT_EQ (copy[j][k], multibmap[j][k]);
+            }
+        }
+        ASSERT_EQ (multibmap[0].count (), bsize);
+    }
+}
+
 
 // Local Variables:
 // mode:cpp
@@ -84,6 +84,95 @@ TEST_F (MultivectorFixture, MultivectorWriteRead) {
         }
     }
 }
+// Checks that frozen multivectors keep the same contents sorted and without
+// duplicates in contiguous memory
+// ----------------------------------------------------------------------------
+TEST_F (MultivectorFixture, MultivectorFreeze) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a multivector with a random length
+        size_t mvsize = 1 + random () % MAX_LENGTH/10000000;
+        multivector_t multivector (mvsize);
+
+        // randomly write locations in the multivector, some of them more than
+        // once
+        auto locs = randVectorInt (mvsize*mvsize/5, mvsize*mvsize);
+        for (auto loc : locs) {
+            multivector.set (loc/mvsize, loc%mvsize);
+        }
+        ASSERT_FALSE (multivector.frozen ());
+
+        // and now freeze it
+        multivector.freeze ();
+        ASSERT_TRUE (multivector.frozen ());
+        ASSERT_EQ (multivector.size (), mvsize);
+
+        // verify every entry is strictly increasing and that it contains
+        // precisely the locations written
+        std::set<int> expected (locs.begin (), locs.end ());
+        size_t total = 0;
+        for (auto j = 0 ; j < mvsize ; j++) {
+            auto row = multivector[j];
+            for (auto k = 1 ; k < row.size () ; k++) {
+                ASSERT_LT (row[k-1], row[k]);
+            }
+            for (auto value : row) {
+                ASSERT_NE (expected.find (j*mvsize + value), expected.end ());
+            }
+            total += row.size ();
+
+            // rows are consecutive in memory
+            if (j > 0) {
+                ASSERT_EQ (multivector[j-1].end (), row.begin ());
+            }
+        }
+        ASSERT_EQ (total, expected.size ());
+
+        // all locations are found in the frozen multivector
+        for (auto loc : expected) {
+            ASSERT_TRUE (multivector.find (loc/mvsize, loc%mvsize));
+        }
+
+        // and it can not be modified anymore
+        ASSERT_THROW (multivector.set (0, 0), std::runtime_error);
+    }
+}
+
+
+// Checks that vectors with reserved room are not reallocated when filled
+// ----------------------------------------------------------------------------
+TEST_F (MultivectorFixture, MultivectorReserve) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // create a multivector with a random length and reserve room for a
+        // random number of values in every vector
+        size_t mvsize = 1 + random () % 100;
+        multivector_t multivector (mvsize);
+        std::vector<size_t> room;
+        for (size_t j = 0 ; j < mvsize ; j++) {
+            room.push_back (1 + random () % 100);
+            multivector.reserve (j, room[j]);
+        }
+
+        // fill every vector with as many values as reserved, and check its
+        // memory never moves
+        for (size_t j = 0 ; j < mvsize ; j++) {
+            multivector.set (j, random () % mvsize);
+            const uint32_t* data = multivector[j].begin ();
+            for (size_t k = 1 ; k < room[j] ; k++) {
+                multivector.set (j, random () % mvsize);
+                ASSERT_EQ (multivector[j].begin (), data);
+            }
+            ASSERT_EQ (multivector[j].size (), room[j]);
+        }
+
+        // once frozen, no room can be reserved
+        multivector.freeze ();
+        ASSERT_THROW (multivector.reserve (0, 1), std::runtime_error);
+    }
+}
 
 // Local Variables:
 // mode:cpp
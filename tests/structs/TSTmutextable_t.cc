@@ -0,0 +1,324 @@
+// -*- coding: utf-8 -*-
+// TSTmutextable_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <lun 16-08-2021 10:14:03.904311776 (1629101643)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests of CSPMUX tables of mutexes
+
+#include<set>
+#include<vector>
+
+#include "../TSTdefs.h"
+#include "../TSThelpers.h"
+#include "../fixtures/TSTmutextablefixture.h"
+
+// create a table of variables with the given number of variables, each one
+// with a random number of values in the range [1, NB_VALUES]
+vartable_t randVartable (const size_t nbvars) {
+
+    vartable_t vartable;
+    size_t first = 0;
+    for (size_t i = 0 ; i < nbvars ; i++) {
+        variable_t variable (to_string (i));
+        size_t last = first + rand () % NB_VALUES;
+        vartable.insert (variable, first, last);
+        first = last + 1;
+    }
+    return vartable;
+}
+
+// create a bit matrix with random mutexes between the values of var1 and var2
+// aligned as required by tables of mutexes, and record them in the given set
+multibmap_t randMutexes (const vartable_t& vartable,
+                         const size_t var1, const size_t var2,
+                         std::set<std::pair<size_t, size_t>>& mutexes) {
+
+    size_t first1 = vartable.get_first (var1), first2 = vartable.get_first (var2);
+    size_t n1 = 1 + vartable.get_last (var1) - first1;
+    size_t n2 = 1 + vartable.get_last (var2) - first2;
+    multibmap_t matrix (n1, first2%64 + n2);
+    for (size_t i = 0 ; i < n1 ; i++) {
+        for (size_t j = 0 ; j < n2 ; j++) {
+            if (rand () % 3 == 0) {
+                matrix.set (i, first2%64 + j, true);
+                mutexes.insert ({first1 + i, first2 + j});
+                mutexes.insert ({first2 + j, first1 + i});
+            }
+        }
+    }
+    return matrix;
+}
+
+// Checks that both representations of mutexes store precisely the same
+// information
+// ----------------------------------------------------------------------------
+TEST_F (MutextableFixture, DenseSparseMutextable) {
+
+    for (auto i = 0 ; i < NB_TESTS/1000 ; i++) {
+
+        // create a table of variables and two tables of mutexes
+        vartable_t vartable = randVartable (2 + rand () % 10);
+        mutextable_t sparse (vartable), dense (vartable);
+        ASSERT_EQ (sparse.size (), 1 + vartable.get_last (vartable.size ()-1));
+
+        // add random mutexes between random pairs of variables, both as
+        // sparse and dense blocks
+        std::set<std::pair<size_t, size_t>> mutexes;
+        for (auto j = 0 ; j < 5 ; j++) {
+            auto vars = randVectorInt (2, vartable.size (), true);
+            multibmap_t matrix = randMutexes (vartable, vars[0], vars[1], mutexes);
+            sparse.add (vars[0], vars[1], matrix, false);
+            dense.add (vars[0], vars[1], matrix, true);
+            ASSERT_FALSE (sparse.dense (vars[0], vars[1]));
+            ASSERT_TRUE (dense.dense (vars[1], vars[0]));
+        }
+        ASSERT_EQ (sparse.nbblocks (), dense.nbblocks ());
+
+        // verify both tables before and after freezing them
+        for (auto k = 0 ; k < 2 ; k++) {
+            for (size_t idx1 = 0 ; idx1 < sparse.size () ; idx1++) {
+
+                // count the number of mutexes of this value
+                size_t nbmutexes = 0;
+                for (size_t idx2 = 0 ; idx2 < sparse.size () ; idx2++) {
+                    bool mutex = mutexes.find ({idx1, idx2}) != mutexes.end ();
+                    ASSERT_EQ (sparse.find (idx1, idx2), mutex);
+                    ASSERT_EQ (dense.find (idx1, idx2), mutex);
+                    nbmutexes += mutex;
+                }
+                ASSERT_EQ (dense.degree (idx1), nbmutexes);
+
+                // adjacency lists might contain duplicates until they are
+                // frozen
+                if (sparse.frozen ()) {
+                    ASSERT_EQ (sparse.degree (idx1), nbmutexes);
+                }
+
+                // and check that all of them are traversed in both tables
+                std::set<size_t> sparseset, denseset;
+                sparse.for_each (idx1, [&] (size_t idx2) { sparseset.insert (idx2); });
+                dense.for_each (idx1, [&] (size_t idx2) { denseset.insert (idx2); });
+                ASSERT_EQ (sparseset, denseset);
+                ASSERT_EQ (denseset.size (), nbmutexes);
+            }
+            sparse.freeze ();
+            dense.freeze ();
+            ASSERT_TRUE (sparse.frozen () && dense.frozen ());
+        }
+
+        // once frozen, no more mutexes can be added
+        auto vars = randVectorInt (2, vartable.size (), true);
+        ASSERT_THROW (dense.add (vars[0], vars[1],
+                                 randMutexes (vartable, vars[0], vars[1], mutexes),
+                                 true), runtime_error);
+    }
+}
+
+// Checks that the mutexes of a value can be traversed restricted to the values
+// set in a bitmap
+// ----------------------------------------------------------------------------
+TEST_F (MutextableFixture, LiveMutextable) {
+
+    for (auto i = 0 ; i < NB_TESTS/1000 ; i++) {
+
+        // create a table of variables and a table of mutexes where blocks are
+        // randomly created either as sparse or dense
+        vartable_t vartable = randVartable (2 + rand () % 10);
+        mutextable_t mutextable (vartable);
+        std::set<std::pair<size_t, size_t>> mutexes;
+        for (auto j = 0 ; j < 5 ; j++) {
+            auto vars = randVectorInt (2, vartable.size (), true);
+            mutextable.add (vars[0], vars[1],
+                            randMutexes (vartable, vars[0], vars[1], mutexes),
+                            rand () % 2);
+        }
+        mutextable.freeze ();
+
+        // create a random bitmap of live values
+        bmap_t live (mutextable.size ());
+        for (size_t j = 0 ; j < live.size () ; j++) {
+            live.set (j, rand () % 2);
+        }
+
+        // and verify that only live mutexes are traversed
+        for (size_t idx1 = 0 ; idx1 < mutextable.size () ; idx1++) {
+            std::set<size_t> expected, traversed;
+            mutextable.for_each (idx1, [&] (size_t idx2) {
+                if (live[idx2]) {
+                    expected.insert (idx2);
+                }
+            });
+            mutextable.for_each (idx1, live, [&] (size_t idx2) {
+                traversed.insert (idx2);
+            });
+            ASSERT_EQ (expected, traversed);
+        }
+    }
+}
+
+// Checks that mutexes added over the same pair of variables are merged into the
+// same block, regardless of the ordering of the variables
+// ----------------------------------------------------------------------------
+TEST_F (MutextableFixture, MergeMutextable) {
+
+    for (auto i = 0 ; i < NB_TESTS/1000 ; i++) {
+
+        // create a table of variables and a table of mutexes
+        vartable_t vartable = randVartable (2 + rand () % 10);
+        mutextable_t mutextable (vartable);
+
+        // add mutexes over the same pair of variables in both orderings and
+        // requesting different representations
+        auto vars = randVectorInt (2, vartable.size (), true);
+        bool dense = rand () % 2;
+        std::set<std::pair<size_t, size_t>> mutexes;
+        mutextable.add (vars[0], vars[1],
+                        randMutexes (vartable, vars[0], vars[1], mutexes), dense);
+        mutextable.add (vars[1], vars[0],
+                        randMutexes (vartable, vars[1], vars[0], mutexes), !dense);
+
+        // only one block should exist with the representation of the first
+        // one
+        ASSERT_EQ (mutextable.nbblocks (), 1);
+        ASSERT_EQ (mutextable.dense (vars[0], vars[1]), dense);
+
+        // and it contains all mutexes
+        mutextable.freeze ();
+        for (size_t idx1 = 0 ; idx1 < mutextable.size () ; idx1++) {
+            size_t nbmutexes = 0;
+            for (size_t idx2 = 0 ; idx2 < mutextable.size () ; idx2++) {
+                bool mutex = mutexes.find ({idx1, idx2}) != mutexes.end ();
+                ASSERT_EQ (mutextable.find (idx1, idx2), mutex);
+                nbmutexes += mutex;
+            }
+            ASSERT_EQ (mutextable.degree (idx1), nbmutexes);
+        }
+    }
+}
+
+// Checks that supports are correctly found in both representations
+// ----------------------------------------------------------------------------
+TEST_F (MutextableFixture, FindSupportMutextable) {
+
+    for (auto i = 0 ; i < NB_TESTS/1000 ; i++) {
+
+        // create a table of variables and a table of mutexes where blocks are
+        // randomly created either as sparse or dense
+        vartable_t vartable = randVartable (2 + rand () % 10);
+        mutextable_t mutextable (vartable);
+        std::set<std::pair<size_t, size_t>> mutexes;
+        for (auto j = 0 ; j < 5 ; j++) {
+            auto vars = randVectorInt (2, vartable.size (), true);
+            mutextable.add (vars[0], vars[1],
+                            randMutexes (vartable, vars[0], vars[1], mutexes),
+                            rand () % 2);
+        }
+
+        // create a random bitmap of live values
+        bmap_t live (mutextable.size ());
+        for (size_t j = 0 ; j < live.size () ; j++) {
+            live.set (j, rand () % 4);
+        }
+
+        // and verify the supports of all values in all their blocks, both
+        // before and after freezing the table
+        for (auto k = 0 ; k < 2 ; k++) {
+            for (size_t idx1 = 0 ; idx1 < mutextable.size () ; idx1++) {
+                size_t var = mutextable.get_var (idx1);
+                for (auto b : mutextable.get_blocks (var)) {
+                    ASSERT_TRUE (mutextable.get_var1 (b) == var || mutextable.get_var2 (b) == var);
+                    size_t other = (mutextable.get_var1 (b) == var) ?
+                        mutextable.get_var2 (b) : mutextable.get_var1 (b);
+
+                    // the support is the first live value of the other
+                    // variable which is not mutex
+                    size_t expected = string::npos;
+                    for (auto idx2 = vartable.get_first (other) ; idx2 <= vartable.get_last (other) ; idx2++) {
+                        if (live[idx2] && mutexes.find ({idx1, idx2}) == mutexes.end ()) {
+                            expected = idx2;
+                            break;
+                        }
+                    }
+                    ASSERT_EQ (mutextable.find_support (idx1, b, live), expected);
+
+                    // once frozen, supports are computed with the bitmaps of
+                    // compatible values because all domains are small
+                    ASSERT_EQ (mutextable.compat (b), mutextable.frozen ());
+                }
+            }
+            mutextable.freeze ();
+        }
+    }
+}
+
+// Checks that supports in sparse blocks defined over small domains are found
+// with their bitmaps of compatible values once the table is frozen
+// ----------------------------------------------------------------------------
+TEST_F (MutextableFixture, SparseCompatMutextable) {
+
+    for (auto i = 0 ; i < NB_TESTS/1000 ; i++) {
+
+        // create a table of variables and a table of mutexes where all blocks
+        // are sparse
+        vartable_t vartable = randVartable (2 + rand () % 10);
+        mutextable_t mutextable (vartable);
+        std::set<std::pair<size_t, size_t>> mutexes;
+        for (auto j = 0 ; j < 5 ; j++) {
+            auto vars = randVectorInt (2, vartable.size (), true);
+            mutextable.add (vars[0], vars[1],
+                            randMutexes (vartable, vars[0], vars[1], mutexes),
+                            false);
+        }
+        mutextable.freeze ();
+
+        // create a random bitmap of live values
+        bmap_t live (mutextable.size ());
+        for (size_t j = 0 ; j < live.size () ; j++) {
+            live.set (j, rand () % 4);
+        }
+
+        // and verify the bitmaps of compatible values and the supports of all
+        // values in all their blocks
+        for (size_t idx1 = 0 ; idx1 < mutextable.size () ; idx1++) {
+            size_t var = mutextable.get_var (idx1);
+            for (auto b : mutextable.get_blocks (var)) {
+                ASSERT_FALSE (mutextable.dense (mutextable.get_var1 (b), mutextable.get_var2 (b)));
+                ASSERT_TRUE (mutextable.compat (b));
+                size_t other = (mutextable.get_var1 (b) == var) ?
+                    mutextable.get_var2 (b) : mutextable.get_var1 (b);
+                size_t base = 64*(vartable.get_first (other)/64);
+
+                // the bitmap of compatible values has precisely those values
+                // of the other variable which are not mutex
+                brow_t compat = mutextable.get_compat (idx1, b);
+                for (size_t j = 0 ; j < compat.size () ; j++) {
+                    bool expected = base + j >= vartable.get_first (other) &&
+                        base + j <= vartable.get_last (other) &&
+                        mutexes.find ({idx1, base + j}) == mutexes.end ();
+                    ASSERT_EQ (compat[j], expected);
+                }
+
+                // and the support is the first value set both in the bitmap
+                // of compatible values and the live values
+                size_t expected = string::npos;
+                for (size_t j = 0 ; j < compat.size () ; j++) {
+                    if (compat[j] && live[base + j]) {
+                        expected = base + j;
+                        break;
+                    }
+                }
+                ASSERT_EQ (mutextable.find_support (idx1, b, live), expected);
+            }
+        }
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End:
@@ -0,0 +1,133 @@
+// -*- coding: utf-8 -*-
+// TSTwsdeque_t.cc
+// -----------------------------------------------------------------------------
+//
+// Started on <mar 24-08-2021 12:21:09.305718842 (1629800469)>
+// Carlos Linares López <carlos.linares@uc3m.es>
+//
+
+//
+// Description
+// Unit tests for testing MUX work-stealing deques
+
+#include<atomic>
+#include<thread>
+#include<vector>
+
+#include "../TSThelpers.h"
+#include "../fixtures/TSTwsdequefixture.h"
+
+// Checks that empty deques are correctly created
+// ----------------------------------------------------------------------------
+TEST_F (WSDequeFixture, EmptyWSDeque) {
+
+    for (auto i = 0 ; i < NB_TESTS ; i++) {
+
+        // create an empty deque with a random capacity, which is rounded up
+        // to a power of two
+        size_t capacity = 1 + rand () % NB_VALUES;
+        wsdeque_t<size_t> deque (capacity);
+        ASSERT_EQ (deque.size (), 0);
+        ASSERT_TRUE (deque.empty ());
+        ASSERT_GE (deque.capacity (), capacity);
+        ASSERT_EQ (deque.capacity () & (deque.capacity () - 1), 0);
+
+        // no items can be taken or stolen
+        size_t item;
+        ASSERT_FALSE (deque.take (item));
+        ASSERT_FALSE (deque.steal (item));
+    }
+}
+
+// Checks that the owner takes items in LIFO order and thieves steal them in
+// FIFO order, growing the deque as needed
+// ----------------------------------------------------------------------------
+TEST_F (WSDequeFixture, OrderWSDeque) {
+
+    for (auto i = 0 ; i < NB_TESTS ; i++) {
+
+        // push a random number of items in a small deque so that it grows
+        size_t n = 1 + rand () % NB_VALUES;
+        wsdeque_t<size_t> deque (1);
+        for (size_t j = 0 ; j < n ; j++) {
+            deque.push (j);
+        }
+        ASSERT_EQ (deque.size (), n);
+        ASSERT_GE (deque.capacity (), n);
+
+        // steal a random number of them from the top and take the rest from
+        // the bottom
+        size_t nbsteals = rand () % (1 + n);
+        size_t item;
+        for (size_t j = 0 ; j < nbsteals ; j++) {
+            ASSERT_TRUE (deque.steal (item));
+            ASSERT_EQ (item, j);
+        }
+        for (size_t j = n ; j > nbsteals ; j--) {
+            ASSERT_TRUE (deque.take (item));
+            ASSERT_EQ (item, j - 1);
+        }
+        ASSERT_TRUE (deque.empty ());
+        ASSERT_FALSE (deque.take (item));
+        ASSERT_FALSE (deque.steal (item));
+    }
+}
+
+// Checks that every item is retrieved exactly once when the owner pushes and
+// takes items while other threads steal them concurrently
+// ----------------------------------------------------------------------------
+TEST_F (WSDequeFixture, ConcurrentWSDeque) {
+
+    for (auto i = 0 ; i < NB_TESTS/100 ; i++) {
+
+        // the owner pushes a number of items and takes one every now and then,
+        // while a random number of thieves steal them until all have been
+        // retrieved
+        size_t n = 1000 + rand () % (100*NB_VALUES);
+        size_t nbthieves = 1 + rand () % 4;
+        wsdeque_t<size_t> deque (2);
+        std::vector<std::atomic<size_t>> seen (n);
+        for (auto& s : seen) {
+            s.store (0);
+        }
+        std::atomic<size_t> retrieved {0};
+        std::vector<std::thread> thieves;
+        for (size_t t = 0 ; t < nbthieves ; t++) {
+            thieves.emplace_back ([&] {
+                size_t item;
+                while (retrieved.load () < n) {
+                    if (deque.steal (item)) {
+                        seen[item]++;
+                        retrieved++;
+                    }
+                }
+            });
+        }
+        size_t item;
+        for (size_t j = 0 ; j < n ; j++) {
+            deque.push (j);
+            if (!(j % 3) && deque.take (item)) {
+                seen[item]++;
+                retrieved++;
+            }
+        }
+        while (deque.take (item)) {
+            seen[item]++;
+            retrieved++;
+        }
+        for (auto& thief : thieves) {
+            thief.join ();
+        }
+
+        // all items have been retrieved exactly once
+        ASSERT_EQ (retrieved.load (), n);
+        for (size_t j = 0 ; j < n ; j++) {
+            ASSERT_EQ (seen[j].load (), 1);
+        }
+    }
+}
+
+// Local Variables:
+// mode:cpp
+// fill-column:80
+// End: